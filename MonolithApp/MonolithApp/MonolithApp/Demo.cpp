@@ -144,6 +144,10 @@ void Demo::IdleHandler()
 {
     if (tracking)
     {
+        // Sleep until the tracker sends new data instead of spinning, the timeout
+        // keeps the window responsive if the tracker stops sending
+        monolith->WaitForNextFrame(50);
+
         // Grab information from the wand, such as its position, direction,
         // button information, and joystick information
         double speed = 0.1;
@@ -42,7 +42,7 @@ namespace MTF
         ///  @param nearPlane              Double value for the near plane distance.  Must be a positive value.
         ///  @param farPlane               Double value for the far plane distance.  Must be greater than the near plane
         ///
-        Camera(Display *display, double nearPlane, double farPlane);
+        Camera(Display *display, Real nearPlane, Real farPlane);
 
         ///
         ///  \brief Camera Constructor
@@ -57,7 +57,7 @@ namespace MTF
         ///  @param yaw                     Double value that contains the amount of rotation around the Y-axis.  Value is expected in degrees.
         ///  @param pitch                   Double value that contains the amount of rotation around the X-axis.  Value is expected in degrees.
         ///
-        Camera(Display *display, double nearPlane, double farPlane, Vector3 cameraPosition, double yaw, double pitch);
+        Camera(Display *display, Real nearPlane, Real farPlane, Vector3 cameraPosition, Real yaw, Real pitch);
 
         ///
         ///  \brief Camera Destructor
@@ -137,14 +137,14 @@ namespace MTF
         ///
         ///  @param pitch                   Expected value is the degrees of rotation (clockwise) around the +x axis
         ///
-        void SetPitch(double pitch);
+        void SetPitch(Real pitch);
 
         ///
         ///  \brief Sets the yaw for the camera.
         ///
         ///  @param yaw                     Expected value is the degrees of rotation (counter-clockwise) around the +y axis
         ///
-        void SetYaw(double yaw);
+        void SetYaw(Real yaw);
 
         ///
         ///  \brief Sets the position of the camera
@@ -160,7 +160,7 @@ namespace MTF
         ///
         ///  @param pitch                   Expected value is the degrees of rotation (clockwise) around the +x axis
         ///
-        void AdjustPitch(double pitch);
+        void AdjustPitch(Real pitch);
 
         ///
         ///  \brief Sets the yaw for the camera.
@@ -169,7 +169,7 @@ namespace MTF
         ///
         ///  @param yaw                     Expected value is the degrees of rotation (counter-clockwise) around the +y axis
         ///
-        void AdjustYaw(double yaw);
+        void AdjustYaw(Real yaw);
 
         /// 
         ///  \brief Moves the position of the camera forward.
@@ -178,7 +178,7 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera forward.
         ///
-        void MoveForward(double amount);
+        void MoveForward(Real amount);
 
         /// 
         ///  \brief Moves the position of the camera forward.
@@ -187,7 +187,7 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera forward.
         ///
-        void MoveBackward(double amount);
+        void MoveBackward(Real amount);
 
         /// 
         ///  \brief Moves the position of the camera to the right.
@@ -196,7 +196,7 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera to the right.
         ///
-        void MoveRight(double amount);
+        void MoveRight(Real amount);
 
         /// 
         ///  \brief Moves the position of the camera to the left.
@@ -205,7 +205,7 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera to the left.
         ///
-        void MoveLeft(double amount);
+        void MoveLeft(Real amount);
 
         /// 
         ///  \brief Moves the position of the camera up.
@@ -214,7 +214,7 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera up.
         ///
-        void MoveUp(double amount);
+        void MoveUp(Real amount);
 
         /// 
         ///  \brief Moves the position of the camera down.
@@ -223,21 +223,21 @@ namespace MTF
         ///
         ///  @param amount                  Number of units to move the camera down.
         ///
-        void MoveDown(double amount);
+        void MoveDown(Real amount);
 
         /// 
         ///  \brief Returns the camera's current pitch.
         ///
         ///  @return                        The current pitch for the camera in degrees
         ///
-        double GetPitch();
+        Real GetPitch();
 
         /// 
         ///  \brief Returns the camera's current yaw.
         ///
         ///  @return                        The current yaw for the camera in degrees
         ///
-        double GetYaw();
+        Real GetYaw();
 
         /// 
         ///  \brief Returns the camera's current position.
@@ -293,16 +293,16 @@ namespace MTF
         Vector3 _cameraUpVector;
         Vector3 _cameraRightVector;
 
-        double _yaw;
-        double _pitch;
+        Real _yaw;
+        Real _pitch;
 
-        double _nearPlane;
-        double _farPlane;
+        Real _nearPlane;
+        Real _farPlane;
 
-        double _left;
-        double _right;
-        double _top;
-        double _bottom;
+        Real _left;
+        Real _right;
+        Real _top;
+        Real _bottom;
 
         Display *_display;
 
@@ -26,17 +26,29 @@
 #define _ART_DTRACKNET_H_
 
 // usually the following should work; otherwise define OS_* manually:
-//#ifndef _WIN32
-//	#define OS_UNIX  // for Unix (Linux, Irix)
-//#else
-	#define OS_WIN   // for MS Windows (2000, XP)
-//#endif
+#if !defined(OS_UNIX) && !defined(OS_WIN)
+	#ifndef _WIN32
+		#define OS_UNIX  // for Unix (Linux, Irix)
+	#else
+		#define OS_WIN   // for MS Windows (2000, XP)
+	#endif
+#endif
+
+// Linux can drain all queued packets with a single recvmmsg() call
+// and reports the kernel arrival time of each packet (SO_TIMESTAMPNS)
+#if defined(OS_UNIX) && defined(__linux__)
+	#define DTRACKNET_RECVMMSG
+	#define DTRACKNET_TIMESTAMPNS
+#endif
 
 #ifdef OS_UNIX
 	#include <unistd.h>
 	#include <netdb.h>
+	#include <errno.h>
 	#include <sys/socket.h>
+	#include <sys/select.h>
 	#include <sys/time.h>
+	#include <time.h>
 	#include <netinet/in.h>
 	#include <arpa/inet.h>
 #endif
@@ -84,6 +96,45 @@ int udp_exit(void* sock, unsigned int ip = 0);
  */
 int udp_receive(const void* sock, void *buffer, int maxlen, int tout_us);
 
+/**
+ *	\brief	Receive all queued UDP packets at once.
+ *
+ *	Waits for the first packet, then drains the socket into the given buffers in
+ *	arrival order (oldest first). On Linux this is a single recvmmsg() call; other
+ *	systems fall back to one recv() per packet. At most count packets are returned,
+ *	further packets stay queued for the next call.
+ *
+ *	On Linux the arrival times are taken by the kernel when the packet hit the socket;
+ *	elsewhere they are taken right after the packet was read.
+ *	@param[in]	sock	socket number
+ *	@param[out]	buffers	array of count buffers for UDP data
+ *	@param[out]	lens	number of received bytes per buffer, -4 if the packet did not fit
+ *	@param[out]	times_ns	arrival time per packet in ns (see udp_get_time_ns()), NULL if not needed
+ *	@param[in]	maxlen	length of each buffer
+ *	@param[in]	count	number of buffers
+ *	@param[in]  tout_us timeout in us (micro sec)
+ *	@return	number of received packets, <0 if error/timeout occured
+ */
+int udp_receive_batch(const void* sock, void** buffers, int* lens, long long* times_ns, int maxlen, int count, int tout_us);
+
+/**
+ *	\brief	Wait until UDP data are available on at least one of several sockets.
+ *
+ *	One select() call for all sockets, so several data sources can be served by one thread.
+ *	@param[in]	socks	array of count socket numbers
+ *	@param[out]	ready	per socket: 1 if data are available, 0 if not
+ *	@param[in]	count	number of sockets
+ *	@param[in]  tout_us timeout in us (micro sec)
+ *	@return	number of sockets with data, -1 if timeout, -2 if error occured
+ */
+int udp_wait_any(void** socks, int* ready, int count, int tout_us);
+
+/**
+ *	\brief	Get current time on the clock used for packet arrival times.
+ *	@return	Wall clock time in ns since 1970-01-01 (UTC)
+ */
+long long udp_get_time_ns();
+
 /**
  *	\brief	Send UDP data.
  *
@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <vector>
 
 // Parsing DTrack data
 
@@ -49,6 +50,15 @@ char* string_nextline(char* str, char* start, int len);
  */
 char* string_get_i(char* str, int* i);
 
+/**
+ *	\brief	Read next 'int' value from string, not reading behind end
+ *	@param[in] 	str		string
+ *	@param[in] 	end		end of string (needs no '\0')
+ *	@param[out] i		read value
+ *	@return	pointer behind read value in str; NULL in case of error
+ */
+const char* string_get_i(const char* str, const char* end, int* i);
+
 /**
  *	\brief	Read next 'unsigned int' value from string
  *	@param[in] 	str		string
@@ -57,6 +67,15 @@ char* string_get_i(char* str, int* i);
  */
 char* string_get_ui(char* str, unsigned int* ui);
 
+/**
+ *	\brief	Read next 'unsigned int' value from string, not reading behind end
+ *	@param[in] 	str		string
+ *	@param[in] 	end		end of string (needs no '\0')
+ *	@param[out]	ui		read value
+ *	@return	pointer behind read value in str; NULL in case of error
+ */
+const char* string_get_ui(const char* str, const char* end, unsigned int* ui);
+
 /**
  *	\brief	Read next 'double' value from string
  *	@param[in] 	str		string
@@ -65,6 +84,15 @@ char* string_get_ui(char* str, unsigned int* ui);
  */
 char* string_get_d(char* str, double* d);
 
+/**
+ *	\brief	Read next 'double' value from string, not reading behind end
+ *	@param[in] 	str		string
+ *	@param[in] 	end		end of string (needs no '\0')
+ *	@param[out] d		read value
+ *	@return pointer behind read value in str; NULL in case of error
+ */
+const char* string_get_d(const char* str, const char* end, double* d);
+
 /**
  *	\brief	Read next 'float' value from string:
  *	@param[in] 	str		string
@@ -73,6 +101,15 @@ char* string_get_d(char* str, double* d);
  */
 char* string_get_f(char* str, float* f);
 
+/**
+ *	\brief	Read next 'float' value from string, not reading behind end
+ *	@param[in] 	str		string
+ *	@param[in] 	end		end of string (needs no '\0')
+ *	@param[out] f 		read value
+ *	@return pointer behind read value in str; NULL in case of error
+ */
+const char* string_get_f(const char* str, const char* end, float* f);
+
 /**
  *	\brief Process next block '[...]' in string
  *	@param[in] 	str		string
@@ -84,6 +121,91 @@ char* string_get_f(char* str, float* f);
  */
 char* string_get_block(char* str, const char* fmt, int* idat = NULL, float* fdat = NULL, double *ddat = NULL);
 
+/**
+ *	\brief	Positions of all lines and blocks '[...]' in a buffer (see string_index())
+ */
+typedef struct {
+	const char* buf;			// indexed buffer
+	int len;					// length of the string in buf
+	std::vector<int> line;		// offset of the first character of each line (without the first line)
+	std::vector<int> open;		// offset of each '['
+	std::vector<int> close;		// offset of each ']'
+	int num_line;				// number of valid entries in line, open and close
+	int num_open;
+	int num_close;
+	int nextline;				// search positions of string_nextline() and string_get_block()
+	int nextopen;
+	int nextclose;
+} DTrack_Index_Type;
+
+/**
+ *	\brief	Find all lines and blocks '[...]' in buffer, in one pass
+ *
+ *	Uses SSE2 or AVX2 if the compiler has them enabled; without them nothing is indexed and
+ *	the functions taking the index search the buffer instead. The buffer is only read, and must
+ *	not be changed while the index is in use.
+ *	@param[in]	buf		buffer
+ *	@param[in]	len		buffer length in bytes; the buffer ends earlier at a '\0'
+ *	@param[out]	index	positions in buffer
+ */
+void string_index(const char* buf, int len, DTrack_Index_Type* index);
+
+/**
+ *	\brief	Search next line in indexed buffer, like string_nextline() without reading it again
+ *	@param	index	positions in buffer, from string_index()
+ *	@param 	start	position within buffer
+ *	@return	begin of line, NULL if no new line in buffer
+ */
+const char* string_nextline(DTrack_Index_Type* index, const char* start);
+
+/**
+ *	\brief Process next block '[...]' in indexed buffer, like string_get_block() without searching the delimiters
+ *	@param[in] 	index	positions in buffer, from string_index()
+ *	@param[in] 	str		position within buffer
+ *	@param[in] 	fmt		format string ('i' for 'int', 'f' for 'float', 'd' for 'double')
+ *	@param[out] idat	array for 'int' values (long enough due to fmt)
+ *	@param[out] fdat	array for 'float' values (long enough due to fmt)
+ *	@param[out] ddat	array for 'double' values (long enough due to fmt)
+ *	@return pointer behind read value in str; NULL in case of error
+ */
+const char* string_get_block(DTrack_Index_Type* index, const char* str, const char* fmt, int* idat = NULL, float* fdat = NULL, double *ddat = NULL);
+
+/**
+ *	\brief	Skip the next blocks '[...]' in indexed buffer, without reading their values
+ *	@param[in] 	index	positions in buffer, from string_index()
+ *	@param[in] 	str		position within buffer
+ *	@param[in] 	n		number of blocks
+ *	@return pointer behind the last skipped block in str; NULL in case of error
+ */
+const char* string_skip_blocks(DTrack_Index_Type* index, const char* str, int n);
+
+/**
+ *	\brief Process next block '[...]' of N 'double' values in indexed buffer, like string_get_block() with N 'd'
+ *
+ *	The number of values is known when compiling, so there is no format to read for each
+ *	value. Available for N = 3 (location), 6 (finger data) and 9 (rotation matrix).
+ *	@param[in] 	index	positions in buffer, from string_index()
+ *	@param[in] 	str		position within buffer
+ *	@param[out] ddat	array for N 'double' values
+ *	@return pointer behind read block in str; NULL in case of error
+ */
+template<int N>
+const char* string_get_block_d(DTrack_Index_Type* index, const char* str, double* ddat);
+
+/**
+ *	\brief Process next block '[...]' of an 'int', a 'double' and N more 'int' values in indexed buffer
+ *
+ *	Like string_get_block() with the format "id" followed by N 'i', as the first block of
+ *	each body, Flystick, measurement tool or hand. Available for N = 0, 1 and 2.
+ *	@param[in] 	index	positions in buffer, from string_index()
+ *	@param[in] 	str		position within buffer
+ *	@param[out] idat	array for N + 1 'int' values
+ *	@param[out] d		'double' value
+ *	@return pointer behind read block in str; NULL in case of error
+ */
+template<int N>
+const char* string_get_block_id(DTrack_Index_Type* index, const char* str, int* idat, double* d);
+
 /**
  *	\brief	Read next 'word' value from string
  *	@param[in] 	str		string
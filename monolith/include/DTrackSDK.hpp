@@ -61,6 +61,111 @@
 //! Max message size
 #define DTRACK_PROT_MAXLEN 200
 
+//! Number of UDP packets that can be drained from the socket with one system call
+#define DTRACK_UDP_BATCH 32
+
+#define DTRACK_DATA_BODY      0x01	//! Subscription: standard bodies ('6dcal', '6d')
+#define DTRACK_DATA_FLYSTICK  0x02	//! Subscription: Flysticks ('6df', '6df2')
+#define DTRACK_DATA_MEATOOL   0x04	//! Subscription: measurement tools ('6dmt')
+#define DTRACK_DATA_HAND      0x08	//! Subscription: Fingertracking hands ('glcal', 'gl')
+#define DTRACK_DATA_MARKER    0x10	//! Subscription: single markers ('3d')
+#define DTRACK_DATA_ALL       0x1f	//! Subscription: all data
+
+#define DTRACK_LINE_FR     0	//! Line type 'fr' (see DTrack_Statistics_Type)
+#define DTRACK_LINE_TS     1	//! Line type 'ts'
+#define DTRACK_LINE_6DCAL  2	//! Line type '6dcal'
+#define DTRACK_LINE_6D     3	//! Line type '6d'
+#define DTRACK_LINE_6DF    4	//! Line type '6df'
+#define DTRACK_LINE_6DF2   5	//! Line type '6df2'
+#define DTRACK_LINE_6DMT   6	//! Line type '6dmt'
+#define DTRACK_LINE_GLCAL  7	//! Line type 'glcal'
+#define DTRACK_LINE_GL     8	//! Line type 'gl'
+#define DTRACK_LINE_3D     9	//! Line type '3d'
+#define DTRACK_LINE_NUM    10	//! Number of line types
+
+/**
+ * 	\brief	Standard bodies of DTrack packets, as one array per value (see DTrack_Frame_Type)
+ *
+ *	Body id has its location at loc[3 * id] and its rotation at rot[9 * id], so the values of
+ *	all bodies follow each other. The values are only valid if stamp[id] is not 0 and equals
+ *	the generation of the packet; bodies that are not tracked are not written at all.
+ */
+typedef struct {
+	unsigned int generation;                     // generation of the last packet with standard body data (0 if none)
+	std::vector<unsigned int> stamp;             // per id: generation of the packet the body was tracked in (0 if not tracked)
+	std::vector<double> quality;                 // per id: quality (0 <= qu <= 1)
+	std::vector<double> loc;                     // per id: location (3 values, in mm)
+	std::vector<double> rot;                     // per id: rotation matrix (9 values, column-wise)
+} DTrack_Body_Table_Type;
+
+/**
+ * 	\brief	Fingertracking hands of DTrack packets (see DTrack_Frame_Type)
+ *
+ *	hand[id] is only valid if stamp[id] is not 0 and equals the generation of the packet.
+ */
+typedef struct {
+	unsigned int generation;                     // generation of the last packet with hand data (0 if none)
+	std::vector<unsigned int> stamp;             // per id: generation of the packet the hand was tracked in (0 if not tracked)
+	std::vector<DTrack_Hand_Type_d> hand;        // per id: hand data
+} DTrack_Hand_Table_Type;
+
+/**
+ * 	\brief	Contents of DTrack data packets (see DTrackSDK::parseFrame())
+ *
+ *	Parsing a packet counts generation up. Bodies and hands of the packet are stamped with it
+ *	instead of clearing the others, so a body is tracked in the packet if its stamp equals
+ *	generation. The tables keep the generation of the last packet with their data too, which
+ *	tells the bodies and hands tracked then. The vectors can be longer than the numbers, as
+ *	the frame keeps its memory to parse the next packet.
+ */
+typedef struct {
+	unsigned int generation;                     // generation of the last packet parsed (0 before the first)
+	unsigned int framecounter;                   // frame counter (0, if information not available)
+	double timestamp;                            // timestamp (-1, if information not available)
+	bool has_body;                               // packet has standard body data ('6d')
+	int num_bodycal;                             // number of calibrated bodies of all kinds (-1, if information not available)
+	int num_body;                                // number of standard bodies (highest id + 1, or as calibrated)
+	DTrack_Body_Table_Type body;                 // standard body data, by id
+	bool has_flystick;                           // packet has Flystick data ('6df' or '6df2')
+	int num_flystick1;                           // number of Flysticks in older format ('6df')
+	int num_flystick;                            // number of calibrated Flysticks
+	std::vector<DTrack_FlyStick_Type_d> flystick; // Flystick data, by id
+	bool has_meatool;                            // packet has measurement tool data ('6dmt')
+	int num_meatool;                             // number of calibrated measurement tools
+	std::vector<DTrack_MeaTool_Type_d> meatool;  // measurement tool data, by id
+	bool has_hand;                               // packet has Fingertracking hand data ('gl')
+	int num_handcal;                             // number of calibrated hands (-1, if information not available)
+	int num_hand;                                // number of hands (highest id + 1, or as calibrated)
+	DTrack_Hand_Table_Type hand;                 // Fingertracking hand data, by id
+	bool has_marker;                             // packet has single marker data ('3d')
+	int num_marker;                              // number of tracked single markers
+	std::vector<DTrack_Marker_Type_d> marker;    // single marker data
+	DTrack_Index_Type index;                     // lines and blocks of the packet, used while parsing
+	int error_line;                              // type of the line that could not be parsed (DTRACK_LINE_*; -1 if parsed)
+} DTrack_Frame_Type;
+
+/**
+ * 	\brief	Statistics of the packets a DTrackSDK object received (see DTrackSDK::getStatistics())
+ */
+typedef struct {
+	unsigned long packets;                       // packets processed
+	unsigned long frame_gaps;                    // frame counters missing between processed packets (lost or coalesced)
+	unsigned long parse_errors[DTRACK_LINE_NUM]; // packets that could not be parsed, by line type (DTRACK_LINE_*)
+	unsigned long timeouts;                      // calls of receive() without data in time
+	unsigned long net_errors;                    // calls of receive() that failed otherwise
+} DTrack_Statistics_Type;
+
+/**
+ * 	\brief	Data to parse from DTrack packets (see DTrackSDK::setSubscription())
+ *
+ *	Lines of other types are skipped without reading their values, and so are the blocks
+ *	of standard bodies with other ids. Those bodies get a quality of -1.
+ */
+typedef struct {
+	int types;                                   // data to parse (DTRACK_DATA_... bits)
+	std::vector<bool> body;                      // per standard body id: parse it (empty: all bodies)
+} DTrack_Subscription_Type;
+
 /**
  * 	\brief DTrack SDK main class.
  */
@@ -108,6 +213,14 @@ public:
 	 */
 	DTrackSDK(const std::string& server_host, unsigned short server_port, unsigned short data_port = 0);
 
+	/**
+	 *	\brief	Constructor. Use for packets that are not received from the network.
+	 *
+	 *	Opens no sockets, so packets can only be processed with receivePacket(), e.g. to
+	 *	replay recorded data.
+	 */
+	DTrackSDK();
+
 	/**
 	 * 	\brief Destructor.
 	 */
@@ -121,6 +234,22 @@ public:
 		ERR_PARSE,
 	} Errors;
 
+	/**
+	 *	\brief	Function called with every UDP packet fetched from the socket, before it is processed.
+	 *
+	 *	@param	context				pointer given to setPacketHandler()
+	 *	@param	data				packet data (not terminated by '\0')
+	 *	@param	len					length of packet data in bytes
+	 *	@param	receive_time_ns		arrival time of the packet (see getReceiveTimeNs())
+	 */
+	typedef void (*PacketHandler)(void* context, const char* data, int len, long long receive_time_ns);
+
+	// Handling of packets that queued up since the last call of receive()
+	typedef enum {
+		RECEIVE_NEWEST = 0,	// process only the newest packet, skip older ones
+		RECEIVE_ALL			// process every queued packet in order, one per call of receive()
+	} ReceiveMode;
+
 	/**
 	 * 	\brief	Get current remote system type (e.g. DTrack, DTrack2).
 	 */
@@ -167,10 +296,118 @@ public:
 	/**
 	 *	\brief	Receive and process one DTrack data packet (UDP; ASCII protocol)
 	 *
+	 *	All packets queued at the socket are fetched with one system call. Depending on
+	 *	the receive mode either the newest of them is processed, or the oldest one while
+	 *	the others are kept for the following calls.
 	 *	@return	receiving was successful
 	 */
 	bool receive();
 
+	/**
+	 *	\brief	Set how packets queued since the last call of receive() are handled.
+	 *	@param	mode	RECEIVE_NEWEST (default) or RECEIVE_ALL
+	 */
+	void setReceiveMode(ReceiveMode mode);
+
+	/**
+	 *	\brief	Get how packets queued since the last call of receive() are handled.
+	 *	@return	Receive mode.
+	 */
+	ReceiveMode getReceiveMode();
+
+	/**
+	 *	\brief	Set which data is parsed from the packets.
+	 *
+	 *	Skipping what the application doesn't use saves parsing time, e.g. with Fingertracking
+	 *	or many single markers enabled in DTrack. Data of skipped types keeps its last values;
+	 *	standard bodies with skipped ids are reported as not tracked.
+	 *	@param	subscription	data to parse (default: DTRACK_DATA_ALL, all bodies)
+	 */
+	void setSubscription(const DTrack_Subscription_Type& subscription);
+
+	/**
+	 *	\brief	Get which data is parsed from the packets.
+	 *	@return	Data to parse.
+	 */
+	DTrack_Subscription_Type getSubscription();
+
+	/**
+	 *	\brief	Get number of already fetched packets still waiting to be processed.
+	 *
+	 *	Only in RECEIVE_ALL mode; the next calls of receive() return them without a system call.
+	 *	@return	Number of pending packets.
+	 */
+	int getNumPendingPackets();
+
+	/**
+	 *	\brief	Get number of packets fetched from the socket but never processed.
+	 *
+	 *	In RECEIVE_NEWEST mode these are the older packets skipped for a newer one; in
+	 *	RECEIVE_ALL mode only pending packets dropped by receivePacket() or a mode change.
+	 *	@return	Number of skipped packets since the object was created.
+	 */
+	unsigned long getNumCoalescedPackets();
+
+	/**
+	 *	\brief	Get statistics of the packets received since the object was created.
+	 *
+	 *	Counts packets of receive() and receivePacket(). The frame gaps include packets
+	 *	skipped in RECEIVE_NEWEST mode, see getNumCoalescedPackets().
+	 *	@return	Statistics.
+	 */
+	DTrack_Statistics_Type getStatistics();
+
+	/**
+	 *	\brief	Set a function to be called with every UDP packet fetched from the socket.
+	 *
+	 *	Called from receive(), for every packet in arrival order, including those that are
+	 *	skipped in RECEIVE_NEWEST mode. Use it to record the raw data stream.
+	 *	@param	handler		function to call, NULL to stop calling it
+	 *	@param	context		pointer passed on to the function
+	 */
+	void setPacketHandler(PacketHandler handler, void* context);
+
+	/**
+	 *	\brief	Process one DTrack data packet that was not received from the UDP socket.
+	 *
+	 *	The packet replaces the last received frame as receive() would, e.g. to replay
+	 *	recorded data. Pending packets of RECEIVE_ALL mode are dropped. The data is parsed
+	 *	where it is and not changed, so it may be read-only (memory-mapped, for example).
+	 *	@param	data				packet data (ASCII protocol, need not be terminated by '\0')
+	 *	@param	len					length of packet data in bytes
+	 *	@param	receive_time_ns		arrival time to report with getReceiveTimeNs()
+	 *	@return	processing was successful
+	 */
+	bool receivePacket(const char* data, int len, long long receive_time_ns);
+
+	/**
+	 *	\brief	Parse one DTrack data packet without changing it.
+	 *
+	 *	Independent of any DTrackSDK object and of earlier packets, so it can run on any
+	 *	thread, e.g. over a memory-mapped recording or shared memory. Reuse the frame for
+	 *	the next packet to keep its memory. Start with a frame of generation 0, e.g.
+	 *	DTrack_Frame_Type frame = DTrack_Frame_Type().
+	 *	@param[in]	data	packet data (ASCII protocol, need not be terminated by '\0'; ends early at a '\0')
+	 *	@param[in]	len		length of packet data in bytes
+	 *	@param[out]	frame	contents of the packet
+	 *	@param[in]	subscription	data to parse (NULL: all)
+	 *	@return	parsing was successful
+	 */
+	static bool parseFrame(const char* data, int len, DTrack_Frame_Type& frame, const DTrack_Subscription_Type* subscription = NULL);
+
+	/**
+	 *	\brief	Wait until at least one of several DTrackSDK objects has data to receive.
+	 *
+	 *	Waits on all UDP sockets with one system call, so one thread can serve several
+	 *	ARTtrack Controllers. Packets already fetched in RECEIVE_ALL mode count as data.
+	 *	Call receive() for every object marked ready; it will not block.
+	 *	@param[in]	sdks		objects to wait for, all with a valid UDP connection
+	 *	@param[out]	ready		per object: has data to receive
+	 *	@param[in]	timeout_us	timeout in us (micro second)
+	 *	@return	number of objects with data, 0 if timeout, <0 if error occured
+	 */
+	static int waitForData(const std::vector<DTrackSDK*>& sdks, std::vector<bool>& ready, int timeout_us);
+
 	/**
 	 *	\brief	Send DTrack command (UDP).
 	 *
@@ -207,6 +444,16 @@ public:
 	 */
 	double getTimeStamp();
 
+	/**
+	 * 	\brief	Get arrival time of the frame at this computer.
+	 *
+	 *	Refers to last received frame. Unlike getTimeStamp() this is taken on the local clock:
+	 *	by the kernel when the packet arrived (Linux), or when it was read from the socket.
+	 *	Compare it with udp_get_time_ns().
+	 *	@return	Arrival time in ns since 1970-01-01 (-1 if information not available).
+	 */
+	long long getReceiveTimeNs();
+
 	/**
 	 * 	\brief	Get number of calibrated standard bodies (as far as known).
 	 *
@@ -294,6 +541,16 @@ public:
 	 */
 	DTrack_Marker_Type_d* getMarker(int index);
 
+	/**
+	 *	\brief	Get the parsed data of the last received frame, with standard bodies as one array per value.
+	 *
+	 *	For code that processes all bodies at once. A standard body is tracked if its stamp is
+	 *	not 0 and equals frame.body.generation, the same for hands; getNumBody() and getNumHand()
+	 *	tell how many there are.
+	 *	@return	Parsed data, valid until the next call of receive().
+	 */
+	const DTrack_Frame_Type& getFrame();
+
 	/**
 	 * 	\brief	Set DTrack parameter.
 	 *	@param 	category	parameter category
@@ -400,20 +657,34 @@ private:
 	int d_udptimeout_us;        	// timeout for receiving UDP data
 
 	int d_udpbufsize;               // size of UDP buffer
-	char* d_udpbuf;                 // UDP buffer
+	char* d_udpbuf;                 // UDP buffer (DTRACK_UDP_BATCH packets of d_udpbufsize bytes)
+	char* d_udpbufs[DTRACK_UDP_BATCH];  // start of each packet in d_udpbuf
+	int d_udplens[DTRACK_UDP_BATCH];    // length of each received packet
+	long long d_udptimes[DTRACK_UDP_BATCH];  // arrival time of each received packet (ns)
+	int d_udpnum;                   // number of packets received with the last system call
+	int d_udpnext;                  // next packet to be processed (RECEIVE_ALL mode)
+	ReceiveMode d_receivemode;      // handling of queued packets
+	unsigned long d_udpfetched;     // number of packets fetched from the socket
+	unsigned long d_udpprocessed;   // number of fetched packets that were processed
+	PacketHandler d_packethandler;  // called with every packet fetched (NULL if not used)
+	void* d_packetcontext;          // passed on to d_packethandler
+	DTrack_Frame_Type d_frame;      // contents of the packet being processed
+	DTrack_Subscription_Type d_subscription;  // data to parse from the packets
+	std::vector<void*> d_waitsocks; // waitForData(): sockets of all objects (used in the first object only)
+	std::vector<int> d_waitready;   // waitForData(): readable flags of all objects (used in the first object only)
 
 	unsigned int act_framecounter;                   // frame counter
 	double act_timestamp;                            // timestamp (-1, if information not available)
+	long long act_receivetime_ns;                    // local arrival time in ns (-1, if information not available)
+	unsigned int act_lastframecounter;               // last frame counter seen, for frame gaps (0 if none)
+	DTrack_Statistics_Type d_statistics;             // statistics of received packets
 	int act_num_body;                                // number of calibrated standard bodies (as far as known)
-	std::vector<DTrack_Body_Type_d> act_body;         // array containing standard body data
-	int act_num_flystick;                            // number of calibrated Flysticks
-	std::vector<DTrack_FlyStick_Type_d> act_flystick; // array containing Flystick data
-	int act_num_meatool;                             // number of calibrated measurement tools
-	std::vector<DTrack_MeaTool_Type_d> act_meatool;   // array containing measurement tool data
+	std::vector<DTrack_Body_Type_d> act_body;         // standard body data, filled from d_frame by getBody()
+	int act_num_flystick;                            // number of calibrated Flysticks (data in d_frame)
+	int act_num_meatool;                             // number of calibrated measurement tools (data in d_frame)
 	int act_num_hand;                                // number of calibrated Fingertracking hands (as far as known)
-	std::vector<DTrack_Hand_Type_d> act_hand;         // array containing Fingertracking hands data
-	int act_num_marker;                              // number of tracked single markers
-	std::vector<DTrack_Marker_Type_d> act_marker;     // array containing single marker data
+	std::vector<DTrack_Hand_Type_d> act_hand;         // Fingertracking hands data, filled from d_frame by getHand()
+	int act_num_marker;                              // number of tracked single markers (data in d_frame)
 
 	std::string d_message_origin;     // last DTrack message: origin of message
 	std::string d_message_status;     // last DTrack message: status of message
@@ -429,6 +700,23 @@ private:
 	 */
 	void setLastDTrackError(int newError = 0, std::string newErrorString = "");
 
+	/**
+	 *	\brief	Pass the packets of the last system call to the packet handler.
+	 *
+	 *	@param	n	number of packets received with the last system call
+	 */
+	void handlePackets(int n);
+
+	/**
+	 *	\brief	Process one DTrack data packet (ASCII protocol).
+	 *
+	 *	Parses the packet with parseFrame() and takes over its data.
+	 *	@param	data	packet data (not changed)
+	 *	@param	len		length of packet data in bytes
+	 *	@return	processing was successful
+	 */
+	bool processPacket(const char* data, int len);
+
 	/**
 	 *	\brief	Init function, called from constructor.
 	 *
@@ -436,7 +724,7 @@ private:
 	 *	@param	server_host			hostname or IP address of ARTtrack Controller (empty if not used)
 	 *	@param	server_port			port number of ARTtrack Controller (default is 50105)
 	 *	@param	data_port			port number to receive tracking data from ARTtrack Controller (0 if to be chosen)
-	 *	@param	data_bufsize		size of buffer for UDP packets (in bytes; default is 20000)
+	 *	@param	data_bufsize		size of buffer for UDP packets (in bytes; default is 20000; 0 to open no sockets)
 	 *	@param	data_timeout_us		timeout (receiving) in us (in micro second, default is 1s)
 	 *	@param	server_timeout_us	timeout for access to ARTtrack Controller (in micro second; receiving and sending; default is 10s)
 	 */
@@ -92,16 +92,16 @@ namespace MTF
         ///
         ///  \brief Returns the width of the screen
         ///
-        ///  @return                        double value for the width of the screen in feet
+        ///  @return                        Real value for the width of the screen in feet
         ///
-        double GetScreenWidth();
+        Real GetScreenWidth();
 
         ///
         ///  \brief Returns the height of the screen
         ///
-        ///  @return                        double value for the height of the screen in feet
+        ///  @return                        Real value for the height of the screen in feet
         ///
-        double GetScreenHeight();
+        Real GetScreenHeight();
 
         ///
         ///  \brief Returns a matrix for the orientation of the screen
@@ -122,9 +122,9 @@ namespace MTF
         Vector3 _UL;
 
         /// Real world display screen width
-        double _width;
+        Real _width;
         /// Real world display screen height
-        double _height;
+        Real _height;
     };
 }
 
@@ -0,0 +1,35 @@
+#ifndef _FRAMESTORE_H
+#define _FRAMESTORE_H
+///
+///  \file FrameStore.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \brief Where the tracking thread publishes its frames.
+///
+///  The FrameStore holds the last frame and the frames before it, each readable by any
+///  thread without locking.  It contains no pointers, so it also works when it is placed
+///  in memory shared with other processes (see SharedFrameStore).
+///
+
+#include "SeqLock.h"
+#include "SeqLockRing.h"
+#include "TrackingFrame.h"
+
+namespace MTF
+{
+
+    ///
+    ///  \brief The published frames of one tracking thread
+    ///
+    struct FrameStore
+    {
+        static const unsigned int HISTORY_SIZE = 128;       ///< Number of frames kept in the history
+
+        SeqLock<TrackingFrame> frame;                       ///< The last frame, frame number 0 until the first one is received
+        SeqLockRing<TrackingFrame, HISTORY_SIZE> history;   ///< The last HISTORY_SIZE frames received, frame number n at index n - 1
+    };
+
+}
+
+#endif
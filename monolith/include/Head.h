@@ -9,16 +9,20 @@
 ///  \brief This class handles head tracking for the framework
 ///
 ///  This class derives from TrackingBody and implements the methods
-///  needed to perform head tracking operations.
+///  needed to perform head tracking operations.  A Head can be passed to the
+///  Camera directly as a TrackingBody, including a Head returned by Predict.
 ///
 
 #include "Display.h"
 #include "DTrackSDK.hpp"
+#include "TrackingFrame.h"
+#include "PoseFilter.h"
+#include "PosePredictor.h"
 
 namespace MTF
 {
 
-    class Head : TrackingBody
+    class Head : public TrackingBody
     {
 
     public:
@@ -30,6 +34,15 @@ namespace MTF
         ///
         Head();
 
+        ///
+        ///  \brief Head Constructor
+        ///
+        ///  Creates a Head object from a state published by the tracking thread.
+        ///
+        ///  \param state                   BodyState containing the position and orientation of the head
+        ///
+        Head(const BodyState &state);
+
         ///
         ///  \brief Head Deconstructor
         ///
@@ -77,10 +90,94 @@ namespace MTF
         ///
         bool IsTracked();
 
+        ///
+        ///  \brief Returns when the tracking data for the current pose of this Head arrived at this computer
+        ///
+        ///  The time is taken on the local clock when the packet arrived (by the kernel on Linux),
+        ///  not by the ART Tracker.  It can be compared with udp_get_time_ns() to measure latency.
+        ///  Samples without a usable pose, or dropped by the filter, leave the time unchanged.
+        ///
+        ///  \return                        Arrival time in nanoseconds since 1970, or -1 if no data has been received yet
+        ///
+        long long GetReceiveTimeNs();
+
+        ///
+        ///  \brief Returns the number of the tracker frame this Head comes from
+        ///
+        ///  Frames are numbered from 1 in the order they are received.  If this number is
+        ///  lower than Monolith::GetFrameNumber(), a newer frame has arrived since this Head
+        ///  was retrieved.
+        ///
+        ///  \return                        The frame number, 0 if no frame has been received yet
+        ///
+        unsigned long GetFrameNumber();
+
+        ///
+        ///  \brief Returns the estimated velocity of the head
+        ///
+        ///  \return                        Vector3 containing the velocity in feet per second
+        ///
+        Vector3 GetVelocity();
+
+        ///
+        ///  \brief Returns the estimated angular velocity of the head
+        ///
+        ///  \return                        Vector3 containing the axis of rotation scaled by the speed in radians per second
+        ///
+        Vector3 GetAngularVelocity();
+
+        ///
+        ///  \brief Returns this Head extrapolated to another time
+        ///
+        ///  The position and orientation are moved on with the estimated velocities, from
+        ///  the time the tracking data arrived to the target time.  Pass the time the frame
+        ///  will be shown, for example the next vsync, to make up for the tracking and
+        ///  rendering latency.  At most PosePredictor::MAX_PREDICTION seconds are extrapolated,
+        ///  and a Head that is not tracked is returned unchanged.
+        ///
+        ///  \param targetTimeNs            Target time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of this Head at the target time
+        ///
+        Head Predict(long long targetTimeNs);
+
+        ///
+        ///  \brief Returns the Head between two tracked Heads at the given time
+        ///
+        ///  The position and velocities are interpolated linearly and the orientation by
+        ///  slerp.  If either Head is not tracked, or they arrived at the same time, the one
+        ///  closer to the given time is returned.  The result has the given time as its
+        ///  receive time.
+        ///
+        ///  \param from                    The earlier Head
+        ///  \param to                      The later Head
+        ///  \param timeNs                  Time to interpolate to, in nanoseconds since 1970
+        ///  \return                        The interpolated Head
+        ///
+        static Head Interpolate(Head from, Head to, long long timeNs);
+
         ///
         ///  \brief Updates the values of the Head's position and orientation
         ///
-        void Update(DTrack_Body_Type_d data);
+        ///  \param data                    Tracking data for the head from the last received frame
+        ///  \param receiveTimeNs           Arrival time of the frame in nanoseconds since 1970
+        ///
+        void Update(DTrack_Body_Type_d data, long long receiveTimeNs);
+
+        ///
+        ///  \brief Sets the filters that each new position and orientation of the Head is run through
+        ///
+        ///  The filters are run by Update, so they only need to be set on the Head owned by the tracking thread.
+        ///
+        ///  \param filter                  PoseFilterChain that is copied into this Head, an empty chain disables filtering
+        ///
+        void SetFilter(PoseFilterChain filter);
+
+        ///
+        ///  \brief Sets how Update estimates the velocities of the Head
+        ///
+        ///  \param mode                    How velocities are estimated, see PosePredictor
+        ///
+        void SetPredictionMode(PosePredictor::MODE mode);
 
         ///
         ///  \brief Returns a copy of this Head
@@ -89,13 +186,28 @@ namespace MTF
         ///
         Head GetCopy();
 
+        ///
+        ///  \brief Stores the position and orientation of this Head in a plain data structure
+        ///
+        ///  \param state                   BodyState that is assigned the values of this Head
+        ///
+        void GetState(BodyState &state);
+
     private:
         bool _tracked;
+        long long _receiveTimeNs;
+        unsigned long _frameNumber;
 
         Vector3 _position;
         Vector3 _view;
         Vector3 _up;
         Vector3 _right;
+
+        Vector3 _velocity;
+        Vector3 _angularVelocity;
+
+        PoseFilterChain _filter;
+        PosePredictor _predictor;
     };
 
 }
@@ -8,7 +8,7 @@
 ///  \class MTF::Matrix4 Matrix4.h "Matrix4.h"
 ///  \brief This class provides for a 4 by 4 matrix and its associated operations
 ///
-///  This class stores a 4x4 double matrix.  Common functions, such as matrix addition
+///  This class stores a 4x4 Real matrix (see Real.h).  Common functions, such as matrix addition
 ///  and multiplication is provided through overload operators.  Less common functions
 ///  such as matrix inversion and multiplying a vector by a matrix are also included.
 ///
@@ -35,38 +35,38 @@ namespace MTF
         ///
         ///  \brief Matrix4 Constructor
         ///
-        ///  Creates a Matrix4 from the pased in 2 dimensional double array.
+        ///  Creates a Matrix4 from the pased in 2 dimensional Real array.
         ///
-        ///  @param mat                     2D double array with a length of 4 in each dimension, containing a matrix to be assigned
+        ///  @param mat                     2D Real array with a length of 4 in each dimension, containing a matrix to be assigned
         ///
-        Matrix4(double mat[4][4]);
+        Matrix4(Real mat[4][4]);
 
         ///
         ///  \brief Matrix4 Constructor
         ///
-        ///  Creates a Matrix4 from the pased in 16 double values
-        ///
-        ///  @param m00                     double value at the first row and first column in the matrix
-        ///  @param m01                     double value at the first row and second column in the matrix
-        ///  @param m02                     double value at the first row and third column in the matrix
-        ///  @param m03                     double value at the first row and fourth column in the matrix
-        ///  @param m10                     double value at the second row and first column in the matrix
-        ///  @param m11                     double value at the second row and second column in the matrix
-        ///  @param m12                     double value at the second row and third column in the matrix
-        ///  @param m13                     double value at the second row and fourth column in the matrix
-        ///  @param m20                     double value at the third row and first column in the matrix
-        ///  @param m21                     double value at the third row and second column in the matrix
-        ///  @param m22                     double value at the third row and third column in the matrix
-        ///  @param m23                     double value at the third row and fourth column in the matrix
-        ///  @param m30                     double value at the fourth row and first column in the matrix
-        ///  @param m31                     double value at the fourth row and second column in the matrix
-        ///  @param m32                     double value at the fourth row and third column in the matrix
-        ///  @param m33                     double value at the fourth row and fourth column in the matrix
-        ///
-        Matrix4(double m00, double m01, double m02, double m03,
-                double m10, double m11, double m12, double m13,
-                double m20, double m21, double m22, double m23,
-                double m30, double m31, double m32, double m33);
+        ///  Creates a Matrix4 from the pased in 16 Real values
+        ///
+        ///  @param m00                     Real value at the first row and first column in the matrix
+        ///  @param m01                     Real value at the first row and second column in the matrix
+        ///  @param m02                     Real value at the first row and third column in the matrix
+        ///  @param m03                     Real value at the first row and fourth column in the matrix
+        ///  @param m10                     Real value at the second row and first column in the matrix
+        ///  @param m11                     Real value at the second row and second column in the matrix
+        ///  @param m12                     Real value at the second row and third column in the matrix
+        ///  @param m13                     Real value at the second row and fourth column in the matrix
+        ///  @param m20                     Real value at the third row and first column in the matrix
+        ///  @param m21                     Real value at the third row and second column in the matrix
+        ///  @param m22                     Real value at the third row and third column in the matrix
+        ///  @param m23                     Real value at the third row and fourth column in the matrix
+        ///  @param m30                     Real value at the fourth row and first column in the matrix
+        ///  @param m31                     Real value at the fourth row and second column in the matrix
+        ///  @param m32                     Real value at the fourth row and third column in the matrix
+        ///  @param m33                     Real value at the fourth row and fourth column in the matrix
+        ///
+        Matrix4(Real m00, Real m01, Real m02, Real m03,
+                Real m10, Real m11, Real m12, Real m13,
+                Real m20, Real m21, Real m22, Real m23,
+                Real m30, Real m31, Real m32, Real m33);
 
         ///
         ///  \brief Matrix4 Constructor
@@ -112,11 +112,11 @@ namespace MTF
         Matrix4 operator * (Matrix4);
 
         ///
-        ///  \brief Overload Operator for: Matrix4 * double
+        ///  \brief Overload Operator for: Matrix4 * Real
         ///
-        ///  The result is that each element of the matrix is multiplied by the double value.
+        ///  The result is that each element of the matrix is multiplied by the Real value.
         ///
-        Matrix4 operator * (double);
+        Matrix4 operator * (Real);
 
         ///
         ///  \brief Overload Operator for: Matrix4 * Vector3
@@ -141,11 +141,11 @@ namespace MTF
         Matrix4& operator *= (const Matrix4&);
 
         ///
-        ///  \brief Overload Operator for: Matrix4 *= double
+        ///  \brief Overload Operator for: Matrix4 *= Real
         ///
-        ///  Each element of this Matrix4 will be multiplied by the double value
+        ///  Each element of this Matrix4 will be multiplied by the Real value
         ///
-        Matrix4& operator *= (const double);
+        Matrix4& operator *= (const Real);
 
         ///
         ///  \brief Makes this Matrix4 a scaling matrix
@@ -185,23 +185,23 @@ namespace MTF
         ///
         ///  \brief Makes this Matrix4 a rotation matrix based on the amount of yaw provided
         ///
-        ///  \param yaw                     A double value in radians for the amount of yaw rotation (around the +y axis)
+        ///  \param yaw                     A Real value in radians for the amount of yaw rotation (around the +y axis)
         ///
-        void MakeYawRotationMatrix(double yaw);
+        void MakeYawRotationMatrix(Real yaw);
 
         ///
         ///  \brief Makes this Matrix4 a rotation matrix based on the amount of pitch provided
         ///
-        ///  \param pitch                   A double value in radians for the amount of pitch rotation (around the +x axis)
+        ///  \param pitch                   A Real value in radians for the amount of pitch rotation (around the +x axis)
         ///
-        void MakePitchRotationMatrix(double pitch);
+        void MakePitchRotationMatrix(Real pitch);
 
         ///
         ///  \brief Makes this Matrix4 a rotation matrix based on the amount of roll provided
         ///
-        ///  \param roll                    A double value in radians for the amount of roll rotation (around the +z axis)
+        ///  \param roll                    A Real value in radians for the amount of roll rotation (around the +z axis)
         ///
-        void MakeRollRotationMatrix(double roll);
+        void MakeRollRotationMatrix(Real roll);
 
         ///
         ///  \brief Makes this Matrix4 a view (camera) rotation matrix
@@ -278,6 +278,16 @@ namespace MTF
         ///
         void GetMatrixArray(double (&matArray)[16]);
 
+        ///
+        ///  \brief Provides a single dimension float array representation of the Matrix4.
+        ///
+        ///  The same as the double version, for glLoadMatrixf().  When Real is float (see Real.h)
+        ///  the values are copied without conversion.
+        ///
+        ///  \param matArray                The float array that will be assigned the values of the Matrix4
+        ///
+        void GetMatrixArray(float (&matArray)[16]);
+
         ///
         ///  \brief Provides a human readable string representing the matrix
         ///
@@ -302,9 +312,9 @@ namespace MTF
 
     private:
         ///
-        ///  \brief A multi-dimensional double array containing the data for our matrix
+        ///  \brief A multi-dimensional Real array containing the data for our matrix
         ///
-        double _mat[4][4];
+        Real _mat[4][4];
     };
 
 }
@@ -30,6 +30,8 @@
 #include "Camera.h"
 #include "Head.h"
 #include "Wand.h"
+#include "TrackingSource.h"
+#include "Telemetry.h"
 
 namespace MTF
 {
@@ -57,10 +59,155 @@ namespace MTF
         ///
         ///  \param camera                  Camera object that contains the inital camera to be used in the framework
         ///  \param port                    The port number the ART Tracker is listening on
-        ///  \param smoothing               Number of previous updates to include when average the wand's position and view vectors
+        ///  \param smoothing               Number of previous updates to include when average the wand's position and view vectors, at most RollingAverage::MAX_SAMPLES
         ///
         Monolith(Camera *camera, int port, int smoothing);
 
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object with the given camera object, port number,
+        ///  and filters for the head and the wand.  The filters are run once per tracker
+        ///  update on the tracking thread, so GetHead and GetWand return filtered values
+        ///  at no extra cost.  Smoothing for the wand will be disabled.
+        ///
+        ///  Example, smoothing the wand more than the head and dropping impossible jumps:
+        ///  \code
+        ///  PoseFilterChain headFilter, wandFilter;
+        ///  headFilter.Add(new OneEuroFilter(1.0, 0.5, 1.0));
+        ///  wandFilter.Add(new OutlierRejectionFilter(30.0, 20.0, 0.0, 5)).Add(new OneEuroFilter(0.5, 0.3, 1.0));
+        ///  Monolith monolith(camera, 5000, headFilter, wandFilter);
+        ///  \endcode
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param port                    The port number the ART Tracker is listening on
+        ///  \param headFilter              Filters for the head's position and orientation, copied into the framework
+        ///  \param wandFilter              Filters for the wand's position and orientation, copied into the framework
+        ///
+        Monolith(Camera *camera, int port, PoseFilterChain headFilter, PoseFilterChain wandFilter);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object receiving from several ART Trackers at once,
+        ///  such as two trackers covering the two halves of a large floor.  All of them are
+        ///  received on the one tracking thread.  Each frame received from any tracker is merged
+        ///  with the last frames of the others into one frame, in the coordinates shared by all
+        ///  of them, so the framework sees one tracker.
+        ///
+        ///  The trackers must use the same ids for the same bodies and FlySticks.  When several
+        ///  of them see a body, the one with the best quality is used, and of those the one
+        ///  received last.  Trackers that have sent nothing for 50 ms are left out.
+        ///
+        ///  The frames of the trackers are not interpolated to a common time.  Each tracker's
+        ///  last frame is used as it was received, and the merged frame gets the arrival time
+        ///  of the newest one.  With trackers sending at the same rate, the poses in a merged
+        ///  frame are at most one tracker frame apart.
+        ///
+        ///  \code
+        ///  // The second tracker is set up 20 feet further down the floor
+        ///  Matrix4 offset;
+        ///  offset.MakeTranslationMatrix(Vector3(0.0, 0.0, -20.0));
+        ///
+        ///  std::vector<TrackingSource> sources;
+        ///  sources.push_back(TrackingSource(5000));
+        ///  sources.push_back(TrackingSource("239.0.0.1", 5001, offset));
+        ///  Monolith monolith(camera, sources);
+        ///  \endcode
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param sources                 The trackers to receive from, at least one
+        ///
+        Monolith(Camera *camera, std::vector<TrackingSource> sources);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object receiving from several ART Trackers at once,
+        ///  with filters for the head and the wand.  See the constructors above.
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param sources                 The trackers to receive from, at least one
+        ///  \param headFilter              Filters for the head's position and orientation, copied into the framework
+        ///  \param wandFilter              Filters for the wand's position and orientation, copied into the framework
+        ///
+        Monolith(Camera *camera, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object receiving from the given ART Trackers, that also
+        ///  shares every frame with other processes on this computer.  The frames are written
+        ///  into shared memory with the given name, where any number of processes can read them
+        ///  with the Monolith(Camera*, std::string) constructor.  This lets several render
+        ///  processes use one tracker port.
+        ///
+        ///  \code
+        ///  // The process receiving from the tracker
+        ///  Monolith monolith(camera, std::vector<TrackingSource>(1, TrackingSource(5000)), PoseFilterChain(), PoseFilterChain(), "MonolithTracking");
+        ///
+        ///  // Every other process
+        ///  Monolith monolith(camera, "MonolithTracking");
+        ///  \endcode
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param sources                 The trackers to receive from, at least one
+        ///  \param headFilter              Filters for the head's position and orientation, copied into the framework
+        ///  \param wandFilter              Filters for the wand's position and orientation, copied into the framework
+        ///  \param sharedMemoryName        Name of the shared memory to create, removed again when this Monolith is deleted
+        ///
+        Monolith(Camera *camera, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object that reads the frames another process on this
+        ///  computer receives from the tracker and shares under the given name, without opening
+        ///  a network socket.  GetHead, GetWand and the other getters read the shared frame in
+        ///  place, so they see a new frame as soon as the other process has written it.
+        ///  WaitForNextFrame, subscribers and wand events follow within a fraction of a millisecond.
+        ///
+        ///  The users, filters and prediction mode are those of the sharing process.  SetUser,
+        ///  SetPredictionMode and SetProcessAllFrames have no effect here.
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param sharedMemoryName        Name the other process shares its frames under
+        ///
+        Monolith(Camera *camera, std::string sharedMemoryName);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object that replays a capture written by StartCapture,
+        ///  instead of receiving from the ART Tracker.  The packets go through the same steps as
+        ///  received ones, with their arrival times moved to the start of the replay.  Once the
+        ///  capture is done no more frames arrive.
+        ///
+        ///  Replaying AS_FAST_AS_POSSIBLE shows how many frames per second the framework can
+        ///  process, and gives the same frames on every run.
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param captureFile             Name of the file written by StartCapture
+        ///  \param timing                  Whether to keep the time between the packets
+        ///
+        Monolith(Camera *camera, std::string captureFile, PacketReplay::TIMING timing);
+
+        ///
+        ///  \brief Monolith Constructor
+        ///
+        ///  This will create a Monolith object that replays a capture written by StartCapture,
+        ///  with the calibrations of the sources it was recorded from and filters for the head
+        ///  and the wand.  The ports of the sources are not used.
+        ///
+        ///  \param camera                  Camera object that contains the inital camera to be used in the framework
+        ///  \param captureFile             Name of the file written by StartCapture
+        ///  \param timing                  Whether to keep the time between the packets
+        ///  \param sources                 The trackers the capture was recorded from, in the same order
+        ///  \param headFilter              Filters for the head's position and orientation, copied into the framework
+        ///  \param wandFilter              Filters for the wand's position and orientation, copied into the framework
+        ///
+        Monolith(Camera *camera, std::string captureFile, PacketReplay::TIMING timing, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter);
+
         ///
         ///  \brief Monolith Deconstructor
         ///
@@ -80,6 +227,319 @@ namespace MTF
         ///
         Wand GetWand();
 
+        ///
+        ///  \brief Binds a user to a standard body for the head and a FlyStick for the wand
+        ///
+        ///  Each user gets its own Head and Wand, run through the filters and smoothing the
+        ///  Monolith was created with, all on the one tracking thread.  User 0 is bound to body 0
+        ///  and FlyStick 0 from the start and is the one returned by GetHead and GetWand.  Binding
+        ///  a user with a higher number adds users up to it.
+        ///
+        ///  \code
+        ///  // Four people in front of the wall, the last one without a FlyStick
+        ///  monolith->SetUser(0, 0, 0);
+        ///  monolith->SetUser(1, 1, 1);
+        ///  monolith->SetUser(2, 2, 2);
+        ///  monolith->SetUser(3, 3, -1);
+        ///  \endcode
+        ///
+        ///  \param user                    Number of the user, from 0 to TrackingFrame::MAX_USERS - 1
+        ///  \param headBodyId              DTrack ID of the standard body worn on the head, -1 for none
+        ///  \param wandFlyStickId          DTrack ID of the FlyStick held, -1 for none
+        ///
+        void SetUser(int user, int headBodyId, int wandFlyStickId);
+
+        ///
+        ///  \brief Returns the number of users
+        ///
+        ///  \return                        The number of users, at least 1
+        ///
+        int GetNumUsers();
+
+        ///
+        ///  \brief Retrieve a copy of the Head of a user
+        ///
+        ///  \param user                    Number of the user, as given to SetUser
+        ///  \return                        A copy of the user's Head, not tracked if there is no such user
+        ///
+        Head GetUserHead(int user);
+
+        ///
+        ///  \brief Retrieve a copy of the Wand of a user
+        ///
+        ///  \param user                    Number of the user, as given to SetUser
+        ///  \return                        A copy of the user's Wand, not tracked if there is no such user
+        ///
+        Wand GetUserWand(int user);
+
+        ///
+        ///  \brief Returns the number of standard bodies the ART Tracker is sending
+        ///
+        ///  \return                        One more than the highest body ID seen, at most TrackingFrame::MAX_BODIES
+        ///
+        int GetNumBodies();
+
+        ///
+        ///  \brief Retrieve a standard body by its DTrack ID, as received
+        ///
+        ///  Bodies retrieved this way are not filtered and not bound to any user.
+        ///
+        ///  \param id                      DTrack ID of the body
+        ///  \return                        The body as a Head, not tracked if the ID is unknown
+        ///
+        Head GetBody(int id);
+
+        ///
+        ///  \brief Returns the number of FlySticks the ART Tracker is sending
+        ///
+        ///  \return                        The number of FlySticks, at most TrackingFrame::MAX_FLYSTICKS
+        ///
+        int GetNumFlySticks();
+
+        ///
+        ///  \brief Retrieve a FlyStick by its DTrack ID, as received
+        ///
+        ///  FlySticks retrieved this way are not filtered or smoothed and not bound to any user.
+        ///
+        ///  \param id                      DTrack ID of the FlyStick
+        ///  \return                        The FlyStick as a Wand, not tracked if the ID is unknown
+        ///
+        Wand GetFlyStick(int id);
+
+        ///
+        ///  \brief Copies the whole last frame: all users, bodies and FlySticks at once
+        ///
+        ///  Use this when several bodies are needed, so they all come from the same frame.
+        ///
+        ///  \param frame                   Assigned the last frame published by the tracking thread
+        ///
+        void GetFrame(TrackingFrame &frame);
+
+        ///
+        ///  \brief Retrieve a copy of the current Head object, extrapolated to a target time
+        ///
+        ///  Use this to render with the head pose expected when the frame is shown,
+        ///  for example GetHead(udp_get_time_ns() + 40000000) for 40 ms of latency.
+        ///  The result can be passed to the Camera like any other Head.  See Head::Predict.
+        ///
+        ///  \param targetTimeNs            Target time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of the current Head object, moved on to the target time
+        ///
+        Head GetHead(long long targetTimeNs);
+
+        ///
+        ///  \brief Retrieve a copy of the current Wand object, extrapolated to a target time
+        ///
+        ///  \param targetTimeNs            Target time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of the current Wand object, moved on to the target time
+        ///
+        Wand GetWand(long long targetTimeNs);
+
+        ///
+        ///  \brief Retrieve the Head at a given time, interpolated from the recent tracker frames
+        ///
+        ///  The framework keeps about the last two seconds of frames.  For a time between two
+        ///  frames, the position is interpolated linearly and the orientation by slerp, so a
+        ///  renderer running faster than the tracker sees smooth motion instead of steps.
+        ///  For a time after the newest frame the Head is extrapolated as by GetHead(targetTimeNs),
+        ///  and for a time before the oldest frame kept the oldest Head is returned.
+        ///
+        ///  \param timeNs                  Time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of the Head at the given time
+        ///
+        Head GetHeadAt(long long timeNs);
+
+        ///
+        ///  \brief Retrieve the Wand at a given time, interpolated from the recent tracker frames
+        ///
+        ///  Works as GetHeadAt.  Buttons and joystick are those of the frame before the given time.
+        ///
+        ///  \param timeNs                  Time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of the Wand at the given time
+        ///
+        Wand GetWandAt(long long timeNs);
+
+        ///
+        ///  \brief Returns the number of tracker frames received so far
+        ///
+        ///  Compare with Head::GetFrameNumber or Wand::GetFrameNumber to tell whether a
+        ///  retrieved Head or Wand is stale.
+        ///
+        ///  \return                        The number of the newest frame, 0 if no frame has been received yet
+        ///
+        unsigned long GetFrameNumber();
+
+        ///
+        ///  \brief Sleeps until the tracker sends a new frame
+        ///
+        ///  Use this in a render or idle loop instead of polling GetHead or GetWand, so the
+        ///  loop only runs when there is new tracking data and leaves the processor free
+        ///  otherwise.  A frame counts as new if it arrives after this method is called.
+        ///
+        ///  \param timeoutMs               Longest time to wait in milliseconds
+        ///  \return                        True if a new frame arrived, false if the wait timed out or tracking was shut down
+        ///
+        bool WaitForNextFrame(int timeoutMs);
+
+        ///
+        ///  \brief Sleeps until the tracker has sent a frame newer than the given one
+        ///
+        ///  Returns at once if such a frame has already arrived, so no frame is missed
+        ///  between retrieving a Head and calling this method.
+        ///
+        ///  \param lastFrameNumber         Number of the last frame seen, for example from Head::GetFrameNumber
+        ///  \param timeoutMs               Longest time to wait in milliseconds
+        ///  \return                        True if a newer frame is available, false if the wait timed out or tracking was shut down
+        ///
+        bool WaitForNextFrame(unsigned long lastFrameNumber, int timeoutMs);
+
+        ///
+        ///  \brief Registers a function to be called with every frame received from the tracker
+        ///
+        ///  Instead of polling GetHead and GetWand, a subscriber is handed each new frame as
+        ///  soon as it is published, and sees every frame.  A Head or Wand can be created from
+        ///  the frame with Head(frame.heads[0]) or Wand(frame.wands[0]).
+        ///
+        ///  Subscribers on Subscription::TRACKING_THREAD are called on the tracking thread and
+        ///  delay the reception of the next frame while they run, so they must be quick and must
+        ///  not wait on the render thread.  Subscribers on Subscription::DISPATCHER_THREAD are
+        ///  called on one shared thread; if they fall more than about two seconds behind they
+        ///  skip the frames in between.  Subscribers must not throw exceptions.
+        ///
+        ///  \code
+        ///  void OnFrame(const TrackingFrame &frame);
+        ///  int id = monolith->Subscribe(OnFrame, Subscription::DISPATCHER_THREAD);
+        ///  \endcode
+        ///
+        ///  \param callback                Function taking a const TrackingFrame&, for example from boost::bind
+        ///  \param thread                  Which thread calls the function
+        ///  \return                        Id of the subscription, for Unsubscribe
+        ///
+        int Subscribe(FrameCallback callback, Subscription::THREAD thread);
+
+        ///
+        ///  \brief Removes a subscription
+        ///
+        ///  When this returns, the function is no longer being called and won't be called again,
+        ///  unless this is called from inside a subscriber, in which case the frame being
+        ///  delivered is completed first.
+        ///
+        ///  \param id                      Id returned by Subscribe
+        ///
+        void Unsubscribe(int id);
+
+        ///
+        ///  \brief Takes the oldest button or joystick change of the Wand off the queue
+        ///
+        ///  The tracking thread queues an event for every button press and release and every
+        ///  joystick movement, so no input is missed between two calls, however short.  Empty
+        ///  the queue once per frame, from one thread only:
+        ///  \code
+        ///  WandEvent event;
+        ///  while (monolith->PollWandEvent(event))
+        ///  {
+        ///      if (event.type == WandEvent::BUTTON_PRESSED && event.button == 0)
+        ///          ...
+        ///  }
+        ///  \endcode
+        ///  When nothing changed this costs no more than checking that the queue is empty.
+        ///
+        ///  \param event                   Assigned the oldest event
+        ///  \return                        False if there are no events
+        ///
+        bool PollWandEvent(WandEvent &event);
+
+        ///
+        ///  \brief Returns how many Wand events were dropped because the queue was full
+        ///
+        ///  The queue holds 1024 events, many seconds of input, so this stays 0 as long as
+        ///  PollWandEvent empties the queue regularly.
+        ///
+        ///  \return                        Number of events dropped since the framework started
+        ///
+        unsigned long GetDroppedWandEventCount();
+
+        ///
+        ///  \brief Starts recording every packet received from the ART Tracker into a file
+        ///
+        ///  The packets are recorded raw, with their arrival times, before they are processed.
+        ///  Replaying the file with the replay constructor then reproduces the session exactly.
+        ///  A capture already running is closed first.
+        ///
+        ///  \param filename                Name of the file to write, replaced if it exists
+        ///  \return                        False if the file could not be created
+        ///
+        bool StartCapture(std::string filename);
+
+        ///
+        ///  \brief Stops recording and closes the file
+        ///
+        void StopCapture();
+
+        ///
+        ///  \brief Sets how the velocities of the head and wand are estimated for prediction
+        ///
+        ///  The default is PosePredictor::CONSTANT_VELOCITY.  PosePredictor::KALMAN gives
+        ///  steadier predictions for a small amount of lag.  The change takes effect with the next tracker update.
+        ///
+        ///  \param mode                    How velocities are estimated
+        ///
+        void SetPredictionMode(PosePredictor::MODE mode);
+
+        ///
+        ///  \brief Sets whether every frame from the ART Tracker is processed, or only the newest
+        ///
+        ///  By default, when the tracking thread falls behind, the frames that queued up are
+        ///  skipped for the newest one.  With all frames processed, every frame goes through
+        ///  the filters and prediction in order and is published, so subscribers, the history
+        ///  and the Wand events see the full frame rate and even time steps.  That costs more
+        ///  time per frame while catching up.  The change takes effect with the next tracker update.
+        ///
+        ///  \param all                     True to process every frame, false for only the newest
+        ///
+        void SetProcessAllFrames(bool all);
+
+        ///
+        ///  \brief Returns how many frames from the ART Tracker were skipped for a newer one
+        ///
+        ///  This grows whenever the tracking thread falls behind while only the newest frame is
+        ///  processed, see SetProcessAllFrames.
+        ///
+        ///  \return                        Number of frames skipped since the framework started
+        ///
+        unsigned long GetCoalescedFrameCount();
+
+        ///
+        ///  \brief Retrieve how well the frames from the ART Tracker arrive and how long they take
+        ///
+        ///  The snapshot has the packets and frames received, frame counters missing in between,
+        ///  packets that could not be parsed by line type, timeouts, the jitter of the arrival
+        ///  times and histograms of the time between frames and of the time to parse and publish
+        ///  them.  The tracking thread keeps these counts without locking, so this is cheap enough
+        ///  to call every frame.
+        ///
+        ///  \param telemetry               Assigned the counts since the framework started
+        ///
+        void GetTelemetry(Telemetry &telemetry);
+
+        ///
+        ///  \brief Starts writing a telemetry snapshot to a file at regular intervals
+        ///
+        ///  Each snapshot is written as one line of JSON, see Telemetry::ToJson, from a thread of
+        ///  its own.  A last line is written when the dump is stopped.  A dump already running
+        ///  is stopped first.
+        ///
+        ///  \param filename                Name of the file to write, replaced if it exists
+        ///  \param intervalMs              Time between the snapshots in milliseconds
+        ///  \return                        False if the file could not be created
+        ///
+        bool StartTelemetryDump(std::string filename, int intervalMs);
+
+        ///
+        ///  \brief Stops writing telemetry snapshots and closes the file
+        ///
+        void StopTelemetryDump();
+
         ///
         ///  \brief Retrieve the Camera object
         ///
@@ -0,0 +1,113 @@
+#ifndef _PACKETCAPTURE_H
+#define _PACKETCAPTURE_H
+///
+///  \file PacketCapture.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::PacketCapture PacketCapture.h "PacketCapture.h"
+///  \brief This class records the raw packets received from the ART Tracker into a file.
+///
+///  A capture keeps every UDP packet exactly as it arrived, with its arrival time and the
+///  number of the TrackingSource it came from, so a session can be replayed later with
+///  PacketReplay.  Records are appended as the packets arrive; an index of all records
+///  is written when the capture is closed.  A capture that was not closed, because the
+///  application crashed, can still be replayed, it is only slower to open.
+///
+///  The file is laid out as follows, in the byte order of the computer that wrote it:
+///  - Header: the 8 characters "MTFPCAP1", the format version and the header size (32 bit each)
+///  - One record per packet: CaptureRecord, then the packet data, padded with zeros to a multiple of 8 bytes
+///  - Index: the file offset of every record (64 bit each)
+///  - Trailer: CaptureTrailer
+///
+///  Packets are written from the tracking thread, buffered, so capturing costs little more
+///  than a memory copy per packet.
+///
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace MTF
+{
+
+    ///
+    ///  \brief Placed in front of the data of every packet in a capture file
+    ///
+    struct CaptureRecord
+    {
+        boost::int64_t receiveTimeNs;       ///< Arrival time of the packet in nanoseconds since 1970
+        boost::uint32_t source;             ///< Number of the TrackingSource the packet came from
+        boost::uint32_t length;             ///< Length of the packet data in bytes, without padding
+    };
+
+    ///
+    ///  \brief Ends a capture file that was closed properly
+    ///
+    struct CaptureTrailer
+    {
+        boost::uint64_t indexOffset;        ///< File offset of the index
+        boost::uint64_t count;              ///< Number of records in the index
+        char magic[8];                      ///< The 8 characters "MTFPIDX1"
+    };
+
+    class PacketCapture
+    {
+
+    public:
+        ///
+        ///  \brief PacketCapture Constructor
+        ///
+        ///  Creates the file, replacing any file with the same name.  Check IsValid before using it.
+        ///
+        ///  \param filename                Name of the file to write
+        ///
+        PacketCapture(std::string filename);
+
+        ///
+        ///  \brief PacketCapture Deconstructor
+        ///
+        ///  Writes the index and closes the file.
+        ///
+        ~PacketCapture();
+
+        ///
+        ///  \brief Returns whether the file could be created and all writes so far succeeded
+        ///
+        bool IsValid();
+
+        ///
+        ///  \brief Appends a packet to the file
+        ///
+        ///  \param source                  Number of the TrackingSource the packet came from
+        ///  \param data                    Packet data
+        ///  \param length                  Length of the packet data in bytes
+        ///  \param receiveTimeNs           Arrival time of the packet in nanoseconds since 1970
+        ///
+        void Write(int source, const char *data, int length, long long receiveTimeNs);
+
+        ///
+        ///  \brief Returns the number of packets written so far
+        ///
+        int GetNumPackets();
+
+        static const char MAGIC[8];         ///< First 8 characters of a capture file
+        static const char INDEX_MAGIC[8];   ///< Last 8 characters of a capture file that was closed
+        static const boost::uint32_t VERSION = 1;
+
+    private:
+        FILE *_file;
+        bool _valid;
+        boost::uint64_t _offset;
+        std::vector<boost::uint64_t> _index;
+
+        // Not copyable, the file is owned
+        PacketCapture(const PacketCapture&);
+        PacketCapture& operator = (const PacketCapture&);
+    };
+
+}
+
+#endif
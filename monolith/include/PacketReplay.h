@@ -0,0 +1,107 @@
+#ifndef _PACKETREPLAY_H
+#define _PACKETREPLAY_H
+///
+///  \file PacketReplay.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::PacketReplay PacketReplay.h "PacketReplay.h"
+///  \brief This class reads the packets recorded by PacketCapture.
+///
+///  The file is mapped into memory and the packets are read in place, so going through
+///  a capture costs no file reads or copies.  Monolith can replay a capture instead of
+///  receiving from the ART Tracker, to reproduce a session or to measure how fast frames
+///  are processed (see Monolith::Monolith).
+///
+
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "PacketCapture.h"
+
+namespace MTF
+{
+
+    class PacketReplay
+    {
+
+    public:
+        ///
+        ///  \brief How fast a capture is replayed
+        ///
+        enum TIMING
+        {
+            ORIGINAL_TIMING,                ///< Each packet at the time it arrived, relative to the first one
+            AS_FAST_AS_POSSIBLE             ///< Each packet as soon as the one before has been processed
+        };
+
+        ///
+        ///  \brief PacketReplay Constructor
+        ///
+        ///  Maps the capture file into memory.  Check IsValid before using it.
+        ///
+        ///  \param filename                Name of a file written by PacketCapture
+        ///
+        PacketReplay(std::string filename);
+
+        ///
+        ///  \brief PacketReplay Deconstructor
+        ///
+        ~PacketReplay();
+
+        ///
+        ///  \brief Returns whether the file could be mapped and is a capture file
+        ///
+        bool IsValid();
+
+        ///
+        ///  \brief Returns the number of packets in the capture
+        ///
+        int GetNumPackets();
+
+        ///
+        ///  \brief Returns the number of sources the packets came from
+        ///
+        ///  \return                        One more than the highest source number of any packet
+        ///
+        int GetNumSources();
+
+        ///
+        ///  \brief Returns one packet of the capture
+        ///
+        ///  \param index                   Number of the packet, from 0 to GetNumPackets() - 1
+        ///  \param source                  Assigned the number of the TrackingSource the packet came from
+        ///  \param data                    Assigned the packet data, in the mapped file and valid as long as this PacketReplay
+        ///  \param length                  Assigned the length of the packet data in bytes
+        ///  \param receiveTimeNs           Assigned the arrival time of the packet in nanoseconds since 1970
+        ///  \return                        False if there is no such packet
+        ///
+        bool GetPacket(int index, int &source, const char *&data, int &length, long long &receiveTimeNs);
+
+    private:
+        bool ReadIndex();
+        void SearchRecords();
+
+        boost::interprocess::file_mapping _file;
+        boost::interprocess::mapped_region _region;
+        const char *_data;
+        boost::uint64_t _size;
+
+        // Points into the file if it was closed properly, otherwise to _searchedIndex
+        const boost::uint64_t *_index;
+        boost::uint64_t _count;
+        std::vector<boost::uint64_t> _searchedIndex;
+
+        int _numSources;
+
+        // Not copyable, the mapping is owned
+        PacketReplay(const PacketReplay&);
+        PacketReplay& operator = (const PacketReplay&);
+    };
+
+}
+
+#endif
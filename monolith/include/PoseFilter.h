@@ -0,0 +1,262 @@
+#ifndef _POSEFILTER_H
+#define _POSEFILTER_H
+///
+///  \file PoseFilter.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::PoseFilter PoseFilter.h "PoseFilter.h"
+///  \brief This class contains the interface for filters that smooth or reject tracking samples.
+///
+///  Filters are combined in a PoseFilterChain, one chain per tracked body.  The chain
+///  is run once per tracker frame on the tracking thread, so reading the Head or Wand
+///  costs nothing extra.  Positions are filtered as vectors and orientations as unit
+///  quaternions, so the filtered view, right and up vectors stay orthonormal.
+///
+///  Filters available:
+///  - OutlierRejectionFilter drops samples with low quality or impossible jumps
+///  - ExponentialFilter blends each sample with the previous result
+///  - OneEuroFilter is a low-pass filter that smooths a lot when the body is still
+///    and little when it moves fast, so it removes jitter without adding much lag
+///
+
+#include <vector>
+
+#include "Vector3.h"
+#include "Quaternion.h"
+
+namespace MTF
+{
+
+    ///
+    ///  \brief One tracking sample as seen by a PoseFilter
+    ///
+    struct PoseSample
+    {
+        Vector3 position;                   ///< Position in feet
+        Quaternion orientation;             ///< Orientation of the body
+        Real quality;                       ///< Tracking quality reported by the ART Tracker (0 to 1)
+        double time;                        ///< Time of the sample in seconds
+    };
+
+
+    class PoseFilter
+    {
+
+    public:
+        ///
+        ///  \brief PoseFilter Deconstructor
+        ///
+        virtual ~PoseFilter();
+
+        ///
+        ///  \brief Pure virtual method for filtering a sample
+        ///
+        ///  \param sample                  The new sample, replaced by the filtered sample
+        ///  \return                        False if the sample should be dropped, in which case the body keeps its previous pose
+        ///
+        virtual bool Apply(PoseSample &sample)=0;
+
+        ///
+        ///  \brief Pure virtual method for forgetting all previous samples
+        ///
+        ///  This is called when the body is lost by the tracker, so that a body that is
+        ///  found again does not get blended with where it was before.
+        ///
+        virtual void Reset()=0;
+
+        ///
+        ///  \brief Pure virtual method for creating a copy of this filter
+        ///
+        ///  \return                        A new filter of the same type and parameters, owned by the caller
+        ///
+        virtual PoseFilter* Clone()=0;
+
+    protected:
+        ///
+        ///  \brief Returns the time since the previous sample, or a typical frame time for the first one
+        ///
+        static Real GetTimeStep(double previous, double current);
+    };
+
+
+    ///
+    ///  \class MTF::OutlierRejectionFilter PoseFilter.h "PoseFilter.h"
+    ///  \brief Drops samples with low quality or jumps that are too fast to be real.
+    ///
+    class OutlierRejectionFilter : public PoseFilter
+    {
+
+    public:
+        ///
+        ///  \brief OutlierRejectionFilter Constructor
+        ///
+        ///  \param maxSpeed                Largest believable speed in feet per second
+        ///  \param maxAngularSpeed         Largest believable angular speed in radians per second
+        ///  \param minQuality              Samples with a quality below this are dropped
+        ///  \param maxRejected             After this many dropped samples in a row the next one is accepted again, so a body that really moved is not lost forever
+        ///
+        OutlierRejectionFilter(Real maxSpeed, Real maxAngularSpeed, Real minQuality, int maxRejected);
+
+        bool Apply(PoseSample &sample);
+        void Reset();
+        PoseFilter* Clone();
+
+    private:
+        Real _maxSpeed;
+        Real _maxAngularSpeed;
+        Real _minQuality;
+        int _maxRejected;
+
+        bool _initialized;
+        int _rejected;
+        PoseSample _last;
+    };
+
+
+    ///
+    ///  \class MTF::ExponentialFilter PoseFilter.h "PoseFilter.h"
+    ///  \brief Blends each sample with the previous result.
+    ///
+    ///  The blend factor is scaled by the sample's quality, so low quality samples move the pose less.
+    ///
+    class ExponentialFilter : public PoseFilter
+    {
+
+    public:
+        ///
+        ///  \brief ExponentialFilter Constructor
+        ///
+        ///  \param positionAlpha           Weight of a new position, from 0 (never moves) to 1 (no filtering)
+        ///  \param orientationAlpha        Weight of a new orientation, from 0 (never turns) to 1 (no filtering)
+        ///
+        ExponentialFilter(Real positionAlpha, Real orientationAlpha);
+
+        bool Apply(PoseSample &sample);
+        void Reset();
+        PoseFilter* Clone();
+
+    private:
+        Real _positionAlpha;
+        Real _orientationAlpha;
+
+        bool _initialized;
+        PoseSample _last;
+    };
+
+
+    ///
+    ///  \class MTF::OneEuroFilter PoseFilter.h "PoseFilter.h"
+    ///  \brief Adaptive low-pass filter (the "1 Euro filter" by Casiez, Roussel and Vogel).
+    ///
+    ///  The cutoff frequency rises with the speed of the body: minCutoff + beta * speed.
+    ///  Lower minCutoff removes more jitter when still, higher beta removes more lag when moving.
+    ///
+    class OneEuroFilter : public PoseFilter
+    {
+
+    public:
+        ///
+        ///  \brief OneEuroFilter Constructor
+        ///
+        ///  Uses the same parameters for position and orientation.
+        ///
+        ///  \param minCutoff               Cutoff frequency in Hz when the body is still
+        ///  \param beta                    Increase of the cutoff frequency per unit of speed (feet or radians per second)
+        ///  \param derivativeCutoff        Cutoff frequency in Hz used to smooth the speed estimate
+        ///
+        OneEuroFilter(Real minCutoff, Real beta, Real derivativeCutoff);
+
+        ///
+        ///  \brief OneEuroFilter Constructor
+        ///
+        ///  \param minCutoff               Cutoff frequency in Hz for the position when the body is still
+        ///  \param beta                    Increase of the position cutoff frequency per foot per second
+        ///  \param orientationMinCutoff    Cutoff frequency in Hz for the orientation when the body is still
+        ///  \param orientationBeta         Increase of the orientation cutoff frequency per radian per second
+        ///  \param derivativeCutoff        Cutoff frequency in Hz used to smooth the speed estimates
+        ///
+        OneEuroFilter(Real minCutoff, Real beta, Real orientationMinCutoff, Real orientationBeta, Real derivativeCutoff);
+
+        bool Apply(PoseSample &sample);
+        void Reset();
+        PoseFilter* Clone();
+
+    private:
+        static Real GetAlpha(Real cutoff, Real timeStep);
+
+        Real _minCutoff;
+        Real _beta;
+        Real _orientationMinCutoff;
+        Real _orientationBeta;
+        Real _derivativeCutoff;
+
+        bool _initialized;
+        PoseSample _last;
+        Real _speed;
+        Real _angularSpeed;
+    };
+
+
+    ///
+    ///  \class MTF::PoseFilterChain PoseFilter.h "PoseFilter.h"
+    ///  \brief Runs a list of filters one after another.
+    ///
+    ///  The chain owns its filters.  Copying a chain copies its filters, so one chain
+    ///  can be used to set up both the Head and the Wand.
+    ///
+    class PoseFilterChain
+    {
+
+    public:
+        ///
+        ///  \brief PoseFilterChain Constructor
+        ///
+        ///  Creates an empty chain, which leaves samples unchanged.
+        ///
+        PoseFilterChain();
+
+        PoseFilterChain(const PoseFilterChain &chain);
+
+        PoseFilterChain& operator = (const PoseFilterChain &chain);
+
+        ///
+        ///  \brief PoseFilterChain Deconstructor, deletes all filters in the chain
+        ///
+        ~PoseFilterChain();
+
+        ///
+        ///  \brief Appends a filter to the end of the chain
+        ///
+        ///  \param filter                  Filter created with new, the chain takes ownership of it
+        ///  \return                        This chain, so calls can be strung together
+        ///
+        PoseFilterChain& Add(PoseFilter *filter);
+
+        ///
+        ///  \brief Runs the sample through all filters in order
+        ///
+        ///  \param sample                  The new sample, replaced by the filtered sample
+        ///  \return                        False if one of the filters dropped the sample
+        ///
+        bool Apply(PoseSample &sample);
+
+        ///
+        ///  \brief Resets all filters in the chain
+        ///
+        void Reset();
+
+        ///
+        ///  \brief Returns whether the chain has no filters
+        ///
+        bool IsEmpty();
+
+    private:
+        void Clear();
+
+        std::vector<PoseFilter*> _filters;
+    };
+
+}
+
+#endif
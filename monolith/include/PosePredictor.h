@@ -0,0 +1,186 @@
+#ifndef _POSEPREDICTOR_H
+#define _POSEPREDICTOR_H
+///
+///  \file PosePredictor.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::PosePredictor PosePredictor.h "PosePredictor.h"
+///  \brief This class estimates the linear and angular velocity of a tracked body.
+///
+///  A PosePredictor is fed every pose of a body on the tracking thread.  The
+///  velocities it estimates are published with the Head and Wand, which use them
+///  to extrapolate their pose to a later time (see Head::Predict and Wand::Predict).
+///  This hides part of the delay between the tracker measuring a pose and the
+///  frame showing up on the screen.
+///
+///  Two modes are offered:
+///  - CONSTANT_VELOCITY takes the difference between the last two poses.  It is
+///    cheap and has no lag, but passes all the jitter of the tracker on.
+///  - KALMAN runs a constant velocity Kalman filter on each axis of the position
+///    and of the orientation.  The velocities are smooth, at the cost of a little
+///    lag when the body changes speed.
+///
+
+#include "Vector3.h"
+#include "Quaternion.h"
+
+namespace MTF
+{
+
+    class PosePredictor
+    {
+
+    public:
+        ///
+        ///  \brief How velocities are estimated
+        ///
+        enum MODE
+        {
+            NONE,                           ///< No velocities are estimated, predicted poses equal the last pose
+            CONSTANT_VELOCITY,              ///< Difference between the last two poses
+            KALMAN                          ///< Constant velocity Kalman filter
+        };
+
+        ///
+        ///  \brief The furthest a pose is extrapolated, in seconds
+        ///
+        ///  Keeps a body from flying away when the tracker stops sending data.
+        ///
+        static const Real MAX_PREDICTION;
+
+        ///
+        ///  \brief PosePredictor Constructor
+        ///
+        ///  Creates a predictor in CONSTANT_VELOCITY mode.
+        ///
+        PosePredictor();
+
+        ///
+        ///  \brief PosePredictor Constructor
+        ///
+        ///  Creates a predictor in the given mode, with Kalman noise values that suit
+        ///  a head or hand held device tracked to about a millimeter.
+        ///
+        ///  \param mode                    How velocities are estimated
+        ///
+        PosePredictor(MODE mode);
+
+        ///
+        ///  \brief PosePredictor Constructor
+        ///
+        ///  \param mode                    How velocities are estimated
+        ///  \param acceleration            Typical acceleration of the body in feet per second squared (Kalman process noise)
+        ///  \param positionNoise           Typical error of a tracked position in feet (Kalman measurement noise)
+        ///  \param angularAcceleration     Typical angular acceleration of the body in radians per second squared
+        ///  \param orientationNoise        Typical error of a tracked orientation in radians
+        ///
+        PosePredictor(MODE mode, Real acceleration, Real positionNoise, Real angularAcceleration, Real orientationNoise);
+
+        ///
+        ///  \brief PosePredictor Deconstructor
+        ///
+        ~PosePredictor();
+
+        ///
+        ///  \brief Adds the newest pose of the body
+        ///
+        ///  \param position                Position of the body in feet
+        ///  \param orientation             Orientation of the body
+        ///  \param time                    Time of the pose in seconds
+        ///
+        void Update(Vector3 position, Quaternion orientation, double time);
+
+        ///
+        ///  \brief Forgets all previous poses, used when the body is lost
+        ///
+        void Reset();
+
+        ///
+        ///  \brief Returns the mode of this predictor
+        ///
+        MODE GetMode();
+
+        ///
+        ///  \brief Changes the mode of this predictor, forgetting all previous poses
+        ///
+        void SetMode(MODE mode);
+
+        ///
+        ///  \brief Returns the estimated linear velocity
+        ///
+        ///  \return                        Vector3 containing the velocity in feet per second
+        ///
+        Vector3 GetVelocity();
+
+        ///
+        ///  \brief Returns the estimated angular velocity
+        ///
+        ///  \return                        Vector3 containing the axis of rotation (in tracker coordinates) scaled by the speed in radians per second
+        ///
+        Vector3 GetAngularVelocity();
+
+        ///
+        ///  \brief Extrapolates a position with a constant velocity
+        ///
+        ///  \param position                The last known position
+        ///  \param velocity                Velocity in feet per second
+        ///  \param seconds                 Time to extrapolate, limited to MAX_PREDICTION
+        ///  \return                        The extrapolated position
+        ///
+        static Vector3 Extrapolate(Vector3 position, Vector3 velocity, Real seconds);
+
+        ///
+        ///  \brief Returns the rotation made with a constant angular velocity
+        ///
+        ///  Multiplying an orientation, or a view, up or right vector, by the returned
+        ///  Quaternion extrapolates it.
+        ///
+        ///  \param angularVelocity         Angular velocity as returned by GetAngularVelocity
+        ///  \param seconds                 Time to extrapolate, limited to MAX_PREDICTION
+        ///  \return                        The rotation over the given time
+        ///
+        static Quaternion GetRotation(Vector3 angularVelocity, Real seconds);
+
+    private:
+        static const Real DEFAULT_ACCELERATION;
+        static const Real DEFAULT_POSITION_NOISE;
+        static const Real DEFAULT_ANGULAR_ACCELERATION;
+        static const Real DEFAULT_ORIENTATION_NOISE;
+
+        void Initialize(MODE mode, Real acceleration, Real positionNoise, Real angularAcceleration, Real orientationNoise);
+
+        // Constant velocity Kalman filter for one axis, with the state (value, rate)
+        struct KalmanAxis
+        {
+            Real value;
+            Real rate;
+            Real p00, p01, p10, p11;
+        };
+
+        static void KalmanInit(KalmanAxis &axis, Real value, Real measurementVariance);
+        static void KalmanPredict(KalmanAxis &axis, Real dt, Real processVariance);
+        static void KalmanCorrect(KalmanAxis &axis, Real measured, Real measurementVariance);
+
+        MODE _mode;
+
+        Real _accelerationVariance;
+        Real _positionVariance;
+        Real _angularAccelerationVariance;
+        Real _orientationVariance;
+
+        bool _initialized;
+        double _time;
+        Vector3 _position;
+        Quaternion _orientation;
+
+        Vector3 _velocity;
+        Vector3 _angularVelocity;
+
+        KalmanAxis _positionAxes[3];
+        KalmanAxis _orientationAxes[3];
+    };
+
+}
+
+#endif
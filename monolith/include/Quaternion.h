@@ -0,0 +1,215 @@
+#ifndef _QUATERNION_H
+#define _QUATERNION_H
+///
+///  \file Quaternion.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::Quaternion Quaternion.h "Quaternion.h"
+///  \brief This class provides for a unit quaternion representing an orientation.
+///
+///  Orientations of tracking devices are stored as view, right, and up vectors in
+///  the framework.  Those vectors cannot be averaged or interpolated directly without
+///  losing their length and orthogonality, so filtering, prediction and interpolation
+///  of orientations are done with quaternions instead.  Conversions to and from the
+///  view, right and up vectors are provided.
+///
+
+#include "Vector3.h"
+
+namespace MTF
+{
+
+    class Quaternion
+    {
+
+    public:
+        ///
+        ///  \brief Quaternion Constructor
+        ///
+        ///  Creates the identity quaternion (no rotation)
+        ///
+        Quaternion();
+
+        ///
+        ///  \brief Quaternion Constructor
+        ///
+        ///  Creates a quaternion from its four components
+        ///
+        ///  @param w                       The scalar component
+        ///  @param x                       The X component of the vector part
+        ///  @param y                       The Y component of the vector part
+        ///  @param z                       The Z component of the vector part
+        ///
+        Quaternion(Real w, Real x, Real y, Real z);
+
+        ///
+        ///  \brief Quaternion Constructor
+        ///
+        ///  Creates the rotation that turns the unit X, Y, and Z axes into the given right, up, and view vectors
+        ///
+        ///  @param view                    A normalized Vector3 pointing in the view direction
+        ///  @param right                   A normalized Vector3 pointing in the right direction
+        ///  @param up                      A normalized Vector3 pointing in the up direction
+        ///
+        Quaternion(Vector3 view, Vector3 right, Vector3 up);
+
+        ///
+        ///  \brief Quaternion Constructor
+        ///
+        ///  Creates a rotation around an axis
+        ///
+        ///  @param axis                    A normalized Vector3 containing the axis of rotation
+        ///  @param angle                   The angle of rotation in radians
+        ///
+        Quaternion(Vector3 axis, Real angle);
+
+        ///
+        ///  \brief Quaternion Deconstructor
+        ///
+        ~Quaternion();
+
+        ///
+        ///  \brief Overload Operator for: Quaternion * Quaternion
+        ///
+        ///  Returns the rotation that first applies the right hand side and then this rotation
+        ///
+        Quaternion operator * (Quaternion);
+
+        ///
+        ///  \brief Overload Operator for: Quaternion * Vector3
+        ///
+        ///  Returns the Vector3 rotated by this quaternion
+        ///
+        Vector3 operator * (Vector3);
+
+        ///
+        ///  \brief Returns the dot product between this Quaternion and a passed in Quaternion
+        ///
+        ///  \param param                   Passed in Quaternion used in calculating the dot product
+        ///  \return                        A Real value containing the dot product of two quaternions
+        ///
+        Real DotProduct(Quaternion param);
+
+        ///
+        ///  \brief Returns the conjugate of this Quaternion, which is the inverse rotation for a unit quaternion
+        ///
+        ///  \return                        A Quaternion containing the conjugate
+        ///
+        Quaternion GetConjugate();
+
+        ///
+        ///  \brief Makes this Quaternion a unit quaternion
+        ///
+        void Normalize();
+
+        ///
+        ///  \brief Returns a normalized copy of this Quaternion
+        ///
+        ///  \return                        A unit Quaternion copy of this Quaternion
+        ///
+        Quaternion GetNormalized();
+
+        ///
+        ///  \brief Returns the angle this Quaternion rotates by
+        ///
+        ///  \return                        The rotation angle in radians, between 0 and PI
+        ///
+        Real GetAngle();
+
+        ///
+        ///  \brief Returns the rotation as a single vector
+        ///
+        ///  The direction of the returned vector is the axis of rotation and its length is the
+        ///  angle in radians (between 0 and PI).  Dividing the rotation vector between two
+        ///  orientations by the time between them gives the angular velocity.
+        ///
+        ///  \return                        Vector3 containing the axis of rotation scaled by the angle
+        ///
+        Vector3 GetRotationVector();
+
+        ///
+        ///  \brief Returns the view vector of this orientation (rotation of the +z axis)
+        ///
+        ///  \return                        Vector3 containing the view vector
+        ///
+        Vector3 GetViewVector();
+
+        ///
+        ///  \brief Returns the right vector of this orientation (rotation of the +x axis)
+        ///
+        ///  \return                        Vector3 containing the right vector
+        ///
+        Vector3 GetRightVector();
+
+        ///
+        ///  \brief Returns the up vector of this orientation (rotation of the +y axis)
+        ///
+        ///  \return                        Vector3 containing the up vector
+        ///
+        Vector3 GetUpVector();
+
+        ///
+        ///  \brief Returns a human readable string representing the Quaternion
+        ///
+        ///  \return                        A string with the components of the Quaternion terminated in a new line
+        ///
+        std::string ToString();
+
+        ///
+        ///  \brief Returns the scalar component of this Quaternion
+        ///
+        Real GetW();
+
+        ///
+        ///  \brief Returns the X component of this Quaternion
+        ///
+        Real GetX();
+
+        ///
+        ///  \brief Returns the Y component of this Quaternion
+        ///
+        Real GetY();
+
+        ///
+        ///  \brief Returns the Z component of this Quaternion
+        ///
+        Real GetZ();
+
+        ///
+        ///  \brief Creates a Quaternion from a rotation vector
+        ///
+        ///  This is the reverse of GetRotationVector.
+        ///
+        ///  \param rotation                Vector3 containing the axis of rotation scaled by the angle in radians
+        ///  \return                        The unit Quaternion for the rotation
+        ///
+        static Quaternion FromRotationVector(Vector3 rotation);
+
+        ///
+        ///  \brief Spherical linear interpolation between two orientations
+        ///
+        ///  The interpolation always takes the shorter way between the two orientations.
+        ///
+        ///  \param from                    The orientation returned for t = 0
+        ///  \param to                      The orientation returned for t = 1
+        ///  \param t                       Interpolation factor, values outside of 0 to 1 extrapolate
+        ///  \return                        The interpolated unit Quaternion
+        ///
+        static Quaternion Slerp(Quaternion from, Quaternion to, Real t);
+
+        ///
+        ///  \brief The identity quaternion (no rotation)
+        ///
+        static const Quaternion IDENTITY;
+
+    private:
+        Real _w;
+        Real _x;
+        Real _y;
+        Real _z;
+    };
+
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef _REAL_H
+#define _REAL_H
+///
+///  \file Real.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \brief The floating point type used for positions, orientations and matrices.
+///
+///  Real is double by default.  Defining MTF_REAL_FLOAT for the framework and the
+///  application makes it float, so the filters, the published TrackingFrame and the
+///  Camera matrices are all single precision.  A frame then takes half the memory,
+///  and Matrix4::GetMatrixArray() fills an array that can go to glLoadMatrixf()
+///  directly.  The ART Tracker is precise to about 0.1 mm, which float holds easily
+///  at the size of a room.
+///
+///  Times stay double (seconds) or long long (nanoseconds) either way, since float
+///  cannot hold the time since 1970 to the millisecond.  The DTrack SDK also stays
+///  double; its values are converted once when a frame is published.
+///
+
+namespace MTF
+{
+
+#ifdef MTF_REAL_FLOAT
+    typedef float Real;
+#else
+    typedef double Real;
+#endif
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef _ROLLINGAVERAGE_H
+#define _ROLLINGAVERAGE_H
+///
+///  \file RollingAverage.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::RollingAverage RollingAverage.h "RollingAverage.h"
+///  \brief This class averages the most recent Vector3 samples.
+///
+///  The samples are kept in a fixed size ring inside the object, together with
+///  their running sum.  Adding a sample and reading the average both take constant
+///  time, and neither adding nor copying ever allocates memory.  At most MAX_SAMPLES
+///  samples can be averaged.
+///
+
+#include "Vector3.h"
+
+namespace MTF
+{
+
+    class RollingAverage
+    {
+
+    public:
+        ///
+        ///  \brief The largest number of samples that can be averaged
+        ///
+        static const int MAX_SAMPLES = 64;
+
+        ///
+        ///  \brief RollingAverage Constructor
+        ///
+        ///  Creates an empty RollingAverage that keeps no samples.
+        ///
+        RollingAverage();
+
+        ///
+        ///  \brief RollingAverage Constructor
+        ///
+        ///  Creates an empty RollingAverage that averages the given number of samples.
+        ///
+        ///  \param samples                 Number of most recent samples to average, limited to MAX_SAMPLES
+        ///
+        RollingAverage(int samples);
+
+        ///
+        ///  \brief RollingAverage Deconstructor
+        ///
+        ~RollingAverage();
+
+        ///
+        ///  \brief Adds a sample, replacing the oldest one once the RollingAverage is full
+        ///
+        ///  \param sample                  The Vector3 to add
+        ///
+        void Add(const Vector3 &sample);
+
+        ///
+        ///  \brief Removes all samples
+        ///
+        void Clear();
+
+        ///
+        ///  \brief Returns the number of samples currently held
+        ///
+        ///  \return                        The number of samples, at most GetCapacity()
+        ///
+        int GetCount();
+
+        ///
+        ///  \brief Returns the number of samples that are averaged
+        ///
+        ///  \return                        The number of samples averaged once the RollingAverage is full
+        ///
+        int GetCapacity();
+
+        ///
+        ///  \brief Returns the average of the samples currently held
+        ///
+        ///  \return                        Vector3 containing the average, or the zero vector if there are no samples
+        ///
+        Vector3 GetAverage();
+
+    private:
+        int _capacity;
+        int _count;
+        int _next;
+
+        Vector3 _sum;
+        Vector3 _samples[MAX_SAMPLES];
+    };
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef _SEQLOCK_H
+#define _SEQLOCK_H
+///
+///  \file SeqLock.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::SeqLock SeqLock.h "SeqLock.h"
+///  \brief This class shares a plain data value between one writer and any number of readers without locking.
+///
+///  The writer bumps a sequence counter to an odd value, copies the new value in,
+///  and bumps the counter to the next even value.  A reader copies the value out and
+///  retries if the counter was odd or changed while it was copying.  So the writer
+///  never waits for a reader, and readers never block the writer or allocate memory.
+///
+///  Only one thread may write.  T must be a plain data type (no pointers to owned
+///  memory, no virtual methods), since a reader may copy it while it is being written.
+///
+
+#include <boost/atomic.hpp>
+
+namespace MTF
+{
+
+    template <class T>
+    class SeqLock
+    {
+
+    public:
+        ///
+        ///  \brief SeqLock Constructor
+        ///
+        ///  The value is left uninitialized until the first call to Write.
+        ///
+        SeqLock() : _sequence(0)
+        {
+        }
+
+        ///
+        ///  \brief Publishes a new value
+        ///
+        ///  Must only be called from the single writer thread.
+        ///
+        ///  \param value                   The value to publish
+        ///
+        void Write(const T& value)
+        {
+            unsigned int sequence = _sequence.load(boost::memory_order_relaxed);
+
+            _sequence.store(sequence + 1, boost::memory_order_relaxed);
+            boost::atomic_thread_fence(boost::memory_order_release);
+
+            _value = value;
+
+            _sequence.store(sequence + 2, boost::memory_order_release);
+        }
+
+        ///
+        ///  \brief Copies out the last published value
+        ///
+        ///  \param value                   Assigned a consistent copy of the last published value
+        ///  \return                        The sequence number of the copied value (2 for the first write, then increasing by 2)
+        ///
+        unsigned int Read(T& value) const
+        {
+            unsigned int before, after;
+
+            do
+            {
+                before = _sequence.load(boost::memory_order_acquire);
+                value = _value;
+                boost::atomic_thread_fence(boost::memory_order_acquire);
+                after = _sequence.load(boost::memory_order_relaxed);
+            } while ((before & 1) != 0 || before != after);
+
+            return before;
+        }
+
+        ///
+        ///  \brief Copies out part of the last published value
+        ///
+        ///  Calls reader(value) until it has seen a consistent value.  The reader may be
+        ///  called several times and may see a value that is being changed, so it must only
+        ///  copy what it needs and must not act on what it sees before this returns.  Use this
+        ///  instead of Read to avoid copying all of a large value.
+        ///
+        ///  \param reader                  Function object taking a const T&
+        ///  \return                        The sequence number of the value seen by the last call
+        ///
+        template <class Reader>
+        unsigned int ReadWith(Reader& reader) const
+        {
+            unsigned int before, after;
+
+            do
+            {
+                before = _sequence.load(boost::memory_order_acquire);
+                reader(_value);
+                boost::atomic_thread_fence(boost::memory_order_acquire);
+                after = _sequence.load(boost::memory_order_relaxed);
+            } while ((before & 1) != 0 || before != after);
+
+            return before;
+        }
+
+        ///
+        ///  \brief Returns the sequence number of the last published value
+        ///
+        ///  \return                        The sequence number, 0 if nothing has been written yet
+        ///
+        unsigned int GetSequence() const
+        {
+            return _sequence.load(boost::memory_order_acquire) & ~1u;
+        }
+
+    private:
+        boost::atomic<unsigned int> _sequence;
+        T _value;
+
+        // Not copyable, the sequence counter is shared state
+        SeqLock(const SeqLock&);
+        SeqLock& operator = (const SeqLock&);
+    };
+
+}
+
+#endif
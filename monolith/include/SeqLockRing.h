@@ -0,0 +1,125 @@
+#ifndef _SEQLOCKRING_H
+#define _SEQLOCKRING_H
+///
+///  \file SeqLockRing.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::SeqLockRing SeqLockRing.h "SeqLockRing.h"
+///  \brief This class keeps the most recent values written by one thread, readable by any thread without locking.
+///
+///  Every value written gets the next index, starting at 0.  The last N values are
+///  kept, each in its own SeqLock, so a reader can copy any of them out while the
+///  writer keeps adding new ones.  A reader that is too slow to copy a value before
+///  it is replaced is told so, instead of getting the newer value.
+///
+///  Only one thread may write.  T must be a plain data type, as for SeqLock.
+///
+
+#include <boost/atomic.hpp>
+
+#include "SeqLock.h"
+
+namespace MTF
+{
+
+    template <class T, unsigned int N>
+    class SeqLockRing
+    {
+
+    public:
+        ///
+        ///  \brief SeqLockRing Constructor
+        ///
+        ///  Creates an empty ring.
+        ///
+        SeqLockRing() : _count(0)
+        {
+        }
+
+        ///
+        ///  \brief Adds a value, replacing the oldest one once N values have been written
+        ///
+        ///  Must only be called from the single writer thread.
+        ///
+        ///  \param value                   The value to add
+        ///
+        void Write(const T& value)
+        {
+            unsigned long index = _count.load(boost::memory_order_relaxed);
+
+            _slots[index % N].Write(value);
+
+            _count.store(index + 1, boost::memory_order_release);
+        }
+
+        ///
+        ///  \brief Copies out the value with the given index
+        ///
+        ///  \param index                   Index of the value, from GetCount() - N to GetCount() - 1
+        ///  \param value                   Assigned a consistent copy of the value
+        ///  \return                        False if the value has not been written yet or has already been replaced
+        ///
+        bool Read(unsigned long index, T& value) const
+        {
+            if (index >= _count.load(boost::memory_order_acquire))
+                return false;
+
+            _slots[index % N].Read(value);
+
+            // The writer may have moved on to the slot while we were copying it
+            return _count.load(boost::memory_order_acquire) - index < N;
+        }
+
+        ///
+        ///  \brief Copies out part of the value with the given index
+        ///
+        ///  Like Read, but calls reader(value) as SeqLock::ReadWith does, so only what the
+        ///  reader needs is copied.  What the reader saw must be ignored if this returns false.
+        ///
+        ///  \param index                   Index of the value, from GetCount() - N to GetCount() - 1
+        ///  \param reader                  Function object taking a const T&
+        ///  \return                        False if the value has not been written yet or has already been replaced
+        ///
+        template <class Reader>
+        bool ReadWith(unsigned long index, Reader& reader) const
+        {
+            if (index >= _count.load(boost::memory_order_acquire))
+                return false;
+
+            _slots[index % N].ReadWith(reader);
+
+            // The writer may have moved on to the slot while we were copying it
+            return _count.load(boost::memory_order_acquire) - index < N;
+        }
+
+        ///
+        ///  \brief Returns the number of values written so far
+        ///
+        ///  \return                        The index the next value will get
+        ///
+        unsigned long GetCount() const
+        {
+            return _count.load(boost::memory_order_acquire);
+        }
+
+        ///
+        ///  \brief Returns the number of values that are kept
+        ///
+        unsigned int GetCapacity() const
+        {
+            return N;
+        }
+
+    private:
+        boost::atomic<unsigned long> _count;
+        SeqLock<T> _slots[N];
+
+        // Not copyable, the slots are shared state
+        SeqLockRing(const SeqLockRing&);
+        SeqLockRing& operator = (const SeqLockRing&);
+    };
+
+}
+
+#endif
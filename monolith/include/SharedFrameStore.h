@@ -0,0 +1,100 @@
+#ifndef _SHAREDFRAMESTORE_H
+#define _SHAREDFRAMESTORE_H
+///
+///  \file SharedFrameStore.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::SharedFrameStore SharedFrameStore.h "SharedFrameStore.h"
+///  \brief This class places a FrameStore in named shared memory, so other processes on the computer can read the frames.
+///
+///  Only one process can receive from an ART Tracker port.  That process creates the
+///  shared memory and its tracking thread publishes every frame into it, as it would
+///  into its own FrameStore.  Any number of other processes open the shared memory by its
+///  name and read the frames in place, without a network socket and without locking.
+///
+///  The shared memory is created with shm_open on POSIX systems and as a named file
+///  mapping on Windows, through boost::interprocess.  It is removed when the creating
+///  process closes it.  Processes still reading it then see no new frames, and must
+///  open it again once a new publisher has started.
+///
+
+#include <string>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FrameStore.h"
+
+namespace MTF
+{
+
+    class SharedFrameStore
+    {
+
+    public:
+        ///
+        ///  \brief SharedFrameStore Constructor
+        ///
+        ///  Creates or opens the shared memory with the given name.  Check IsValid before using it.
+        ///
+        ///  \param name                    Name of the shared memory, the same in the publishing and the reading processes
+        ///  \param create                  True to create it for publishing, replacing any left over by a publisher that crashed, false to open it for reading
+        ///
+        SharedFrameStore(std::string name, bool create);
+
+        ///
+        ///  \brief SharedFrameStore Deconstructor
+        ///
+        ///  Unmaps the shared memory, and removes its name if it was created here.
+        ///
+        ~SharedFrameStore();
+
+        ///
+        ///  \brief Returns whether the shared memory could be created or opened
+        ///
+        ///  Opening fails if no publisher has created it, or if the publisher was built with
+        ///  a different version of the framework.
+        ///
+        bool IsValid();
+
+        ///
+        ///  \brief Returns the FrameStore in the shared memory
+        ///
+        ///  \return                        The FrameStore, NULL if not valid.  Must only be written to if created here.
+        ///
+        FrameStore* GetStore();
+
+    private:
+        // Placed in front of the FrameStore, so readers can check that they understand it
+        struct Header
+        {
+            unsigned int magic;
+            unsigned int version;
+            unsigned int storeSize;
+            boost::atomic<unsigned int> ready;
+        };
+
+        struct Layout
+        {
+            Header header;
+            FrameStore store;
+        };
+
+        static const unsigned int MAGIC = 0x4D544653;  // "MTFS"
+        static const unsigned int VERSION = 1;
+
+        std::string _name;
+        bool _created;
+        boost::interprocess::shared_memory_object _memory;
+        boost::interprocess::mapped_region _region;
+        Layout *_layout;
+
+        // Not copyable, the mapping is owned
+        SharedFrameStore(const SharedFrameStore&);
+        SharedFrameStore& operator = (const SharedFrameStore&);
+    };
+
+}
+
+#endif
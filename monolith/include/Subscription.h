@@ -0,0 +1,43 @@
+#ifndef _SUBSCRIPTION_H
+#define _SUBSCRIPTION_H
+///
+///  \file Subscription.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::Subscription Subscription.h "Subscription.h"
+///  \brief This class contains an enum which is used to specify which thread calls a frame subscriber.
+///
+///  Subscribers registered with Monolith::Subscribe are called once for every frame
+///  received from the tracker, with the frame as a TrackingFrame.  A subscriber can be
+///  called directly on the tracking thread, which has the least delay but holds up the
+///  reception of the next frame for as long as it runs, or on a dispatcher thread shared
+///  by all such subscribers, which keeps slow subscribers from delaying the tracker.
+///
+
+#include <boost/function.hpp>
+
+#include "TrackingFrame.h"
+
+namespace MTF
+{
+
+    ///
+    ///  \brief Function called with every frame received.  Any function, functor or boost::bind result taking a const TrackingFrame& can be used.
+    ///
+    typedef boost::function<void (const TrackingFrame&)> FrameCallback;
+
+    class Subscription
+    {
+
+    public:
+        enum THREAD {
+            TRACKING_THREAD,                ///< Called on the tracking thread right after the frame is published.  Must return quickly.
+            DISPATCHER_THREAD               ///< Called on the dispatcher thread.  May be slow, but then skips frames once it falls too far behind.
+        };
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+///
+///  \file Telemetry.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::TelemetryRecorder Telemetry.h "Telemetry.h"
+///  \brief This class counts how well the frames from the ART Tracker arrive and how long they take.
+///
+///  The tracking thread records every packet, timeout and frame, and any thread can take a
+///  Telemetry snapshot of the counts at the same time.  Everything is kept in atomic counters,
+///  so recording never waits for a reader and costs a few additions per frame.  The counts of
+///  a snapshot are each up to date, but may be from slightly different frames.
+///
+
+#include <string>
+
+#include <boost/atomic.hpp>
+
+#include "DTrackSDK.hpp"
+
+namespace MTF
+{
+
+    ///
+    ///  \brief How often a duration fell in each range, up to about half a second
+    ///
+    ///  Bucket 0 counts durations under 1 microsecond and bucket i those from 2^(i-1) up to
+    ///  2^i microseconds.  The last bucket also counts everything longer.
+    ///
+    struct TelemetryHistogram
+    {
+        static const int NUM_BUCKETS = 20;
+
+        unsigned long counts[NUM_BUCKETS];  ///< Number of durations in each bucket
+        unsigned long count;                ///< Number of durations in all buckets
+        long long totalNs;                  ///< Sum of all durations in nanoseconds
+        long long maxNs;                    ///< Longest duration in nanoseconds
+
+        ///
+        ///  \brief Returns the bucket a duration is counted in
+        ///
+        static int GetBucket(long long durationNs);
+
+        ///
+        ///  \brief Returns the shortest duration counted in a bucket, in microseconds
+        ///
+        static long long GetBucketStartUs(int bucket);
+    };
+
+    ///
+    ///  \brief The counts of a TelemetryRecorder at one time, see Monolith::GetTelemetry
+    ///
+    ///  All counts are since the framework started.
+    ///
+    struct Telemetry
+    {
+        static const int NUM_LINE_TYPES = DTRACK_LINE_NUM;
+
+        long long timeNs;                           ///< Time of the snapshot in nanoseconds since 1970
+        unsigned long packetsReceived;              ///< Packets received from all sources
+        unsigned long framesPublished;              ///< Frames passed on to the application
+        unsigned long frameGaps;                    ///< Frame counters missing between received packets, lost or coalesced
+        unsigned long coalescedFrames;              ///< Frames skipped for a newer one, see Monolith::SetProcessAllFrames
+        unsigned long parseErrors[NUM_LINE_TYPES];  ///< Packets that could not be parsed, by the line type that failed (DTRACK_LINE_*)
+        unsigned long timeouts;                     ///< Waits of a second without a packet from any source
+        unsigned long networkErrors;                ///< Failed reads from the sockets
+        unsigned long droppedWandEvents;            ///< See Monolith::GetDroppedWandEventCount
+        long long jitterNs;                         ///< Smoothed change of the time between frames, like the jitter of RFC 3550
+
+        TelemetryHistogram interArrival;            ///< Time between the arrival of published frames
+        TelemetryHistogram parse;                   ///< Time to read and parse the packets of one wait
+        TelemetryHistogram publish;                 ///< Time to merge, filter and publish one frame, including TRACKING_THREAD subscribers
+
+        ///
+        ///  \brief Returns the snapshot as one line of JSON, without a line break
+        ///
+        std::string ToJson() const;
+
+        ///
+        ///  \brief Returns the name of a line type in the DTrack protocol, such as "6df2"
+        ///
+        static const char* GetLineTypeName(int lineType);
+    };
+
+    class TelemetryRecorder
+    {
+
+    public:
+        ///
+        ///  \brief TelemetryRecorder Constructor
+        ///
+        ///  Starts with all counts at 0.
+        ///
+        TelemetryRecorder();
+
+        ///
+        ///  \brief Sets the counts kept by the SDKs, summed over all sources
+        ///
+        ///  Only the thread that records may call this, as with all Record methods.
+        ///
+        ///  \param statistics              Counts since the SDKs were created
+        ///
+        void SetSourceStatistics(const DTrack_Statistics_Type &statistics);
+
+        ///
+        ///  \brief Counts a wait without a packet from any source
+        ///
+        void RecordTimeout();
+
+        ///
+        ///  \brief Counts a failed wait on the sockets
+        ///
+        void RecordNetworkError();
+
+        ///
+        ///  \brief Records the time to read and parse the packets of one wait
+        ///
+        ///  \param durationNs              Duration in nanoseconds
+        ///
+        void RecordParse(long long durationNs);
+
+        ///
+        ///  \brief Records a published frame
+        ///
+        ///  \param receiveTimeNs           Arrival time of the frame in nanoseconds since 1970
+        ///  \param publishNs               Time to merge, filter and publish the frame in nanoseconds
+        ///
+        void RecordFrame(long long receiveTimeNs, long long publishNs);
+
+        ///
+        ///  \brief Copies the counts into a snapshot
+        ///
+        ///  Can be called from any thread.  The counts the recorder doesn't keep, such as the
+        ///  frames published, are left as they are.
+        ///
+        ///  \param telemetry               Assigned the counts
+        ///
+        void GetSnapshot(Telemetry &telemetry) const;
+
+    private:
+        // The counts of a TelemetryHistogram, written by the one thread that records
+        struct Histogram
+        {
+            boost::atomic<unsigned long> counts[TelemetryHistogram::NUM_BUCKETS];
+            boost::atomic<unsigned long> count;
+            boost::atomic<long long> totalNs;
+            boost::atomic<long long> maxNs;
+
+            void Reset();
+            void Add(long long durationNs);
+            void Read(TelemetryHistogram &histogram) const;
+        };
+
+        boost::atomic<unsigned long> _packets;
+        boost::atomic<unsigned long> _frameGaps;
+        boost::atomic<unsigned long> _parseErrors[Telemetry::NUM_LINE_TYPES];
+        boost::atomic<unsigned long> _sourceTimeouts;
+        boost::atomic<unsigned long> _sourceNetworkErrors;
+        boost::atomic<unsigned long> _timeouts;
+        boost::atomic<unsigned long> _networkErrors;
+        boost::atomic<long long> _jitterNs;
+
+        Histogram _interArrival;
+        Histogram _parse;
+        Histogram _publish;
+
+        // Only used by the thread that records
+        long long _lastReceiveTimeNs;
+        long long _lastIntervalNs;
+        double _jitter;
+
+        // Not copyable, atomics can't be copied
+        TelemetryRecorder(const TelemetryRecorder&);
+        TelemetryRecorder& operator = (const TelemetryRecorder&);
+    };
+
+}
+
+#endif
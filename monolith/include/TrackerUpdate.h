@@ -16,12 +16,29 @@
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <cstdio>
+#include <vector>
 
 #include "DTrackSDK.hpp"
 
 #include "Head.h"
 #include "Wand.h"
+#include "FrameStore.h"
+#include "SharedFrameStore.h"
+#include "TrackingFrame.h"
+#include "PoseFilter.h"
+#include "Subscription.h"
+#include "WandEvent.h"
+#include "TrackingSource.h"
+#include "PacketCapture.h"
+#include "PacketReplay.h"
+#include "Telemetry.h"
 
 namespace MTF
 {
@@ -36,6 +53,11 @@ class TrackerUpdate
 
         TrackerUpdate(int port);
         TrackerUpdate(int port, int smoothing);
+        TrackerUpdate(int port, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter);
+        TrackerUpdate(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter);
+        TrackerUpdate(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName);
+        TrackerUpdate(std::string sharedMemoryName);
+        TrackerUpdate(std::string captureFile, PacketReplay::TIMING timing, std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter);
         ~TrackerUpdate();
  
         void Run();
@@ -44,20 +66,199 @@ class TrackerUpdate
         Head GetHead();
         Wand GetWand();
 
+        Head GetUserHead(int user);
+        Wand GetUserWand(int user);
+        void SetUser(int user, int headBodyId, int wandFlyStickId);
+        int GetNumUsers();
+
+        Head GetBody(int id);
+        Wand GetFlyStick(int id);
+        int GetNumBodies();
+        int GetNumFlySticks();
+        void GetFrame(TrackingFrame &frame);
+
+        Head GetHeadAt(long long timeNs);
+        Wand GetWandAt(long long timeNs);
+
+        void SetPredictionMode(PosePredictor::MODE mode);
+        void SetProcessAllFrames(bool all);
+        unsigned long GetCoalescedFrameCount();
+
+        unsigned long GetFrameNumber();
+        bool WaitForFrame(unsigned long lastFrameNumber, int timeoutMs);
+
+        int Subscribe(FrameCallback callback, Subscription::THREAD thread);
+        void Unsubscribe(int id);
+
+        bool PollWandEvent(WandEvent &event);
+        unsigned long GetDroppedWandEventCount();
+
+        bool StartCapture(std::string filename);
+        void StopCapture();
+
+        void GetTelemetry(Telemetry &telemetry);
+        bool StartTelemetryDump(std::string filename, int intervalMs);
+        void StopTelemetryDump();
+
         bool IsRunning();
 
     private:
 
+        // The last frame received from one source, moved into the shared coordinates
+        struct SourceFrame
+        {
+            long long receiveTimeNs;
+            std::vector<DTrack_Body_Type_d> bodies;
+            std::vector<DTrack_FlyStick_Type_d> flySticks;
+        };
+
+        void Initialize(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName, bool reader);
+
         void Update();
 
-        int _port;
+        void Follow();
+
+        void Replay();
+
+        void ApplyPredictionMode();
+
+        void ApplyReceiveMode(std::vector<DTrackSDK*> &sdks);
+
+        static void CapturePacket(void *context, const char *data, int length, long long receiveTimeNs);
+
+        void DumpTelemetry();
+
+        void NotifyWaiters();
+
+        void StoreSourceFrame(int source, DTrackSDK &dt);
+
+        void MergeSources();
+
+        void UpdateBodies();
+
+        void Publish(unsigned long frameNumber);
+
+        bool FindFrames(long long timeNs, unsigned long &before, unsigned long &after);
+
+        template <class Reader>
+        bool ReadFramesAt(long long timeNs, Reader &before, Reader &after);
+
+        void Deliver(const TrackingFrame &frame, Subscription::THREAD thread);
+
+        void Dispatch(unsigned long delivered);
+
+        void QueueWandEvents(const FlyStickState &previous, const FlyStickState &current, int user);
+        void QueueWandEvent(WandEvent &event);
+
+        std::vector<TrackingSource> _sources;
 
         volatile bool _stopRequested;
         boost::shared_ptr<boost::thread> _thread;
-        boost::mutex _mutex;
 
-        Head *_head;
-        Wand *_wand;
+        // Set by any thread, applied by the tracking thread before its next update
+        boost::atomic<int> _predictionMode;
+        boost::atomic<bool> _processAllFrames;
+        boost::atomic<int> _numUsers;
+        boost::atomic<int> _headBodyIds[TrackingFrame::MAX_USERS];
+        boost::atomic<int> _wandFlyStickIds[TrackingFrame::MAX_USERS];
+
+        // Only used by the tracking thread
+        int _appliedPredictionMode;
+        bool _appliedProcessAllFrames;
+        PoseFilterChain _headFilter;
+        PoseFilterChain _wandFilter;
+        long long _receiveTimeNs;
+
+        // Frames the sources received but skipped for a newer one, written by the tracking thread
+        boost::atomic<unsigned long> _coalescedFrames;
+
+        // Frames of other sources older than this, compared to the newest one, are left out of the merge
+        static const long long MAX_SOURCE_AGE_NS;
+        std::vector<SourceFrame> _sourceFrames;
+        SourceFrame _merged;
+        std::vector<long long> _mergedBodyTimes;
+        std::vector<long long> _mergedFlyStickTimes;
+
+        int _activeUsers;
+        Head *_heads[TrackingFrame::MAX_USERS];
+        Wand *_wands[TrackingFrame::MAX_USERS];
+        int _boundHeadIds[TrackingFrame::MAX_USERS];
+        int _boundWandIds[TrackingFrame::MAX_USERS];
+
+        int _numBodies;
+        Head *_bodies[TrackingFrame::MAX_BODIES];
+        int _numFlySticks;
+        Wand *_flySticks[TrackingFrame::MAX_FLYSTICKS];
+
+        // The last frame and the history for looking up poses by time, read by any thread without
+        // locking.  Points into shared memory when publishing to or reading from other processes.
+        FrameStore *_store;
+        boost::scoped_ptr<FrameStore> _localStore;
+        boost::scoped_ptr<SharedFrameStore> _sharedStore;
+
+        // Reading the frames another process publishes, instead of receiving from the tracker.
+        // Follow checks for new frames every FOLLOW_INTERVAL_US microseconds.
+        bool _reader;
+        static const int FOLLOW_INTERVAL_US;
+
+        // Replaying a capture, instead of receiving from the tracker
+        boost::scoped_ptr<PacketReplay> _replay;
+        PacketReplay::TIMING _replayTiming;
+
+        // The capture being written, if any.  Replaced by any thread, used by the tracking thread.
+        struct CaptureContext
+        {
+            TrackerUpdate *tracker;
+            int source;
+        };
+        boost::shared_ptr<PacketCapture> _capture;
+        std::vector<CaptureContext> _captureContexts;
+
+        // How well the frames arrive and how long they take, recorded by the tracking thread
+        TelemetryRecorder _telemetry;
+
+        // Writes a telemetry snapshot to _telemetryFile every _telemetryIntervalMs, while running.
+        // Started and stopped under _telemetryDumpMutex.
+        boost::shared_ptr<boost::thread> _telemetryDumper;
+        volatile bool _telemetryDumpStopRequested;
+        FILE *_telemetryFile;
+        int _telemetryIntervalMs;
+        boost::mutex _telemetryDumpMutex;
+
+        // Number of frames received, raised once a frame is published.  Waiting threads sleep on
+        // the condition, which is only signalled when _waiters shows that someone is waiting.
+        boost::atomic<unsigned long> _frameNumber;
+        boost::atomic<int> _waiters;
+        boost::mutex _waitMutex;
+        boost::condition_variable _waitCondition;
+
+        struct SubscriptionEntry
+        {
+            int id;
+            FrameCallback callback;
+            Subscription::THREAD thread;
+        };
+        typedef std::vector<SubscriptionEntry> SubscriptionList;
+
+        // The list is never changed once shared.  Subscribe and Unsubscribe replace it with
+        // a new list, so delivering a frame only needs to load the pointer.  Empty if no one subscribed.
+        boost::shared_ptr<const SubscriptionList> _subscriptions;
+        boost::mutex _subscribeMutex;
+        int _nextSubscriptionId;
+
+        // Held while calling subscribers, so Unsubscribe can wait for a call in progress
+        boost::mutex _deliverMutex;
+        boost::mutex _dispatchMutex;
+
+        // Calls the DISPATCHER_THREAD subscribers, started by the first one
+        boost::shared_ptr<boost::thread> _dispatcher;
+
+        // Button and joystick changes, written by the tracking thread and read by the
+        // one thread that calls PollWandEvent.  _lastWands is only used by the tracking thread.
+        static const unsigned int WAND_EVENT_QUEUE_SIZE = 1024;
+        boost::lockfree::spsc_queue<WandEvent, boost::lockfree::capacity<WAND_EVENT_QUEUE_SIZE> > _wandEvents;
+        boost::atomic<unsigned long> _droppedWandEvents;
+        FlyStickState _lastWands[TrackingFrame::MAX_USERS];
     };
 
 }
@@ -23,6 +23,13 @@ namespace MTF
     {
 
     public:
+        ///
+        ///  \brief TrackingBody Deconstructor
+        ///
+        ///  Virtual, so a Head or Wand can be deleted through a TrackingBody pointer.
+        ///
+        virtual ~TrackingBody() {}
+
         ///
         ///  \brief Pure virtual method for retrieving the position of a tracking device
         ///
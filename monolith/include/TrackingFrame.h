@@ -0,0 +1,83 @@
+#ifndef _TRACKINGFRAME_H
+#define _TRACKINGFRAME_H
+///
+///  \file TrackingFrame.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \brief Plain data structures that hold the tracking results of one frame.
+///
+///  These structures are what the tracking thread publishes for the rest of the
+///  framework.  They contain no pointers, virtual methods, or heap memory, so a
+///  frame can be copied with a single memory copy.  The Head and Wand classes can
+///  be created from them.
+///
+
+#include "Real.h"
+
+namespace MTF
+{
+
+    ///
+    ///  \brief Position and orientation of a tracked body
+    ///
+    struct BodyState
+    {
+        bool tracked;                       ///< Whether the body was tracked in this frame
+        long long receiveTimeNs;            ///< Arrival time of the frame in nanoseconds since 1970, -1 if unknown
+        unsigned long frameNumber;          ///< Number of the frame this state was published in, 0 before the first frame
+
+        Real position[3];                   ///< Position in feet
+        Real view[3];                       ///< View direction
+        Real up[3];                         ///< Up direction
+        Real right[3];                      ///< Right direction
+
+        Real velocity[3];                   ///< Estimated velocity in feet per second
+        Real angularVelocity[3];            ///< Estimated angular velocity, the axis of rotation scaled by radians per second
+    };
+
+    ///
+    ///  \brief Position, orientation, buttons and joystick of a FlyStick
+    ///
+    struct FlyStickState
+    {
+        BodyState pose;                     ///< Position and orientation of the FlyStick
+
+        int numButtons;                     ///< Number of buttons in use
+        bool buttons[16];                   ///< Button states, true if pressed
+        Real joystickHorizontal;            ///< Horizontal joystick value (-1.0 to 1.0)
+        Real joystickVertical;              ///< Vertical joystick value (-1.0 to 1.0)
+    };
+
+    ///
+    ///  \brief Everything the tracking thread publishes for one frame
+    ///
+    ///  A frame holds two views of the tracking data.  The users are the Head and Wand
+    ///  roles bound with Monolith::SetUser, run through the filters and smoothing set up
+    ///  for the framework.  The bodies and FlySticks are every standard body and FlyStick
+    ///  the ART Tracker sent, indexed by their DTrack ID, unfiltered.  Only the first
+    ///  numUsers, numBodies and numFlySticks entries are valid.
+    ///
+    struct TrackingFrame
+    {
+        static const int MAX_USERS = 4;             ///< Largest number of Head and Wand pairs
+        static const int MAX_BODIES = 16;           ///< Largest number of standard bodies, higher IDs are ignored
+        static const int MAX_FLYSTICKS = 8;         ///< Largest number of FlySticks, higher IDs are ignored
+
+        unsigned long frameNumber;                  ///< Number of this frame, 0 before the first frame
+        long long receiveTimeNs;                    ///< Arrival time of the frame in nanoseconds since 1970, -1 before the first frame
+
+        int numUsers;                               ///< Number of users, at least 1
+        BodyState heads[MAX_USERS];                 ///< Head of each user, heads[0] is the one returned by Monolith::GetHead()
+        FlyStickState wands[MAX_USERS];             ///< Wand of each user, wands[0] is the one returned by Monolith::GetWand()
+
+        int numBodies;                              ///< Number of standard bodies
+        BodyState bodies[MAX_BODIES];               ///< Standard bodies by DTrack ID
+
+        int numFlySticks;                           ///< Number of FlySticks
+        FlyStickState flySticks[MAX_FLYSTICKS];     ///< FlySticks by DTrack ID
+    };
+
+}
+
+#endif
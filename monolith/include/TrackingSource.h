@@ -0,0 +1,90 @@
+#ifndef _TRACKINGSOURCE_H
+#define _TRACKINGSOURCE_H
+///
+///  \file TrackingSource.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::TrackingSource TrackingSource.h "TrackingSource.h"
+///  \brief This class describes one ART Tracker that sends tracking data to the framework.
+///
+///  A large floor can be covered by several trackers, each sending to its own port or
+///  multicast group.  The framework receives all of them on the one tracking thread and
+///  merges their bodies and FlySticks into one frame (see Monolith::Monolith).
+///
+///  Every tracker measures in its own room coordinates.  The calibration of a source moves
+///  its poses into the coordinates shared by all sources, so a body walking from the area of
+///  one tracker into the area of the next one does not jump.
+///
+
+#include <string>
+
+#include "Matrix4.h"
+
+namespace MTF
+{
+
+    class TrackingSource
+    {
+
+    public:
+        ///
+        ///  \brief TrackingSource Constructor
+        ///
+        ///  Creates a source for a tracker sending to the given port, whose coordinates are
+        ///  used as they are.
+        ///
+        ///  \param port                    The port number the ART Tracker is sending to
+        ///
+        TrackingSource(int port);
+
+        ///
+        ///  \brief TrackingSource Constructor
+        ///
+        ///  \param port                    The port number the ART Tracker is sending to
+        ///  \param calibration             Rigid transform (rotation and translation in feet) from the coordinates of this tracker to the shared coordinates
+        ///
+        TrackingSource(int port, Matrix4 calibration);
+
+        ///
+        ///  \brief TrackingSource Constructor
+        ///
+        ///  Creates a source for a tracker sending to a multicast group.
+        ///
+        ///  \param multicastGroup          IP address of the multicast group, such as "239.0.0.1"
+        ///  \param port                    The port number the ART Tracker is sending to
+        ///  \param calibration             Rigid transform (rotation and translation in feet) from the coordinates of this tracker to the shared coordinates
+        ///
+        TrackingSource(std::string multicastGroup, int port, Matrix4 calibration);
+
+        ///
+        ///  \brief TrackingSource Deconstructor
+        ///
+        ~TrackingSource();
+
+        ///
+        ///  \brief Returns the port number the tracker is sending to
+        ///
+        int GetPort();
+
+        ///
+        ///  \brief Returns the multicast group the tracker is sending to
+        ///
+        ///  \return                        IP address of the group, empty if the tracker sends directly to this computer
+        ///
+        std::string GetMulticastGroup();
+
+        ///
+        ///  \brief Returns the transform from the coordinates of this tracker to the shared coordinates
+        ///
+        Matrix4 GetCalibration();
+
+    private:
+        int _port;
+        std::string _multicastGroup;
+        Matrix4 _calibration;
+    };
+
+}
+
+#endif
@@ -18,6 +18,8 @@
 #include <iomanip>
 #include <string>
 
+#include "Real.h"
+
 namespace MTF
 {
 
@@ -42,7 +44,7 @@ namespace MTF
         ///  @param y                       Value for the Y component of the vector
         ///  @param z                       Value for the Z component of the vector
         ///
-        Vector3(double x, double y, double z);
+        Vector3(Real x, Real y, Real z);
 
         ///
         ///  \brief Vector3 Constructor
@@ -53,6 +55,15 @@ namespace MTF
         ///
         Vector3(double xyz[]);
 
+        ///
+        ///  \brief Vector3 Constructor
+        ///
+        ///  Creates a vector initialized with the passed in values
+        ///
+        ///  @param xyz                     Float array of length 3 with the X, Y, and Z components for the vector
+        ///
+        Vector3(float xyz[]);
+
         ///
         ///  \brief Vector3 Deconstructor
         ///
@@ -64,11 +75,11 @@ namespace MTF
         Vector3 operator + (Vector3);
 
         ///
-        ///  \brief Overload Operator for: Vector3 + double
+        ///  \brief Overload Operator for: Vector3 + Real
         ///
-        ///  Returns the vector with the double value added to each component
+        ///  Returns the vector with the Real value added to each component
         ///
-        Vector3 operator + (double);
+        Vector3 operator + (Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 - Vector3
@@ -76,11 +87,11 @@ namespace MTF
         Vector3 operator - (Vector3);
 
         ///
-        ///  \brief Overload Operator for: Vector3 - double
+        ///  \brief Overload Operator for: Vector3 - Real
         ///
-        ///  Returns the vector with the double value subtracted from each component
+        ///  Returns the vector with the Real value subtracted from each component
         ///
-        Vector3 operator - (double);
+        Vector3 operator - (Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 * Vector3
@@ -88,18 +99,18 @@ namespace MTF
         Vector3 operator * (Vector3);
 
         ///
-        ///  \brief Overload Operator for: Vector3 * double
+        ///  \brief Overload Operator for: Vector3 * Real
         ///
-        ///  Returns the vector with each component multiplied by the double value
+        ///  Returns the vector with each component multiplied by the Real value
         ///
-        Vector3 operator * (double);
+        Vector3 operator * (Real);
 
         ///
-        ///  \brief Overload Operator for: Vector3 / double
+        ///  \brief Overload Operator for: Vector3 / Real
         ///
-        ///  Returns the vector with each component divided by the double value
+        ///  Returns the vector with each component divided by the Real value
         ///
-        Vector3 operator / (double);
+        Vector3 operator / (Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 += Vector3
@@ -107,11 +118,11 @@ namespace MTF
         Vector3& operator += (const Vector3&);
 
         ///
-        ///  \brief Overload Operator for: Vector3 += double
+        ///  \brief Overload Operator for: Vector3 += Real
         ///
-        ///  Each component of this Vector3 is increased by the double value
+        ///  Each component of this Vector3 is increased by the Real value
         ///
-        Vector3& operator += (const double);
+        Vector3& operator += (const Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 -= Vector3
@@ -119,11 +130,11 @@ namespace MTF
         Vector3& operator -= (const Vector3&);
 
         ///
-        ///  \brief Overload Operator for: Vector3 -= double
+        ///  \brief Overload Operator for: Vector3 -= Real
         ///
-        ///  Each component of this Vector3 is decreased by the double value
+        ///  Each component of this Vector3 is decreased by the Real value
         ///
-        Vector3& operator -= (const double);
+        Vector3& operator -= (const Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 *= Vector3
@@ -131,18 +142,18 @@ namespace MTF
         Vector3& operator *= (const Vector3&);
 
         ///
-        ///  \brief Overload Operator for: Vector3 *= double
+        ///  \brief Overload Operator for: Vector3 *= Real
         ///
-        ///  Multiplies each component of this Vector3 by the double value
+        ///  Multiplies each component of this Vector3 by the Real value
         ///  
-        Vector3& operator *= (const double);
+        Vector3& operator *= (const Real);
 
         ///
-        ///  \brief Overload Operator for: Vector3 \= double
+        ///  \brief Overload Operator for: Vector3 \= Real
         ///
-        ///  Divides each component of this Vector3 by the double value
+        ///  Divides each component of this Vector3 by the Real value
         ///  
-        Vector3& operator /= (const double);
+        Vector3& operator /= (const Real);
 
         ///
         ///  \brief Overload Operator for: Vector3 == Vector3
@@ -165,7 +176,7 @@ namespace MTF
         ///  \param y                       The Y component of the vector
         ///  \param z                       The Z component of the vector
         ///
-        void Set(double x, double y, double z);
+        void Set(Real x, Real y, Real z);
 
         ///
         ///  \brief Makes this Vector3 a normalized vector
@@ -180,39 +191,39 @@ namespace MTF
         ///
         ///  \brief Returns the lenght of this Vector3
         ///
-        ///  \return                        A double value containing the length of the vector
+        ///  \return                        A Real value containing the length of the vector
         ///
-        double GetLength();
+        Real GetLength();
 
         ///
         ///  \brief Returns the distance between this Vector3 and a passed in Vector3 (treating them as points)
         ///
         ///  \param param                   Passed in Vector3 used in calculating the distance
-        ///  \return                        A double value containing the distance between two vectors
+        ///  \return                        A Real value containing the distance between two vectors
         ///
-        double GetDistance(Vector3 param);
+        Real GetDistance(Vector3 param);
 
         ///
         ///  \brief Returns the dot product between this Vector3 and a passed in Vector3
         ///
         ///  \param param                   Passed in Vector3 used in calculating the dot product
-        ///  \return                        A double value containing the dot product of two vectors
+        ///  \return                        A Real value containing the dot product of two vectors
         ///
-        double DotProduct(Vector3 param);
+        Real DotProduct(Vector3 param);
 
         ///
         ///  \brief Returns the absolute dot product between this Vector3 and a passed in Vector3
         ///
         ///  \param param                   Passed in Vector3 used in calculating the dot product
-        ///  \return                        A double value containing the absolute dot product of two vectors
+        ///  \return                        A Real value containing the absolute dot product of two vectors
         ///
-        double AbsDotProduct(Vector3 param);
+        Real AbsDotProduct(Vector3 param);
 
         ///
         ///  \brief Returns the cross product between this Vector3 and a passed in Vector3
         ///
         ///  \param param                   Passed in Vector3 used in calculating the cross product
-        ///  \return                        A double value containing the cross product of two vectors
+        ///  \return                        A Real value containing the cross product of two vectors
         ///
         Vector3 CrossProduct(Vector3 param);
 
@@ -233,23 +244,23 @@ namespace MTF
         ///
         ///  \brief Returns the X component of this Vector3
         ///
-        ///  \return                        A double value containing the X component
+        ///  \return                        A Real value containing the X component
         ///
-        double GetX();
+        Real GetX();
 
         ///
         ///  \brief Returns the Y component of this Vector3
         ///
-        ///  \return                        A double value containing the Y component
+        ///  \return                        A Real value containing the Y component
         ///
-        double GetY();
+        Real GetY();
 
         ///
         ///  \brief Returns the Z component of this Vector3
         ///
-        ///  \return                        A double value containing the Z component
+        ///  \return                        A Real value containing the Z component
         ///
-        double GetZ();
+        Real GetZ();
 
         ///
         ///  \brief A Vector3 with zeros for each component
@@ -292,9 +303,9 @@ namespace MTF
         static const Vector3 UNIT_SCALE;
 
     private:
-        double _x;
-        double _y;
-        double _z;
+        Real _x;
+        Real _y;
+        Real _z;
     };
 
 }
@@ -11,7 +11,8 @@
 ///  This class derives from TrackingBody and implements the methods
 ///  needed to perform wand tracking operations.  While similar to
 ///  the Head class, the Wand class must also handles joystick
-///  and button presses.
+///  and button presses.  A Wand can be passed to the Camera directly
+///  as a TrackingBody, including a Wand returned by Predict.
 ///
 
 #include <stdio.h>
@@ -23,13 +24,15 @@
 #include "Camera.h"
 
 #include "Head.h"
-
-#include <list>
+#include "TrackingFrame.h"
+#include "RollingAverage.h"
+#include "PoseFilter.h"
+#include "PosePredictor.h"
 
 namespace MTF
 {
 
-    class Wand : TrackingBody
+    class Wand : public TrackingBody
     {
 
     public:
@@ -51,10 +54,21 @@ namespace MTF
         ///  with no joystick input or buttons pressed.  Smoothing is assigned 
         ///  from the passed in value.
         ///
-        ///  \param rollingAverage          Number of previous wand updates to average when calculation the position or direction vectors
+        ///  \param rollingAverage          Number of previous wand updates to average when calculation the position or direction vectors (at most RollingAverage::MAX_SAMPLES)
         ///
         Wand(int rollingAverage);
 
+        ///
+        ///  \brief Wand Constructor
+        ///
+        ///  Creates a Wand object from a state published by the tracking thread.
+        ///  The position and view vector in the state are already smoothed, so smoothing
+        ///  is disabled for this Wand.
+        ///
+        ///  \param state                   FlyStickState containing the position, orientation, buttons and joystick of the wand
+        ///
+        Wand(const FlyStickState &state);
+
         ///
         ///  \brief Wand Deconstructor
         ///
@@ -102,10 +116,95 @@ namespace MTF
         ///
         bool IsTracked();
 
+        ///
+        ///  \brief Returns when the tracking data for the current pose of this Wand arrived at this computer
+        ///
+        ///  The time is taken on the local clock when the packet arrived (by the kernel on Linux),
+        ///  not by the ART Tracker.  It can be compared with udp_get_time_ns() to measure latency.
+        ///  Samples without a usable pose, or dropped by the filter, leave the time unchanged.
+        ///
+        ///  \return                        Arrival time in nanoseconds since 1970, or -1 if no data has been received yet
+        ///
+        long long GetReceiveTimeNs();
+
+        ///
+        ///  \brief Returns the number of the tracker frame this Wand comes from
+        ///
+        ///  Frames are numbered from 1 in the order they are received.  If this number is
+        ///  lower than Monolith::GetFrameNumber(), a newer frame has arrived since this Wand
+        ///  was retrieved.
+        ///
+        ///  \return                        The frame number, 0 if no frame has been received yet
+        ///
+        unsigned long GetFrameNumber();
+
+        ///
+        ///  \brief Returns the estimated velocity of the wand
+        ///
+        ///  \return                        Vector3 containing the velocity in feet per second
+        ///
+        Vector3 GetVelocity();
+
+        ///
+        ///  \brief Returns the estimated angular velocity of the wand
+        ///
+        ///  \return                        Vector3 containing the axis of rotation scaled by the speed in radians per second
+        ///
+        Vector3 GetAngularVelocity();
+
+        ///
+        ///  \brief Returns this Wand extrapolated to another time
+        ///
+        ///  The position and orientation are moved on with the estimated velocities, from
+        ///  the time the tracking data arrived to the target time.  At most
+        ///  PosePredictor::MAX_PREDICTION seconds are extrapolated, and a Wand that is not
+        ///  tracked is returned unchanged.  Buttons and joystick are copied as they are.
+        ///
+        ///  \param targetTimeNs            Target time in nanoseconds since 1970, on the clock of udp_get_time_ns()
+        ///  \return                        A copy of this Wand at the target time
+        ///
+        Wand Predict(long long targetTimeNs);
+
+        ///
+        ///  \brief Returns the Wand between two tracked Wands at the given time
+        ///
+        ///  The position and velocities are interpolated linearly and the orientation by
+        ///  slerp.  Buttons and joystick are taken from the earlier Wand, since the later
+        ///  state had not happened yet at the given time.  If either Wand is not tracked, or
+        ///  they arrived at the same time, the one closer to the given time is returned.
+        ///  The result has the given time as its receive time.
+        ///
+        ///  \param from                    The earlier Wand
+        ///  \param to                      The later Wand
+        ///  \param timeNs                  Time to interpolate to, in nanoseconds since 1970
+        ///  \return                        The interpolated Wand
+        ///
+        static Wand Interpolate(Wand from, Wand to, long long timeNs);
+
         ///
         ///  \brief Updates the values of the Wand's position and orientation
         ///
-        void Update(DTrack_FlyStick_Type_d data);
+        ///  \param data                    Tracking data for the wand from the last received frame
+        ///  \param receiveTimeNs           Arrival time of the frame in nanoseconds since 1970
+        ///
+        void Update(DTrack_FlyStick_Type_d data, long long receiveTimeNs);
+
+        ///
+        ///  \brief Sets the filters that each new position and orientation of the Wand is run through
+        ///
+        ///  The filters are run by Update before the rolling average, so they only need to be
+        ///  set on the Wand owned by the tracking thread.  Buttons and joystick are not filtered.
+        ///
+        ///  \param filter                  PoseFilterChain that is copied into this Wand, an empty chain disables filtering
+        ///
+        void SetFilter(PoseFilterChain filter);
+
+        ///
+        ///  \brief Sets how Update estimates the velocities of the Wand
+        ///
+        ///  \param mode                    How velocities are estimated, see PosePredictor
+        ///
+        void SetPredictionMode(PosePredictor::MODE mode);
 
         ///
         ///  \brief Returns the current view direction of the wand in object space
@@ -152,9 +251,9 @@ namespace MTF
         ///  from here does not account for this, and is left up to the calling method to
         ///  handle any processing done to the joystick value.
         ///
-        ///  \return                        Returns the horizontal component of the joysticks as a double
+        ///  \return                        Returns the horizontal component of the joysticks as a Real
         ///
-        double GetJoystickHorizontal();
+        Real GetJoystickHorizontal();
 
         ///
         ///  \brief Returns the value of the vertical joystick
@@ -165,9 +264,9 @@ namespace MTF
         ///  from here does not account for this, and is left up to the calling method to
         ///  handle any processing done to the joystick value.
         ///
-        ///  \return                        Returns the vertical component of the joysticks as a double
+        ///  \return                        Returns the vertical component of the joysticks as a Real
         ///
-        double GetJoystickVertical();
+        Real GetJoystickVertical();
 
         ///
         ///  \brief Returns whether the Z button is pressed (Button on back of FlyStick)
@@ -203,23 +302,40 @@ namespace MTF
         ///  \return                        A copy of the current Wand
         ///
         Wand GetCopy();
+
+        ///
+        ///  \brief Stores the state of this Wand in a plain data structure
+        ///
+        ///  The position and view vector are stored smoothed, as returned by GetPosition and GetViewVector.
+        ///
+        ///  \param state                   FlyStickState that is assigned the values of this Wand
+        ///
+        void GetState(FlyStickState &state);
         
     private:
         bool _tracked;
+        long long _receiveTimeNs;
+        unsigned long _frameNumber;
 
         int _rollingAverage;
-        std::list<Vector3> _previousPositions;
-        std::list<Vector3> _previousViews;
+        RollingAverage _previousPositions;
+        RollingAverage _previousViews;
 
         Vector3 _position;
         Vector3 _view;
         Vector3 _up;
         Vector3 _right;
 
+        Vector3 _velocity;
+        Vector3 _angularVelocity;
+
+        PoseFilterChain _filter;
+        PosePredictor _predictor;
+
         int _numButtons;
         bool _buttons[16];
-        double _joystickHorizontal;
-        double _joystickVertical;
+        Real _joystickHorizontal;
+        Real _joystickVertical;
     };
 }
 
@@ -0,0 +1,42 @@
+#ifndef _WANDEVENT_H
+#define _WANDEVENT_H
+///
+///  \file WandEvent.h
+///  \author  agent <agent@local>
+///  \version 1.0
+///
+///  \class MTF::WandEvent WandEvent.h "WandEvent.h"
+///  \brief A change of a Wand button or of the joystick, as seen by the tracking thread.
+///
+///  The tracking thread compares every frame with the one before and queues one event
+///  per change.  So a button press and release that both happen between two rendered
+///  frames are still seen, in order, by Monolith::PollWandEvent.
+///
+
+#include "Real.h"
+
+namespace MTF
+{
+
+    struct WandEvent
+    {
+        enum TYPE {
+            BUTTON_PRESSED,                 ///< A button was pressed, see button
+            BUTTON_RELEASED,                ///< A button was released, see button
+            JOYSTICK_MOVED                  ///< The joystick moved, see joystickHorizontal and joystickVertical
+        };
+
+        TYPE type;                          ///< What changed
+        int user;                           ///< User whose Wand changed, 0 for the Wand returned by Monolith::GetWand()
+        int button;                         ///< Index of the button for button events (as in Wand::IsButtonPressed), -1 for joystick events
+
+        Real joystickHorizontal;            ///< Horizontal joystick value after the change (-1.0 to 1.0)
+        Real joystickVertical;              ///< Vertical joystick value after the change (-1.0 to 1.0)
+
+        unsigned long frameNumber;          ///< Number of the frame the change was seen in
+        long long receiveTimeNs;            ///< Arrival time of that frame in nanoseconds since 1970
+    };
+
+}
+
+#endif
@@ -3,13 +3,13 @@
 namespace MTF
 {
     /// Interocular distance (approximately 2.5 inches) expressed in feet
-    const double IOD = 0.21;  
+    const Real IOD = 0.21;  
 
     /// Approximate value for PI
-    const double PI  = 3.14159265;
+    const Real PI  = 3.14159265;
 
 
-    Camera::Camera(Display *display, double nearPlane, double farPlane)
+    Camera::Camera(Display *display, Real nearPlane, Real farPlane)
     {
         _display = display;
 
@@ -26,7 +26,7 @@ namespace MTF
     }
 
 
-    Camera::Camera(Display *display, double nearPlane, double farPlane, Vector3 cameraPosition, double yaw, double pitch)
+    Camera::Camera(Display *display, Real nearPlane, Real farPlane, Vector3 cameraPosition, Real yaw, Real pitch)
     {
         _display = display;
 
@@ -172,25 +172,25 @@ namespace MTF
 
     Matrix4 Camera::GetProjectionMatrix(Eye::EYETYPE eye, Vector3 eyePos)
     {
-        double L = eyePos.DotProduct(_display->GetScreenRightVector());
-        double R = _display->GetScreenWidth() - L;
-        double B = eyePos.DotProduct(_display->GetScreenUpVector());
-	    double T = _display->GetScreenHeight() - B;
-
-        double distance = eyePos.AbsDotProduct(_display->GetScreenOutVector()); // This is also the focal length
-
-        double left   = -L * _nearPlane / distance;
-        double right  =  R * _nearPlane / distance;
-        double bottom = -B * _nearPlane / distance;
-        double top    =  T * _nearPlane / distance;
-
-        double a = (2.0f * _nearPlane) / (right - left);
-	    double b = (right + left) / (right - left);
-	    double c = (2.0f * _nearPlane) / (top - bottom);
-	    double d = (top + bottom) / (top - bottom);
-	    double e = -1.0f * (_farPlane + _nearPlane) / (_farPlane - _nearPlane);
-	    double f = (-2.0f * _farPlane * _nearPlane) / (_farPlane - _nearPlane);
-	    double g = -1.0f;
+        Real L = eyePos.DotProduct(_display->GetScreenRightVector());
+        Real R = _display->GetScreenWidth() - L;
+        Real B = eyePos.DotProduct(_display->GetScreenUpVector());
+	    Real T = _display->GetScreenHeight() - B;
+
+        Real distance = eyePos.AbsDotProduct(_display->GetScreenOutVector()); // This is also the focal length
+
+        Real left   = -L * _nearPlane / distance;
+        Real right  =  R * _nearPlane / distance;
+        Real bottom = -B * _nearPlane / distance;
+        Real top    =  T * _nearPlane / distance;
+
+        Real a = (2.0f * _nearPlane) / (right - left);
+	    Real b = (right + left) / (right - left);
+	    Real c = (2.0f * _nearPlane) / (top - bottom);
+	    Real d = (top + bottom) / (top - bottom);
+	    Real e = -1.0f * (_farPlane + _nearPlane) / (_farPlane - _nearPlane);
+	    Real f = (-2.0f * _farPlane * _nearPlane) / (_farPlane - _nearPlane);
+	    Real g = -1.0f;
 	
 	    Matrix4 proj = Matrix4(a, 0, b, 0,
 		                       0, c, d, 0,
@@ -201,77 +201,77 @@ namespace MTF
     }
 
 
-    void Camera::SetPitch(double pitch)
+    void Camera::SetPitch(Real pitch)
     {
         _pitch = pitch * PI / 180;
         RecalculateCameraVectors();
     }
 
 
-    void Camera::SetYaw(double yaw)
+    void Camera::SetYaw(Real yaw)
     {
         _yaw = yaw * PI / 180;
         RecalculateCameraVectors();
     }
 
 
-    void Camera::AdjustPitch(double pitch)
+    void Camera::AdjustPitch(Real pitch)
     {
         _pitch += pitch * PI / 180;
         RecalculateCameraVectors();
     }
     
 
-    void Camera::AdjustYaw(double yaw)
+    void Camera::AdjustYaw(Real yaw)
     {
         _yaw += yaw * PI / 180;
         RecalculateCameraVectors();
     }
 
  
-    double Camera::GetPitch()
+    Real Camera::GetPitch()
     {
         return _pitch * 180 / PI;
     }
 
 
-    double Camera::GetYaw()
+    Real Camera::GetYaw()
     {
         return _yaw * 180 / PI;
     }
 
 
-    void Camera::MoveForward(double amount)
+    void Camera::MoveForward(Real amount)
     {
         _cameraPosition += _cameraViewVector * amount;
     }
 
 
-    void Camera::MoveBackward(double amount)
+    void Camera::MoveBackward(Real amount)
     {
         _cameraPosition -= _cameraViewVector * amount;
     }
 
 
-    void Camera::MoveRight(double amount)
+    void Camera::MoveRight(Real amount)
     {
         _cameraPosition += _cameraRightVector * amount;
     }
 
 
-    void Camera::MoveLeft(double amount)
+    void Camera::MoveLeft(Real amount)
     {
         _cameraPosition -= _cameraRightVector * amount;
     }
 
 
-    void Camera::MoveUp(double amount)
+    void Camera::MoveUp(Real amount)
     {
         _cameraPosition += _cameraUpVector * amount;
     }
 
 
-    void Camera::MoveDown(double amount)
+    void Camera::MoveDown(Real amount)
     {
         _cameraPosition -= _cameraUpVector * amount;
     }
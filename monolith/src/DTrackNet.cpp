@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 // internal socket type
 struct _ip_socket_struct {
@@ -35,8 +36,71 @@ struct _ip_socket_struct {
 #ifdef OS_WIN
 	SOCKET ossock;	// Windows Socket
 #endif
+#ifdef DTRACKNET_RECVMMSG
+	struct mmsghdr* msgs;	// message headers for recvmmsg(), allocated on first use
+	struct iovec* iovs;		// one io vector per message header
+	char* ctrls;			// one control buffer (arrival time) per message header
+	int nmsgs;				// number of allocated message headers
+#endif
 };
 
+// Get current time on the clock used for packet arrival times
+long long udp_get_time_ns()
+{
+#ifdef OS_UNIX
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (long long )ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+#ifdef OS_WIN
+	FILETIME ft;
+	ULARGE_INTEGER t;
+	GetSystemTimeAsFileTime(&ft);
+	t.LowPart = ft.dwLowDateTime;
+	t.HighPart = ft.dwHighDateTime;
+	// 100 ns intervals since 1601-01-01 -> ns since 1970-01-01
+	return ((long long )t.QuadPart - 116444736000000000LL) * 100;
+#endif
+}
+
+#ifdef DTRACKNET_TIMESTAMPNS
+// Get kernel arrival time of a received message, -1 if not available
+static long long msg_get_time_ns(struct msghdr* msg)
+{
+	struct cmsghdr* cmsg;
+	for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
+	{
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+		{
+			struct timespec ts;
+			memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+			return (long long )ts.tv_sec * 1000000000LL + ts.tv_nsec;
+		}
+	}
+	return -1;
+}
+#endif
+
+// Wait until data are available on the socket
+static int socket_wait_readable(struct _ip_socket_struct* s, int tout_us)
+{
+	fd_set set;
+	struct timeval tout;
+	FD_ZERO(&set);
+	FD_SET(s->ossock, &set);
+	tout.tv_sec = tout_us / 1000000;
+	tout.tv_usec = tout_us % 1000000;
+	switch (select(FD_SETSIZE, &set, NULL, NULL, &tout))
+	{
+		case 1:
+			return 0;     // data available
+		case 0:
+			return -1;    // timeout
+		default:
+			return -2;    // error
+	}
+}
+
 // Convert string (with IP address or hostname) to IP address
 unsigned int ip_name2ip(const char* name)
 {
@@ -77,6 +141,12 @@ int udp_init(void** sock, unsigned short* port, unsigned int ip)
 	{
 		return -11;
 	}
+#ifdef DTRACKNET_RECVMMSG
+	s->msgs = NULL;
+	s->iovs = NULL;
+	s->ctrls = NULL;
+	s->nmsgs = 0;
+#endif
 	// initialize socket dll (only Windows):
 #ifdef OS_WIN
 	{
@@ -129,6 +199,16 @@ int udp_init(void** sock, unsigned short* port, unsigned int ip)
 		udp_exit(s);
 		return -3;
 	}
+#ifdef DTRACKNET_TIMESTAMPNS
+	{
+		// let the kernel record the arrival time of each packet
+		int flag_on = 1;
+		if ((setsockopt(s->ossock, SOL_SOCKET, SO_TIMESTAMPNS, (char*)&flag_on, sizeof(flag_on))) < 0)
+		{
+			perror("setsockopt() failed4");
+		}
+	}
+#endif
 	if (*port == 0)
 	{
 		// port number was chosen by the OS
@@ -184,6 +264,11 @@ int udp_exit(void* sock, unsigned int ip)
 #ifdef OS_WIN
 	err = closesocket(s->ossock);
 	WSACleanup();
+#endif
+#ifdef DTRACKNET_RECVMMSG
+	free(s->msgs);
+	free(s->iovs);
+	free(s->ctrls);
 #endif
 	free(sock);
 	if(err < 0)
@@ -221,7 +306,6 @@ int udp_receive(const void* sock, void *buffer, int maxlen, int tout_us)
 		nbytes = recv(s->ossock, (char *)buffer, maxlen, 0);
 		if (nbytes < 0)
 		{	// receive error
-            printf("Didn't Recieve packet, wsa error: %i\n", WSAGetLastError());
 			return -3;
 		}
 		// check, if more data available: if so, receive another packet
@@ -242,6 +326,137 @@ int udp_receive(const void* sock, void *buffer, int maxlen, int tout_us)
 	}
 }
 
+// Receive all queued UDP packets at once.
+int udp_receive_batch(const void* sock, void** buffers, int* lens, long long* times_ns, int maxlen, int count, int tout_us)
+{
+	int i, err;
+	struct _ip_socket_struct* s = (struct _ip_socket_struct *)sock;
+	if (count <= 0)
+	{
+		return -2;
+	}
+	// waiting for data:
+	if ((err = socket_wait_readable(s, tout_us)) < 0)
+	{
+		return err;
+	}
+#ifdef DTRACKNET_RECVMMSG
+	const int ctrllen = CMSG_SPACE(sizeof(struct timespec));
+	// (re)allocate message headers, only if the batch size grows:
+	if (count > s->nmsgs)
+	{
+		free(s->msgs);
+		free(s->iovs);
+		free(s->ctrls);
+		s->msgs = (struct mmsghdr *)calloc(count, sizeof(struct mmsghdr));
+		s->iovs = (struct iovec *)calloc(count, sizeof(struct iovec));
+		s->ctrls = (char *)calloc(count, ctrllen);
+		if (s->msgs == NULL || s->iovs == NULL || s->ctrls == NULL)
+		{
+			free(s->msgs);
+			free(s->iovs);
+			free(s->ctrls);
+			s->msgs = NULL;
+			s->iovs = NULL;
+			s->ctrls = NULL;
+			s->nmsgs = 0;
+			return -11;
+		}
+		s->nmsgs = count;
+	}
+	for (i = 0; i < count; i++)
+	{
+		s->iovs[i].iov_base = buffers[i];
+		s->iovs[i].iov_len = maxlen;
+		memset(&s->msgs[i].msg_hdr, 0, sizeof(struct msghdr));
+		s->msgs[i].msg_hdr.msg_iov = &s->iovs[i];
+		s->msgs[i].msg_hdr.msg_iovlen = 1;
+		s->msgs[i].msg_hdr.msg_control = s->ctrls + i * ctrllen;
+		s->msgs[i].msg_hdr.msg_controllen = ctrllen;
+	}
+	// receiving all queued packets with one system call:
+	err = recvmmsg(s->ossock, s->msgs, count, MSG_DONTWAIT, NULL);
+	if (err <= 0)
+	{	// receive error
+		return -3;
+	}
+	for (i = 0; i < err; i++)
+	{
+		lens[i] = (int )s->msgs[i].msg_len;
+		if ((s->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) || lens[i] >= maxlen)
+		{	// buffer overflow
+			lens[i] = -4;
+		}
+		if (times_ns)
+		{
+			times_ns[i] = msg_get_time_ns(&s->msgs[i].msg_hdr);
+			if (times_ns[i] < 0)
+			{	// kernel did not deliver a timestamp
+				times_ns[i] = udp_get_time_ns();
+			}
+		}
+	}
+	return err;
+#else
+	// receiving packets one by one, as long as data are available:
+	for (i = 0; i < count; i++)
+	{
+		int len = recv(s->ossock, (char *)buffers[i], maxlen, 0);
+		if (len < 0)
+		{	// receive error, lens[] of an earlier batch are left as they are
+			return (i > 0) ? i : -3;
+		}
+		lens[i] = len;
+		if (lens[i] >= maxlen)
+		{	// buffer overflow
+			lens[i] = -4;
+		}
+		if (times_ns)
+		{
+			times_ns[i] = udp_get_time_ns();
+		}
+		// check, if more data available: if so, receive another packet
+		if (socket_wait_readable(s, 0) != 0)
+		{
+			return i + 1;
+		}
+	}
+	return count;
+#endif
+}
+
+// Wait until UDP data are available on at least one of several sockets.
+int udp_wait_any(void** socks, int* ready, int count, int tout_us)
+{
+	int i, err;
+	fd_set set;
+	struct timeval tout;
+	struct _ip_socket_struct* s;
+	FD_ZERO(&set);
+	for (i = 0; i < count; i++)
+	{
+		s = (struct _ip_socket_struct *)socks[i];
+		FD_SET(s->ossock, &set);
+	}
+	tout.tv_sec = tout_us / 1000000;
+	tout.tv_usec = tout_us % 1000000;
+	err = select(FD_SETSIZE, &set, NULL, NULL, &tout);
+	if (err == 0)
+	{
+		return -1;    // timeout
+	}
+	if (err < 0)
+	{
+		return -2;    // error
+	}
+	for (i = 0; i < count; i++)
+	{
+		s = (struct _ip_socket_struct *)socks[i];
+		ready[i] = FD_ISSET(s->ossock, &set) ? 1 : 0;
+	}
+	return err;
+}
+
 // Send UDP data
 int udp_send(const void* sock, void* buffer, int len, unsigned int ipaddr, unsigned short port, int tout_us)
 {
@@ -292,6 +507,12 @@ int tcp_client_init(void** sock, unsigned int ip, unsigned short port)
 	{
 		return -11;
 	}
+#ifdef DTRACKNET_RECVMMSG
+	s->msgs = NULL;
+	s->iovs = NULL;
+	s->ctrls = NULL;
+	s->nmsgs = 0;
+#endif
 	// initialize socket dll (only Windows):
 #ifdef OS_WIN
 	{
@@ -351,6 +572,11 @@ int tcp_exit(void* sock)
 #ifdef OS_WIN
 	err = closesocket(s->ossock);
 	WSACleanup();
+#endif
+#ifdef DTRACKNET_RECVMMSG
+	free(s->msgs);
+	free(s->iovs);
+	free(s->ctrls);
 #endif
 	free(sock);
 	if (err < 0)
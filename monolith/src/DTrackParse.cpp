@@ -24,11 +24,29 @@
 
 #include "DTrackParse.hpp"
 
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define DTRACK_SCAN_WIDTH 32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DTRACK_SCAN_WIDTH 16
+#endif
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
 // Parsing DTrack data
-char* string_nextline(char* str, char* start, int len)
+//
+// The functions taking an end pointer read nothing at or behind it and never change the
+// buffer, so they also work on data the caller only may read (a memory-mapped file, for
+// example).  The older ones read strings up to their terminating '\0'.
+
+// Search next line in buffer, not reading behind str + len
+static const char* string_find_nextline(const char* str, const char* start, int len)
 {
-	char* s = start;
-	char* se = str + len;
+	const char* s = start;
+	const char* se = str + len;
 	int crlffound = 0;
 	while (s < se)
 	{
@@ -46,89 +64,617 @@ char* string_nextline(char* str, char* start, int len)
 	return NULL;	// no new line found in buffer
 }
 
+// Search next line in buffer
+char* string_nextline(char* str, char* start, int len)
+{
+	return (char* )string_find_nextline(str, start, len);
+}
+
+// Fast parsing of the numbers DTrack sends
+//
+// DTrack writes plain decimal numbers like '-1234.567' or '0.999876'.  These are read
+// here directly, without the locale handling of strtol()/strtod().  Anything else (hex,
+// octal, 'inf', long mantissas, large exponents, other white space) is left to the C
+// library, so the results are always the same as before.
+
+// Powers of ten that are exact as 'double'
+static const double string_pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Longest number handed to the C library when the string has no '\0' at its end
+#define STRING_NUMBER_MAX	64
+
+// Whether s is a character of the string.  Without checkend the string has to end at a
+// character that can't be part of a number, like the ']' of a block or the final '\0'.
+static inline int string_more(const char* s, const char* end, int checkend)
+{
+	return !checkend || (s < end);
+}
+
+// Read a decimal integer with at most 9 digits; NULL if the C library has to do it
+static inline const char* string_parse_decimal(const char* str, const char* end, int checkend, int allowsign, int* i)
+{
+	const char* s = str;
+	int neg = 0;
+	int digits = 0;
+	int value = 0;
+
+	while (string_more(s, end, checkend) && *s == ' ') {
+		s++;
+	}
+	if (allowsign && string_more(s, end, checkend) && (*s == '-' || *s == '+')) {
+		neg = (*s == '-');
+		s++;
+	}
+	if (string_more(s + 1, end, checkend) && *s == '0' && ((s[1] >= '0' && s[1] <= '9') || s[1] == 'x' || s[1] == 'X')) {
+		return NULL;	// octal or hex number
+	}
+	while (string_more(s, end, checkend) && *s >= '0' && *s <= '9') {
+		if (++digits > 9) {
+			return NULL;	// could overflow
+		}
+		value = value * 10 + (*s++ - '0');
+	}
+	if (digits == 0) {
+		return NULL;
+	}
+	*i = neg ? -value : value;
+	return s;
+}
+
+// Read a decimal number with at most 15 significant digits and a power of ten up to 22,
+// NULL if the C library has to do it.  Mantissa and power of ten are both exact as 'double',
+// so the single multiplication or division is rounded correctly, like strtod() does.  That
+// only holds if the computation is done in 'double'; the x87 FPU rounds to its own precision
+// first, so there the C library does it.
+static inline const char* string_parse_double(const char* str, const char* end, int checkend, double* d)
+{
+#if !(defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ == 0))
+	(void )str;
+	(void )end;
+	(void )checkend;
+	(void )d;
+	return NULL;
+#else
+	const char* s = str;
+	const char* e;
+	int neg = 0;
+	int digits = 0;
+	int anydigit = 0;
+	int exp10 = 0;
+	int expval = 0;
+	int expneg = 0;
+	unsigned long long mant = 0;
+	double value;
+
+	while (string_more(s, end, checkend) && *s == ' ') {
+		s++;
+	}
+	if (string_more(s, end, checkend) && (*s == '-' || *s == '+')) {
+		neg = (*s == '-');
+		s++;
+	}
+	while (string_more(s, end, checkend) && *s >= '0' && *s <= '9') {
+		anydigit = 1;
+		if (mant != 0 || *s != '0') {	// leading zeros are not significant
+			if (++digits > 15) {
+				return NULL;
+			}
+			mant = mant * 10 + (*s - '0');
+		}
+		s++;
+	}
+	if (string_more(s, end, checkend) && *s == '.') {
+		s++;
+		while (string_more(s, end, checkend) && *s >= '0' && *s <= '9') {
+			anydigit = 1;
+			if (mant != 0 || *s != '0') {
+				if (++digits > 15) {
+					return NULL;
+				}
+				mant = mant * 10 + (*s - '0');
+			}
+			exp10--;
+			s++;
+		}
+	}
+	if (!anydigit || (string_more(s, end, checkend) && (*s == 'x' || *s == 'X'))) {
+		return NULL;	// no number, or a hex number
+	}
+	if (string_more(s, end, checkend) && (*s == 'e' || *s == 'E')) {
+		e = s + 1;
+		if (string_more(e, end, checkend) && (*e == '-' || *e == '+')) {
+			expneg = (*e == '-');
+			e++;
+		}
+		if (string_more(e, end, checkend) && *e >= '0' && *e <= '9') {	// otherwise the 'e' is not part of the number
+			while (string_more(e, end, checkend) && *e >= '0' && *e <= '9') {
+				if (expval < 1000) {
+					expval = expval * 10 + (*e - '0');
+				}
+				e++;
+			}
+			exp10 += expneg ? -expval : expval;
+			s = e;
+		}
+	}
+
+	value = (double )mant;
+	if (mant != 0 && exp10 != 0) {
+		if (exp10 < -22 || exp10 > 22) {
+			return NULL;
+		}
+		if (exp10 < 0) {
+			value /= string_pow10[-exp10];
+		} else {
+			value *= string_pow10[exp10];
+		}
+	}
+	*d = neg ? -value : value;
+	return s;
+#endif
+}
+
+// Copy the start of str with a '\0' behind it, as the C library needs it
+static char* string_copy_number(const char* str, const char* end, char* copy)
+{
+	int len = (end > str) ? (int )(end - str) : 0;
+	if (len > STRING_NUMBER_MAX - 1) {
+		len = STRING_NUMBER_MAX - 1;
+	}
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+	return copy;
+}
+
 // Read next 'int' value from string
 char* string_get_i(char* str, int* i)
 {
-	char* s;
+	char* s = (char* )string_parse_decimal(str, NULL, 0, 1, i);
+	if (s) {
+		return s;
+	}
 	*i = (int )strtol(str, &s, 0);
 	return (s == str) ? NULL : s;
 }
 
+// Read next 'int' value from string, not reading behind end (see string_more())
+static inline const char* string_read_i(const char* str, const char* end, int checkend, int* i)
+{
+	char copy[STRING_NUMBER_MAX];
+	char* s;
+	const char* p = string_parse_decimal(str, end, checkend, 1, i);
+	if (p) {
+		return p;
+	}
+	*i = (int )strtol(string_copy_number(str, end, copy), &s, 0);
+	return (s == copy) ? NULL : str + (s - copy);
+}
+
+// Read next 'int' value from string, not reading behind end
+const char* string_get_i(const char* str, const char* end, int* i)
+{
+	return string_read_i(str, end, 1, i);
+}
+
 // Read next 'unsigned int' value from string
 char* string_get_ui(char* str, unsigned int* ui)
 {
-	char* s;
+	int i;
+	char* s = (char* )string_parse_decimal(str, NULL, 0, 0, &i);
+	if (s) {
+		*ui = (unsigned int )i;
+		return s;
+	}
 	*ui = (unsigned int )strtoul(str, &s, 0);
 	return (s == str) ? NULL : s;
 }
 
+// Read next 'unsigned int' value from string, not reading behind end (see string_more())
+static inline const char* string_read_ui(const char* str, const char* end, int checkend, unsigned int* ui)
+{
+	char copy[STRING_NUMBER_MAX];
+	char* s;
+	int i;
+	const char* p = string_parse_decimal(str, end, checkend, 0, &i);
+	if (p) {
+		*ui = (unsigned int )i;
+		return p;
+	}
+	*ui = (unsigned int )strtoul(string_copy_number(str, end, copy), &s, 0);
+	return (s == copy) ? NULL : str + (s - copy);
+}
+
+// Read next 'unsigned int' value from string, not reading behind end
+const char* string_get_ui(const char* str, const char* end, unsigned int* ui)
+{
+	return string_read_ui(str, end, 1, ui);
+}
+
 // Read next 'double' value from string
 char* string_get_d(char* str, double* d)
 {
-	char* s;
+	char* s = (char* )string_parse_double(str, NULL, 0, d);
+	if (s) {
+		return s;
+	}
 	*d = strtod(str, &s);
 	return (s == str) ? NULL : s;
 }
 
-// Read next 'float' value from string
-char* string_get_f(char* str, float* f)
+// Read next 'double' value from string, not reading behind end (see string_more())
+static inline const char* string_read_d(const char* str, const char* end, int checkend, double* d)
 {
+	char copy[STRING_NUMBER_MAX];
 	char* s;
-	*f = (float )strtod(str, &s);	// strtof() only available in GNU-C
-	return (s == str) ? NULL : s;
+	const char* p = string_parse_double(str, end, checkend, d);
+	if (p) {
+		return p;
+	}
+	*d = strtod(string_copy_number(str, end, copy), &s);
+	return (s == copy) ? NULL : str + (s - copy);
 }
 
-// Process next block '[...]' in string
-char* string_get_block(char* str, const char* fmt, int* idat, float* fdat, double *ddat)
+// Read next 'double' value from string, not reading behind end
+const char* string_get_d(const char* str, const char* end, double* d)
 {
-	char* strend;
-	int index_i, index_f;
-	if ((str = strchr(str, '[')) == NULL)
-	{       // search begin of block
-		return NULL;
+	return string_read_d(str, end, 1, d);
+}
+
+// Read next 'float' value from string
+char* string_get_f(char* str, float* f)
+{
+	double d;
+	char* s = string_get_d(str, &d);	// strtof() only available in GNU-C
+	if (s) {
+		*f = (float )d;
 	}
-	if ((strend = strchr(str, ']')) == NULL)
-	{    // search end of block
-		return NULL;
+	return s;
+}
+
+// Read next 'float' value from string, not reading behind end
+const char* string_get_f(const char* str, const char* end, float* f)
+{
+	double d;
+	const char* s = string_get_d(str, end, &d);
+	if (s) {
+		*f = (float )d;
 	}
-	str++;                               // remove delimiters
-	*strend = '\0';
+	return s;
+}
+
+// Read the values of a block, str behind its '[' and strend at its ']'; the ']' ends every number
+static const char* string_read_block(const char* str, const char* strend, const char* fmt, int* idat, float* fdat, double *ddat)
+{
+	int index_i, index_f;
 	index_i = index_f = 0;
 	while(*fmt)
 	{
 		switch(*fmt++)
 		{
 			case 'i':
-				if((str = string_get_i(str, &idat[index_i++])) == NULL)
+				if((str = string_read_i(str, strend, 0, &idat[index_i++])) == NULL)
 				{
-					*strend = ']';
 					return NULL;
 				}
 				break;
 			case 'f':
-				if((str = string_get_f(str, &fdat[index_f++])) == NULL)
+				if((str = string_get_f(str, strend, &fdat[index_f++])) == NULL)
 				{
-					*strend = ']';
 					return NULL;
 				}
 				break;
 			case 'd':
-				if((str = string_get_d(str, &ddat[index_f++])) == NULL)
+				if((str = string_read_d(str, strend, 0, &ddat[index_f++])) == NULL)
 				{
-					*strend = ']';
 					return NULL;
 				}
 				break;
 			default:	// unknown format character
-				*strend = ']';
 				return NULL;
 		}
 	}
 	// ignore additional data inside the block
-	*strend = ']';
 	return strend + 1;
 }
 
+// Process next block '[...]' in string
+char* string_get_block(char* str, const char* fmt, int* idat, float* fdat, double *ddat)
+{
+	char* strend;
+	if ((str = strchr(str, '[')) == NULL)
+	{       // search begin of block
+		return NULL;
+	}
+	if ((strend = strchr(str, ']')) == NULL)
+	{    // search end of block
+		return NULL;
+	}
+	return (char* )string_read_block(str + 1, strend, fmt, idat, fdat, ddat);	// remove delimiters
+}
+
+// Index of lines and blocks
+//
+// With SIMD instructions, string_index() reads the buffer once and notes where the string
+// ends, where lines start and where blocks begin and end.  Afterwards string_nextline() and
+// string_get_block() only look these up, instead of searching the buffer again for every
+// line and block.
+
+// Number of the lowest bit set in a non-zero mask
+static inline int string_lowest_bit(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long bit;
+	_BitScanForward(&bit, mask);
+	return (int )bit;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+// Append the offset of every bit set in mask, counted from pos
+static inline int* string_index_bits(int* offsets, int pos, unsigned int mask)
+{
+	while (mask) {
+		*offsets++ = pos + string_lowest_bit(mask);
+		mask &= mask - 1;
+	}
+	return offsets;
+}
+
+#ifdef DTRACK_SCAN_WIDTH
+// Bit masks of line ends, '[', ']' and '\0' in the next DTRACK_SCAN_WIDTH bytes
+static inline void string_scan(const char* p, unsigned int* newline, unsigned int* open, unsigned int* close, unsigned int* zero)
+{
+#if DTRACK_SCAN_WIDTH == 32
+	__m256i v = _mm256_loadu_si256((const __m256i* )p);
+	*newline = (unsigned int )_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+	                                                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+	*open = (unsigned int )_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')));
+	*close = (unsigned int )_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(']')));
+	*zero = (unsigned int )_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+#else
+	__m128i v = _mm_loadu_si128((const __m128i* )p);
+	*newline = (unsigned int )_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+	                                                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+	*open = (unsigned int )_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')));
+	*close = (unsigned int )_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+	*zero = (unsigned int )_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+#endif
+}
+
+// Note the offsets of all line starts and delimiters, DTRACK_SCAN_WIDTH characters at a time;
+// the string ends at the first '\0', which shortens index->len
+static void string_index_scan(DTrack_Index_Type* index)
+{
+	const unsigned int all = (DTRACK_SCAN_WIDTH == 32) ? 0xffffffffu : ((1u << DTRACK_SCAN_WIDTH) - 1);
+	const char* buf = index->buf;
+	int len = index->len;
+	int pos = 0;
+	unsigned int lastnewline = 0;	// whether the character before pos ends a line
+	unsigned int newline, open, close, zero, valid;
+	int *line, *openpos, *closepos;
+	char c;
+
+	// there can't be more lines or delimiters than characters, so the arrays are only checked here
+	if ((int )index->line.size() < len + 1) {
+		index->line.resize(len + 1);
+		index->open.resize(len + 1);
+		index->close.resize(len + 1);
+	}
+	line = &index->line[0];
+	openpos = &index->open[0];
+	closepos = &index->close[0];
+
+	while (pos + DTRACK_SCAN_WIDTH <= len) {
+		string_scan(buf + pos, &newline, &open, &close, &zero);
+		valid = all;
+		if (zero) {	// only what is in front of the '\0' counts
+			valid = (1u << string_lowest_bit(zero)) - 1;
+			len = pos + string_lowest_bit(zero);
+		}
+
+		// a line starts at the first character that is no line end, after a line end
+		line = string_index_bits(line, pos, ~newline & ((newline << 1) | lastnewline) & valid);
+		openpos = string_index_bits(openpos, pos, open & valid);
+		closepos = string_index_bits(closepos, pos, close & valid);
+
+		if (zero) {	// nothing is left for the loop below
+			pos = len;
+			break;
+		}
+		lastnewline = (newline >> (DTRACK_SCAN_WIDTH - 1)) & 1;
+		pos += DTRACK_SCAN_WIDTH;
+	}
+
+	for (; pos < len; pos++) {	// the rest, shorter than DTRACK_SCAN_WIDTH
+		c = buf[pos];
+		if (c == '\0') {
+			len = pos;
+			break;
+		}
+		if (c == '\r' || c == '\n') {
+			lastnewline = 1;
+			continue;
+		}
+		if (lastnewline) {
+			*line++ = pos;
+			lastnewline = 0;
+		}
+		if (c == '[') {
+			*openpos++ = pos;
+		} else if (c == ']') {
+			*closepos++ = pos;
+		}
+	}
+
+	index->len = len;
+	index->num_line = (int )(line - &index->line[0]);
+	index->num_open = (int )(openpos - &index->open[0]);
+	index->num_close = (int )(closepos - &index->close[0]);
+}
+#endif
+
+// Find all lines and blocks '[...]' in buffer, in one pass
+void string_index(const char* buf, int len, DTrack_Index_Type* index)
+{
+	index->buf = buf;
+	index->len = len;
+	index->num_line = index->num_open = index->num_close = 0;
+	index->nextline = index->nextopen = index->nextclose = 0;
+
+#ifdef DTRACK_SCAN_WIDTH
+	string_index_scan(index);	// also finds where the string ends, as it may end before the buffer
+#else
+	// without SIMD instructions the C library searches faster than a loop over all characters,
+	// so string_nextline() and string_get_block() search the buffer as before, up to the '\0'
+	const char* end = (const char* )memchr(buf, '\0', len);
+	if (end) {
+		index->len = (int )(end - buf);
+	}
+#endif
+}
+
+// Find the first offset behind pos, starting at *next; going back starts the search over
+static inline int string_index_find(const std::vector<int>& offsets, int n, int* next, int pos)
+{
+	int i = *next;
+	if (i > 0 && i <= n && offsets[i - 1] > pos) {
+		i = 0;
+	}
+	while (i < n && offsets[i] <= pos) {
+		i++;
+	}
+	*next = i;
+	return (i < n) ? offsets[i] : -1;
+}
+
+// Search next line in indexed buffer
+const char* string_nextline(DTrack_Index_Type* index, const char* start)
+{
+#ifdef DTRACK_SCAN_WIDTH
+	int pos = string_index_find(index->line, index->num_line, &index->nextline, (int )(start - index->buf));
+	return (pos < 0) ? NULL : index->buf + pos;
+#else
+	return string_find_nextline(index->buf, start, index->len);
+#endif
+}
+
+// Search next block '[...]' in indexed buffer; returns the position behind its '[' and sets strend to its ']'
+static inline const char* string_find_block(DTrack_Index_Type* index, const char* str, const char** strend)
+{
+#ifdef DTRACK_SCAN_WIDTH
+	int begin, end;
+	if ((begin = string_index_find(index->open, index->num_open, &index->nextopen, (int )(str - index->buf) - 1)) < 0)
+	{	// search begin of block
+		return NULL;
+	}
+	if ((end = string_index_find(index->close, index->num_close, &index->nextclose, begin)) < 0)
+	{	// search end of block
+		return NULL;
+	}
+	*strend = index->buf + end;
+	return index->buf + begin + 1;
+#else
+	const char* bufend = index->buf + index->len;
+	if ((str = (const char* )memchr(str, '[', bufend - str)) == NULL)
+	{	// search begin of block
+		return NULL;
+	}
+	if ((*strend = (const char* )memchr(str, ']', bufend - str)) == NULL)
+	{	// search end of block
+		return NULL;
+	}
+	return str + 1;
+#endif
+}
+
+// Process next block '[...]' in indexed buffer
+const char* string_get_block(DTrack_Index_Type* index, const char* str, const char* fmt, int* idat, float* fdat, double *ddat)
+{
+	const char* strend;
+	if ((str = string_find_block(index, str, &strend)) == NULL)
+	{
+		return NULL;
+	}
+	return string_read_block(str, strend, fmt, idat, fdat, ddat);
+}
+
+// Skip the next n blocks '[...]' in indexed buffer
+const char* string_skip_blocks(DTrack_Index_Type* index, const char* str, int n)
+{
+	const char* strend;
+	while (n-- > 0)
+	{
+		if ((str = string_find_block(index, str, &strend)) == NULL)
+		{
+			return NULL;
+		}
+		str = strend + 1;
+	}
+	return str;
+}
+
+// Process next block '[...]' of N 'double' values in indexed buffer
+template<int N>
+const char* string_get_block_d(DTrack_Index_Type* index, const char* str, double* ddat)
+{
+	const char* strend;
+	int i;
+	if ((str = string_find_block(index, str, &strend)) == NULL)
+	{
+		return NULL;
+	}
+	for (i = 0; i < N; i++)
+	{
+		if ((str = string_read_d(str, strend, 0, &ddat[i])) == NULL)
+		{
+			return NULL;
+		}
+	}
+	// ignore additional data inside the block
+	return strend + 1;
+}
+
+template const char* string_get_block_d<3>(DTrack_Index_Type* index, const char* str, double* ddat);
+template const char* string_get_block_d<6>(DTrack_Index_Type* index, const char* str, double* ddat);
+template const char* string_get_block_d<9>(DTrack_Index_Type* index, const char* str, double* ddat);
+
+// Process next block '[...]' of an 'int', a 'double' and N more 'int' values in indexed buffer
+template<int N>
+const char* string_get_block_id(DTrack_Index_Type* index, const char* str, int* idat, double* d)
+{
+	const char* strend;
+	int i;
+	if ((str = string_find_block(index, str, &strend)) == NULL)
+	{
+		return NULL;
+	}
+	if ((str = string_read_i(str, strend, 0, &idat[0])) == NULL)
+	{
+		return NULL;
+	}
+	if ((str = string_read_d(str, strend, 0, d)) == NULL)
+	{
+		return NULL;
+	}
+	for (i = 1; i <= N; i++)
+	{
+		if ((str = string_read_i(str, strend, 0, &idat[i])) == NULL)
+		{
+			return NULL;
+		}
+	}
+	// ignore additional data inside the block
+	return strend + 1;
+}
+
+template const char* string_get_block_id<0>(DTrack_Index_Type* index, const char* str, int* idat, double* d);
+template const char* string_get_block_id<1>(DTrack_Index_Type* index, const char* str, int* idat, double* d);
+template const char* string_get_block_id<2>(DTrack_Index_Type* index, const char* str, int* idat, double* d);
+
 // Read next 'word' value from string
 char* string_get_word(char* str, std::string& w)
 {
@@ -33,6 +33,7 @@
 
 #include "DTrackSDK.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -60,6 +61,12 @@ DTrackSDK::DTrackSDK(const std::string& server_host, unsigned short server_port,
 	init(SYS_DTRACK_UNKNOWN, server_host, server_port, data_port);
 }
 
+// Constructor (without network)
+DTrackSDK::DTrackSDK()
+{
+	init(SYS_DTRACK_UNKNOWN, "", 0, 0, 0);
+}
+
 //	Init function, called from constructor.
 void DTrackSDK::init(RemoteSystemType sysType, const std::string& server_host, unsigned short server_port, unsigned short data_port,
 		int data_bufsize, int data_timeout_us, int server_timeout_us
@@ -71,6 +78,15 @@ void DTrackSDK::init(RemoteSystemType sysType, const std::string& server_host, u
 	d_udpsock = NULL;
 	d_tcpsock = NULL;
 	d_udpbuf = NULL;
+	d_udpnum = d_udpnext = 0;
+	d_receivemode = RECEIVE_NEWEST;
+	d_udpfetched = d_udpprocessed = 0;
+	memset(&d_statistics, 0, sizeof(d_statistics));
+	act_lastframecounter = 0;
+	d_subscription.types = DTRACK_DATA_ALL;
+	d_frame.generation = d_frame.body.generation = d_frame.hand.generation = 0;
+	d_packethandler = NULL;
+	d_packetcontext = NULL;
 
 	lastDataError = ERR_NONE;
 	lastServerError = ERR_NONE;
@@ -86,6 +102,27 @@ void DTrackSDK::init(RemoteSystemType sysType, const std::string& server_host, u
 		d_remote_ip = ip_name2ip(server_host.c_str());
 	}
 
+	// reset actual DTrack data:
+	act_framecounter = 0;
+	act_timestamp = -1;
+	act_receivetime_ns = -1;
+
+	act_num_body = act_num_flystick = act_num_meatool = act_num_hand = 0;
+	act_num_marker = 0;
+
+	d_message_origin = "";
+	d_message_status = "";
+	d_message_framenr = 0;
+	d_message_errorid = 0;
+	d_message_msg = "";
+
+	// no sockets, if packets are only processed with receivePacket():
+	d_udpport = 0;
+	d_udpbufsize = 0;
+	if (data_bufsize <= 0) {
+		return;
+	}
+
 	// create UDP socket:
 	d_udpport = data_port;
 
@@ -100,15 +137,20 @@ void DTrackSDK::init(RemoteSystemType sysType, const std::string& server_host, u
 		return;
 	}
 
-	// create UDP buffer:
+	// create UDP buffer (one block for all packets of a batch):
 	d_udpbufsize = data_bufsize;
-	d_udpbuf = (char *)malloc(data_bufsize);
+	d_udpbuf = (char *)malloc(data_bufsize * DTRACK_UDP_BATCH);
 	if (!d_udpbuf) {
 		udp_exit(d_udpsock);
 		d_udpsock = NULL;
 		d_udpport = 0;
 		return;
 	}
+	for (int i = 0; i < DTRACK_UDP_BATCH; i++) {
+		d_udpbufs[i] = d_udpbuf + i * data_bufsize;
+		d_udplens[i] = 0;
+		d_udptimes[i] = -1;
+	}
 
 	if ((d_remote_ip != 0) && (server_port == 0)) { // multicast
 		d_remoteport = 0;
@@ -129,18 +171,6 @@ void DTrackSDK::init(RemoteSystemType sysType, const std::string& server_host, u
 			}
 		}
 	}
-	// reset actual DTrack data:
-	act_framecounter = 0;
-	act_timestamp = -1;
-
-	act_num_body = act_num_flystick = act_num_meatool = act_num_hand = 0;
-	act_num_marker = 0;
-
-	d_message_origin = "";
-	d_message_status = "";
-	d_message_framenr = 0;
-	d_message_errorid = 0;
-	d_message_msg = "";
 }
 
 // Destructor
@@ -218,107 +248,357 @@ bool DTrackSDK::isTCPValid()
 // Receive and process one DTrack data packet (UDP; ASCII protocol)
 bool DTrackSDK::receive()
 {
-	char* s;
-	int i, j, k, l, n, len, id;
-	char sfmt[20];
-	int iarr[3];
-	double d, darr[6];
-	int loc_num_bodycal, loc_num_handcal, loc_num_flystick1, loc_num_meatool;
+	int n, m, index, len;
 
 	lastDataError = ERR_NONE;
 	lastServerError = ERR_NONE;
 
 	if (!isUDPValid()) {
 		lastDataError = ERR_NET;
-        printf("d_udpsock is null\n");
+		d_statistics.net_errors++;
 		return false;
 	}
-	// defaults:
-	act_framecounter = 0;
-	act_timestamp = -1;   // i.e. not available
-	loc_num_bodycal = loc_num_handcal = -1;  // i.e. not available
-	loc_num_flystick1 = loc_num_meatool = 0;
-
-	// receive UDP packet:
-	len = udp_receive(d_udpsock, d_udpbuf, d_udpbufsize-1, d_udptimeout_us);
-	if (len == -1) {
-		lastDataError = ERR_TIMEOUT;
-		return false;
+
+	if ((d_receivemode == RECEIVE_ALL) && (d_udpnext < d_udpnum)) {
+		// packet already fetched with the last system call
+		index = d_udpnext++;
+	} else {
+		// receive all queued UDP packets (those left from RECEIVE_ALL mode are skipped):
+		d_udpnum = d_udpnext = 0;
+		n = udp_receive_batch(d_udpsock, (void** )d_udpbufs, d_udplens, d_udptimes, d_udpbufsize-1, DTRACK_UDP_BATCH, d_udptimeout_us);
+		handlePackets(n);
+		if (d_receivemode == RECEIVE_NEWEST) {
+			// batch was full, so even newer packets may be waiting
+			while (n == DTRACK_UDP_BATCH) {
+				m = udp_receive_batch(d_udpsock, (void** )d_udpbufs, d_udplens, d_udptimes, d_udpbufsize-1, DTRACK_UDP_BATCH, 0);
+				if (m < 0) {  // no more data, or an error: last batch is still valid
+					break;
+				}
+				d_udpfetched += n;  // older batch is skipped
+				n = m;
+				handlePackets(n);
+			}
+		}
+		if (n == -1) {
+			lastDataError = ERR_TIMEOUT;
+			d_statistics.timeouts++;
+			return false;
+		}
+
+		if (n <= 0) {
+			d_udpnum = d_udpnext = 0;
+			lastDataError = ERR_NET;
+			d_statistics.net_errors++;
+			return false;
+		}
+		d_udpnum = n;
+		d_udpfetched += n;
+		if (d_receivemode == RECEIVE_NEWEST) {
+			index = n - 1;
+			d_udpnext = n;
+		} else {
+			index = 0;
+			d_udpnext = 1;
+		}
 	}
 
+	d_udpprocessed++;
+	len = d_udplens[index];
 	if (len <= 0) {
 		lastDataError = ERR_NET;
-        printf("udp_recieve: %i\n", len);
+		d_statistics.net_errors++;
 		return false;
 	}
 
-	s = d_udpbuf;
-	s[len] = '\0';
+	act_receivetime_ns = d_udptimes[index];
+	return processPacket(d_udpbufs[index], len);
+}
 
-	// process lines:
-	lastDataError = ERR_PARSE;
+// Set how packets queued since the last call of receive() are handled.
+void DTrackSDK::setReceiveMode(ReceiveMode mode)
+{
+	d_receivemode = mode;
+}
+
+// Get how packets queued since the last call of receive() are handled.
+DTrackSDK::ReceiveMode DTrackSDK::getReceiveMode()
+{
+	return d_receivemode;
+}
+
+// Set which data is parsed from the packets.
+void DTrackSDK::setSubscription(const DTrack_Subscription_Type& subscription)
+{
+	d_subscription = subscription;
+}
+
+// Get which data is parsed from the packets.
+DTrack_Subscription_Type DTrackSDK::getSubscription()
+{
+	return d_subscription;
+}
+
+// Pass the packets of the last system call to the packet handler.
+void DTrackSDK::handlePackets(int n)
+{
+	if (d_packethandler == NULL)
+		return;
+
+	for (int i = 0; i < n; i++) {
+		if (d_udplens[i] > 0)
+			d_packethandler(d_packetcontext, d_udpbufs[i], d_udplens[i], d_udptimes[i]);
+	}
+}
+
+// Set a function to be called with every UDP packet fetched from the socket.
+void DTrackSDK::setPacketHandler(PacketHandler handler, void* context)
+{
+	d_packethandler = handler;
+	d_packetcontext = context;
+}
+
+// Process one DTrack data packet that was not received from the UDP socket.
+bool DTrackSDK::receivePacket(const char* data, int len, long long receive_time_ns)
+{
+	lastDataError = ERR_NONE;
+	lastServerError = ERR_NONE;
+
+	if (data == NULL || len <= 0) {
+		lastDataError = ERR_NET;
+		return false;
+	}
+
+	// the packet takes the place of any pending ones
+	d_udpnum = d_udpnext = 0;
+
+	act_receivetime_ns = receive_time_ns;
+	return processPacket(data, len);	// parsed where it is, without a copy
+}
+
+// Get number of already fetched packets still waiting to be processed.
+int DTrackSDK::getNumPendingPackets()
+{
+	if (d_receivemode != RECEIVE_ALL)
+		return 0;
+	return d_udpnum - d_udpnext;
+}
+
+// Get number of packets fetched from the socket but never processed.
+unsigned long DTrackSDK::getNumCoalescedPackets()
+{
+	return d_udpfetched - d_udpprocessed - (unsigned long )(d_udpnum - d_udpnext);
+}
+
+// Get statistics of the packets received since the object was created.
+DTrack_Statistics_Type DTrackSDK::getStatistics()
+{
+	return d_statistics;
+}
+
+// Wait until at least one of several DTrackSDK objects has data to receive.
+int DTrackSDK::waitForData(const std::vector<DTrackSDK*>& sdks, std::vector<bool>& ready, int timeout_us)
+{
+	int i, n, count = (int )sdks.size();
+
+	ready.assign(count, false);
+	if (count == 0)
+		return -2;
+
+	// packets fetched earlier are ready without waiting, only poll the sockets then
+	n = 0;
+	for (i = 0; i < count; i++) {
+		if (sdks[i]->getNumPendingPackets() > 0) {
+			ready[i] = true;
+			n++;
+		}
+	}
+
+	// the lists are kept in the first object, so waiting for every frame doesn't allocate
+	std::vector<void*>& socks = sdks[0]->d_waitsocks;
+	std::vector<int>& readable = sdks[0]->d_waitready;
+	if ((int )socks.size() != count) {
+		socks.resize(count);
+		readable.resize(count);
+	}
+	for (i = 0; i < count; i++)
+		socks[i] = sdks[i]->d_udpsock;
+
+	int err = udp_wait_any(&socks[0], &readable[0], count, (n > 0) ? 0 : timeout_us);
+	if (err == -1)
+		return n;
+	if (err < 0)
+		return (n > 0) ? n : err;
+
+	for (i = 0; i < count; i++) {
+		if (readable[i] && !ready[i]) {
+			ready[i] = true;
+			n++;
+		}
+	}
+	return n;
+}
+
+// Mark entries first..last-1 as not tracked, making the vector long enough
+template<class T>
+static void disable_entries(std::vector<T>& v, int first, int last)
+{
+	if ((int )v.size() < last) {
+		v.resize(last);
+	}
+	for (int j=first; j<last; j++) {
+		memset(&v[j], 0, sizeof(T));
+		v[j].id = j;
+		v[j].quality = -1;
+	}
+}
+
+// Make room for standard bodies 0..n-1; new ones are not tracked
+static void reserve_bodies(DTrack_Body_Table_Type& table, int n)
+{
+	if ((int )table.stamp.size() < n) {
+		table.stamp.resize(n, 0);
+		table.quality.resize(n);
+		table.loc.resize(3 * n);
+		table.rot.resize(9 * n);
+	}
+}
+
+// Make room for Fingertracking hands 0..n-1; new ones are not tracked
+static void reserve_hands(DTrack_Hand_Table_Type& table, int n)
+{
+	if ((int )table.stamp.size() < n) {
+		table.stamp.resize(n, 0);
+		table.hand.resize(n);
+	}
+}
+
+// Whether the line at s starts with the identifier id
+static bool line_starts(const char* s, const char* end, const char* id)
+{
+	size_t n = strlen(id);
+	return ((size_t )(end - s) >= n) && !memcmp(s, id, n);
+}
+
+// Whether a standard body is to be parsed
+static bool body_subscribed(const DTrack_Subscription_Type* subscription, int id)
+{
+	if (subscription == NULL || subscription->body.empty()) {
+		return true;
+	}
+	return (id < (int )subscription->body.size()) && subscription->body[id];
+}
+
+// Parse one DTrack data packet (ASCII protocol) without changing it
+bool DTrackSDK::parseFrame(const char* data, int len, DTrack_Frame_Type& frame, const DTrack_Subscription_Type* subscription)
+{
+	const char* s;
+	const char* end;
+	int i, j, k, l, n, id;
+	char sfmt[20];
+	int iarr[3];
+	double d, darr[6];
+	int num_meatoolcal = 0;
+	int types = subscription ? subscription->types : DTRACK_DATA_ALL;
+	DTrack_Index_Type* index = &frame.index;
+
+	// bodies and hands of this packet are stamped with a new generation, instead of clearing the others
+	if (++frame.generation == 0) {	// wrapped around: forget all stamps
+		frame.generation = 1;
+		std::fill(frame.body.stamp.begin(), frame.body.stamp.end(), 0u);
+		std::fill(frame.hand.stamp.begin(), frame.hand.stamp.end(), 0u);
+		frame.body.generation = frame.hand.generation = 0;
+	}
 
+	// defaults:
+	frame.framecounter = 0;
+	frame.timestamp = -1;   // i.e. not available
+	frame.has_body = frame.has_flystick = frame.has_meatool = frame.has_hand = frame.has_marker = false;
+	frame.num_bodycal = frame.num_handcal = -1;  // i.e. not available
+	frame.num_flystick1 = 0;
+	frame.num_body = frame.num_flystick = frame.num_meatool = frame.num_hand = frame.num_marker = 0;
+	frame.error_line = -1;
+
+	if (data == NULL || len <= 0) {
+		return false;
+	}
+	string_index(data, len, index);	// find lines and blocks once, instead of for each
+	s = data;
+	end = data + index->len;
+
+	// process lines:
 	do {
 		// line for frame counter:
-		if (!strncmp(s, "fr ", 3)) {
+		if (line_starts(s, end, "fr ")) {
+			frame.error_line = DTRACK_LINE_FR;
 			s += 3;
-			if (!(s = string_get_ui(s, &act_framecounter))) {
-				act_framecounter = 0;
+			if (!(s = string_get_ui(s, end, &frame.framecounter))) {
+				frame.framecounter = 0;
 				return false;
 			}
 			continue;
 		}
 		// line for timestamp:
-		if (!strncmp(s, "ts ", 3)) {
+		if (line_starts(s, end, "ts ")) {
+			frame.error_line = DTRACK_LINE_TS;
 			s += 3;
-			if (!(s = string_get_d(s, &act_timestamp)))	{
-				act_timestamp = -1;
+			if (!(s = string_get_d(s, end, &frame.timestamp)))	{
+				frame.timestamp = -1;
 				return false;
 			}
 			continue;
 		}
 		// line for additional information about number of calibrated bodies:
-		if (!strncmp(s, "6dcal ", 6)) {
+		if (line_starts(s, end, "6dcal ")) {
+			frame.error_line = DTRACK_LINE_6DCAL;
+			if (!(types & DTRACK_DATA_BODY)) {
+				continue;
+			}
 			s += 6;
-			if (!(s = string_get_i(s, &loc_num_bodycal))) {
+			if (!(s = string_get_i(s, end, &frame.num_bodycal))) {
 				return false;
 			}
+			reserve_bodies(frame.body, frame.num_bodycal);	// at most that many standard bodies
 			continue;
 		}
 		// line for standard body data:
-		if (!strncmp(s, "6d ", 3)) {
-			s += 3;
-			// disable all existing dataargc != 2
-			for (i=0; i<act_num_body; i++) {
-				memset(&act_body[i], 0, sizeof(DTrack_Body_Type));
-				act_body[i].id = i;
-				act_body[i].quality = -1;
+		if (line_starts(s, end, "6d ")) {
+			frame.error_line = DTRACK_LINE_6D;
+			if (!(types & DTRACK_DATA_BODY)) {
+				continue;
 			}
+			s += 3;
+			frame.has_body = true;
+			frame.body.generation = frame.generation;
+			frame.num_body = 0;
 			// get number of standard bodies (in line)
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
 				return false;
 			}
 			// get data of standard bodies
 			for (i=0; i<n; i++) {
-				if (!(s = string_get_block(s, "id", &id, NULL, &d))) {
+				if (!(s = string_get_block_id<0>(index, s, &id, &d))) {
+					return false;
+				}
+				if (id < 0) {  // not expected
 					return false;
 				}
-				// adjust length of vector
-				if (id >= act_num_body) {
-					act_body.resize(id + 1);
-					for (j = act_num_body; j<=id; j++) {
-						memset(&act_body[j], 0, sizeof(DTrack_Body_Type));
-						act_body[j].id = j;
-						act_body[j].quality = -1;
+				// bodies not in line keep an older stamp, so they are not tracked
+				if (id >= frame.num_body) {
+					reserve_bodies(frame.body, id + 1);
+					frame.num_body = id + 1;
+				}
+				if (!body_subscribed(subscription, id)) {
+					if (!(s = string_skip_blocks(index, s, 2))) {
+						return false;
 					}
-					act_num_body = id + 1;
+					continue;
 				}
-				act_body[id].id = id;
-				act_body[id].quality = d;
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_body[id].loc))) {
+				frame.body.stamp[id] = frame.generation;
+				frame.body.quality[id] = d;
+				if (!(s = string_get_block_d<3>(index, s, &frame.body.loc[3 * id]))) {
 					return false;
 				}
-				if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_body[id].rot))) {
+				if (!(s = string_get_block_d<9>(index, s, &frame.body.rot[9 * id]))) {
 					return false;
 				}
 			}
@@ -326,54 +606,61 @@ bool DTrackSDK::receive()
 		}
 
 		// line for Flystick data (older format):
-		if (!strncmp(s, "6df ", 4)) {
+		if (line_starts(s, end, "6df ")) {
+			frame.error_line = DTRACK_LINE_6DF;
 			s += 4;
 			// get number of calibrated Flysticks
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
+				return false;
+			}
+			if (n < 0) {
 				return false;
 			}
-			loc_num_flystick1 = n;
-			// adjust length of vector
-			if (n != act_num_flystick) {
-				act_flystick.resize(n);
-				act_num_flystick = n;
+			frame.num_flystick1 = n;	// needed for the number of standard bodies
+			if (!(types & DTRACK_DATA_FLYSTICK)) {
+				continue;
+			}
+			frame.has_flystick = true;
+			frame.num_flystick = n;
+			if ((int )frame.flystick.size() < n) {
+				frame.flystick.resize(n);
 			}
 			// get data of Flysticks
 			for (i=0; i<n; i++) {
-				if (!(s = string_get_block(s, "idi", iarr, NULL, &d))) {
+				if (!(s = string_get_block_id<1>(index, s, iarr, &d))) {
 					return false;
 				}
 				if (iarr[0] != i) {	// not expected
 					return false;
 				}
-				act_flystick[i].id = iarr[0];
-				act_flystick[i].quality = d;
-				act_flystick[i].num_button = 8;
+				frame.flystick[i].id = iarr[0];
+				frame.flystick[i].quality = d;
+				frame.flystick[i].num_button = 8;
 				k = iarr[1];
 				for (j=0; j<8; j++) {
-					act_flystick[i].button[j] = k & 0x01;
+					frame.flystick[i].button[j] = k & 0x01;
 					k >>= 1;
 				}
-				act_flystick[i].num_joystick = 2;  // additionally to buttons 5-8
+				frame.flystick[i].num_joystick = 2;  // additionally to buttons 5-8
 				if (iarr[1] & 0x20) {
-					act_flystick[i].joystick[0] = -1;
+					frame.flystick[i].joystick[0] = -1;
 				} else
 				if (iarr[1] & 0x80) {
-					act_flystick[i].joystick[0] = 1;
+					frame.flystick[i].joystick[0] = 1;
 				} else {
-					act_flystick[i].joystick[0] = 0;
+					frame.flystick[i].joystick[0] = 0;
 				}
 				if(iarr[1] & 0x10){
-					act_flystick[i].joystick[1] = -1;
+					frame.flystick[i].joystick[1] = -1;
 				}else if(iarr[1] & 0x40){
-					act_flystick[i].joystick[1] = 1;
+					frame.flystick[i].joystick[1] = 1;
 				}else{
-					act_flystick[i].joystick[1] = 0;
+					frame.flystick[i].joystick[1] = 0;
 				}
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_flystick[i].loc))) {
+				if (!(s = string_get_block_d<3>(index, s, frame.flystick[i].loc))) {
 					return false;
 				}
-				if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_flystick[i].rot))) {
+				if (!(s = string_get_block_d<9>(index, s, frame.flystick[i].rot))) {
 					return false;
 				}
 			}
@@ -381,60 +668,65 @@ bool DTrackSDK::receive()
 		}
 
 		// line for Flystick data (newer format):
-		if (!strncmp(s, "6df2 ", 5)) {
+		if (line_starts(s, end, "6df2 ")) {
+			frame.error_line = DTRACK_LINE_6DF2;
+			if (!(types & DTRACK_DATA_FLYSTICK)) {
+				continue;
+			}
 			s += 5;
 			// get number of calibrated Flysticks
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
 				return false;
 			}
-			// adjust length of vector
-			if (n != act_num_flystick) {
-				act_flystick.resize(n);
-				act_num_flystick = n;
+			if (n < 0) {
+				return false;
 			}
+			frame.has_flystick = true;
+			frame.num_flystick = n;
+			disable_entries(frame.flystick, 0, n);	// Flysticks not in line are not tracked
 			// get number of Flysticks
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
+				return false;
+			}
+			if (n > frame.num_flystick) {  // not expected
 				return false;
 			}
 			// get data of Flysticks
 			for (i=0; i<n; i++) {
-				if (!(s = string_get_block(s, "idii", iarr, NULL, &d))) {
+				if (!(s = string_get_block_id<2>(index, s, iarr, &d))) {
 					return false;
 				}
 				if (iarr[0] != i) {  // not expected
 					return false;
 				}
-				act_flystick[i].id = iarr[0];
-				act_flystick[i].quality = d;
-				if ((iarr[1] > DTRACK_FLYSTICK_MAX_BUTTON)||(iarr[1] > DTRACK_FLYSTICK_MAX_JOYSTICK)) {
+				frame.flystick[i].id = iarr[0];
+				frame.flystick[i].quality = d;
+				if ((iarr[1] < 0) || (iarr[1] > DTRACK_FLYSTICK_MAX_BUTTON) || (iarr[2] < 0) || (iarr[2] > DTRACK_FLYSTICK_MAX_JOYSTICK)) {
 					return false;
 				}
-				act_flystick[i].num_button = iarr[1];
-				act_flystick[i].num_joystick = iarr[2];
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_flystick[i].loc))){
+				frame.flystick[i].num_button = iarr[1];
+				frame.flystick[i].num_joystick = iarr[2];
+				if (!(s = string_get_block_d<3>(index, s, frame.flystick[i].loc))){
 					return false;
 				}
-				if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_flystick[i].rot))){
+				if (!(s = string_get_block_d<9>(index, s, frame.flystick[i].rot))){
 					return false;
 				}
-				strcpy(sfmt, "");
-				j = 0;
-				while (j < act_flystick[i].num_button) {
-					strcat(sfmt, "i");
-					j += 32;
+				// the only block of varying length: an 'int' per 32 buttons, then the joystick values
+				k = 0;
+				for (j=0; j<frame.flystick[i].num_button; j+=32) {
+					sfmt[k++] = 'i';
 				}
-				j = 0;
-				while (j < act_flystick[i].num_joystick) {
-					strcat(sfmt, "d");
-					j++;
+				for (j=0; j<frame.flystick[i].num_joystick; j++) {
+					sfmt[k++] = 'd';
 				}
-				if (!(s = string_get_block(s, sfmt, iarr, NULL, act_flystick[i].joystick))) {
+				sfmt[k] = '\0';
+				if (!(s = string_get_block(index, s, sfmt, iarr, NULL, frame.flystick[i].joystick))) {
 					return false;
 				}
 				k = l = 0;
-				for (j=0; j<act_flystick[i].num_button
-				; j++) {
-					act_flystick[i].button[j] = iarr[k] & 0x01;
+				for (j=0; j<frame.flystick[i].num_button; j++) {
+					frame.flystick[i].button[j] = iarr[k] & 0x01;
 					iarr[k] >>= 1;
 					l++;
 					if (l == 32) {
@@ -447,34 +739,41 @@ bool DTrackSDK::receive()
 		}
 
 		// line for measurement tool data:
-		if (!strncmp(s, "6dmt ", 5)) {
+		if (line_starts(s, end, "6dmt ")) {
+			frame.error_line = DTRACK_LINE_6DMT;
 			s += 5;
 			// get number of calibrated measurement tools
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
 				return false;
 			}
-			loc_num_meatool = n;
-			// adjust length of vector
-			if (n != act_num_meatool) {
-				act_meatool.resize(n);
-				act_num_meatool = n;
+			if (n < 0) {
+				return false;
+			}
+			num_meatoolcal = n;	// needed for the number of standard bodies
+			if (!(types & DTRACK_DATA_MEATOOL)) {
+				continue;
+			}
+			frame.has_meatool = true;
+			frame.num_meatool = n;
+			if ((int )frame.meatool.size() < n) {
+				frame.meatool.resize(n);
 			}
 			// get data of measurement tools
 			for (i=0; i<n; i++) {
-				if (!(s = string_get_block(s, "idi", iarr, NULL, &d))) {
+				if (!(s = string_get_block_id<1>(index, s, iarr, &d))) {
 					return false;
 				}
 				if (iarr[0] != i) {  // not expected
 					return false;
 				}
-				act_meatool[i].id = iarr[0];
-				act_meatool[i].quality = d;
-				act_meatool[i].num_button = 1;
-				act_meatool[i].button[0] = iarr[1] & 0x01;
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_meatool[i].loc))) {
+				frame.meatool[i].id = iarr[0];
+				frame.meatool[i].quality = d;
+				frame.meatool[i].num_button = 1;
+				frame.meatool[i].button[0] = iarr[1] & 0x01;
+				if (!(s = string_get_block_d<3>(index, s, frame.meatool[i].loc))) {
 					return false;
 				}
-				if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_meatool[i].rot))) {
+				if (!(s = string_get_block_d<9>(index, s, frame.meatool[i].rot))) {
 					return false;
 				}
 			}
@@ -482,94 +781,109 @@ bool DTrackSDK::receive()
 		}
 
 		// line for additional information about number of calibrated Fingertracking hands:
-		if (!strncmp(s, "glcal ", 6)) {
+		if (line_starts(s, end, "glcal ")) {
+			frame.error_line = DTRACK_LINE_GLCAL;
+			if (!(types & DTRACK_DATA_HAND)) {
+				continue;
+			}
 			s += 6;
-			if (!(s = string_get_i(s, &loc_num_handcal))) {	// get number of calibrated hands
+			if (!(s = string_get_i(s, end, &frame.num_handcal))) {	// get number of calibrated hands
 				return false;
 			}
+			reserve_hands(frame.hand, frame.num_handcal);
+			continue;
 		}
 
 		// line for A.R.T. Fingertracking hand data:
-		if (!strncmp(s, "gl ", 3)) {
-			s += 3;
-			// disable all existing data
-			for (i=0; i<act_num_hand; i++) {
-				memset(&act_hand[i], 0, sizeof(DTrack_Hand_Type));
-				act_hand[i].id = i;
-				act_hand[i].quality = -1;
+		if (line_starts(s, end, "gl ")) {
+			frame.error_line = DTRACK_LINE_GL;
+			if (!(types & DTRACK_DATA_HAND)) {
+				continue;
 			}
+			s += 3;
+			frame.has_hand = true;
+			frame.hand.generation = frame.generation;
+			frame.num_hand = 0;
 			// get number of hands (in line)
-			if (!(s = string_get_i(s, &n))) {
+			if (!(s = string_get_i(s, end, &n))) {
 				return false;
 			}
 			// get data of hands
 			for (i=0; i<n; i++) {
-				if (!(s = string_get_block(s, "idii", iarr, NULL, &d))){
+				if (!(s = string_get_block_id<2>(index, s, iarr, &d))){
 					return false;
 				}
 				id = iarr[0];
-				if (id >= act_num_hand) {  // adjust length of vector
-					act_hand.resize(id + 1);
-					for (j=act_num_hand; j<=id; j++) {
-						memset(&act_hand[j], 0, sizeof(DTrack_Hand_Type));
-						act_hand[j].id = j;
-						act_hand[j].quality = -1;
-					}
-					act_num_hand = id + 1;
+				if (id < 0) {  // not expected
+					return false;
 				}
-				act_hand[id].id = iarr[0];
-				act_hand[id].lr = iarr[1];
-				act_hand[id].quality = d;
-				if (iarr[2] > DTRACK_HAND_MAX_FINGER) {
+				// hands not in line keep an older stamp, so they are not tracked
+				if (id >= frame.num_hand) {
+					reserve_hands(frame.hand, id + 1);
+					frame.num_hand = id + 1;
+				}
+				frame.hand.stamp[id] = frame.generation;
+				DTrack_Hand_Type_d& hand = frame.hand.hand[id];
+				hand.id = iarr[0];
+				hand.lr = iarr[1];
+				hand.quality = d;
+				if ((iarr[2] < 0) || (iarr[2] > DTRACK_HAND_MAX_FINGER)) {
 					return false;
 				}
-				act_hand[id].nfinger = iarr[2];
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_hand[id].loc))) {
+				hand.nfinger = iarr[2];
+				if (!(s = string_get_block_d<3>(index, s, hand.loc))) {
 					return false;
-
 				}
-				if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_hand[id].rot))){
+				if (!(s = string_get_block_d<9>(index, s, hand.rot))){
 					return false;
 				}
 				// get data of fingers
-				for (j = 0; j < act_hand[id].nfinger; j++) {
-					if (!(s = string_get_block(s, "ddd", NULL, NULL, act_hand[id].finger[j].loc))) {
+				for (j = 0; j < hand.nfinger; j++) {
+					if (!(s = string_get_block_d<3>(index, s, hand.finger[j].loc))) {
 						return false;
 					}
-					if (!(s = string_get_block(s, "ddddddddd", NULL, NULL, act_hand[id].finger[j].rot))){
+					if (!(s = string_get_block_d<9>(index, s, hand.finger[j].rot))){
 						return false;
 					}
-					if (!(s = string_get_block(s, "dddddd", NULL, NULL, darr))){
+					if (!(s = string_get_block_d<6>(index, s, darr))){
 						return false;
 					}
-					act_hand[id].finger[j].radiustip = darr[0];
-					act_hand[id].finger[j].lengthphalanx[0] = darr[1];
-					act_hand[id].finger[j].anglephalanx[0] = darr[2];
-					act_hand[id].finger[j].lengthphalanx[1] = darr[3];
-					act_hand[id].finger[j].anglephalanx[1] = darr[4];
-					act_hand[id].finger[j].lengthphalanx[2] = darr[5];
+					hand.finger[j].radiustip = darr[0];
+					hand.finger[j].lengthphalanx[0] = darr[1];
+					hand.finger[j].anglephalanx[0] = darr[2];
+					hand.finger[j].lengthphalanx[1] = darr[3];
+					hand.finger[j].anglephalanx[1] = darr[4];
+					hand.finger[j].lengthphalanx[2] = darr[5];
 				}
 			}
 			continue;
 		}
 
 		// line for single marker data:
-		if (!strncmp(s, "3d ", 3)) {
+		if (line_starts(s, end, "3d ")) {
+			frame.error_line = DTRACK_LINE_3D;
+			if (!(types & DTRACK_DATA_MARKER)) {
+				continue;
+			}
 			s += 3;
 			// get number of markers
-			if (!(s = string_get_i(s, &act_num_marker))) {
-				act_num_marker = 0;
+			if (!(s = string_get_i(s, end, &n))) {
+				return false;
+			}
+			if (n < 0) {
 				return false;
 			}
-			if (act_num_marker > (int )act_marker.size()) {
-				act_marker.resize(act_num_marker);
+			frame.has_marker = true;
+			frame.num_marker = n;
+			if ((int )frame.marker.size() < n) {
+				frame.marker.resize(n);
 			}
 			// get data of single markers
-			for (i=0; i<act_num_marker; i++) {
-				if (!(s = string_get_block(s, "id", &act_marker[i].id, NULL, &act_marker[i].quality))) {
+			for (i=0; i<n; i++) {
+				if (!(s = string_get_block_id<0>(index, s, &frame.marker[i].id, &frame.marker[i].quality))) {
 					return false;
 				}
-				if (!(s = string_get_block(s, "ddd", NULL, NULL, act_marker[i].loc))) {
+				if (!(s = string_get_block_d<3>(index, s, frame.marker[i].loc))) {
 					return false;
 				}
 			}
@@ -577,33 +891,98 @@ bool DTrackSDK::receive()
 		}
 
 		// ignore unknown line identifiers (could be valid in future DTracks)
-	} while((s = string_nextline(d_udpbuf, s, d_udpbufsize)));
+	} while((s = string_nextline(index, s)));
 
 	// set number of calibrated standard bodies, if necessary:
-	if (loc_num_bodycal >= 0) {	// '6dcal' information was available
-		n = loc_num_bodycal - loc_num_flystick1 - loc_num_meatool;
-		if (n > act_num_body) {  // adjust length of vector
-			act_body.resize(n);
-			for (j=act_num_body; j<n; j++) {
-				memset(&act_body[j], 0, sizeof(DTrack_Body_Type));
-				act_body[j].id = j;
-				act_body[j].quality = -1;
-			}
+	if (frame.num_bodycal >= 0) {	// '6dcal' information was available
+		n = frame.num_bodycal - frame.num_flystick1 - num_meatoolcal;
+		if (n < 0) {
+			n = 0;
 		}
-		act_num_body = n;
+		reserve_bodies(frame.body, n);
+		frame.num_body = n;
 	}
 
 	// set number of calibrated Fingertracking hands, if necessary:
-	if (loc_num_handcal >= 0) {  // 'glcal' information was available
-		if (loc_num_handcal > act_num_hand) {  // adjust length of vector
-			act_hand.resize(loc_num_handcal);
-			for (j=act_num_hand; j<loc_num_handcal; j++) {
-				memset(&act_hand[j], 0, sizeof(DTrack_Hand_Type));
-				act_hand[j].id = j;
-				act_hand[j].quality = -1;
-			}
+	if (frame.num_handcal >= 0) {  // 'glcal' information was available
+		reserve_hands(frame.hand, frame.num_handcal);
+		frame.num_hand = frame.num_handcal;
+	}
+
+	frame.error_line = -1;
+	return true;
+}
+
+// Take over the data of a parsed packet, keeping what the packet has no information about
+bool DTrackSDK::processPacket(const char* data, int len)
+{
+	int i, n;
+
+	lastDataError = ERR_PARSE;
+	d_statistics.packets++;
+	if (!parseFrame(data, len, d_frame, &d_subscription)) {
+		if (d_frame.error_line >= 0) {
+			d_statistics.parse_errors[d_frame.error_line]++;
 		}
-		act_num_hand = loc_num_handcal;
+		return false;
+	}
+
+	// frames missing since the last packet; a smaller counter means DTrack was restarted
+	if (d_frame.framecounter != 0) {
+		if (act_lastframecounter != 0 && d_frame.framecounter > act_lastframecounter + 1) {
+			d_statistics.frame_gaps += d_frame.framecounter - act_lastframecounter - 1;
+		}
+		act_lastframecounter = d_frame.framecounter;
+	}
+
+	act_framecounter = d_frame.framecounter;
+	act_timestamp = d_frame.timestamp;
+
+	// standard bodies: tracked are those stamped by the last '6d' line; without one only the
+	// number is known
+	if (d_frame.has_body) {
+		n = (d_frame.num_bodycal >= 0) ? d_frame.num_body : std::max(act_num_body, d_frame.num_body);
+		reserve_bodies(d_frame.body, n);
+		act_num_body = n;
+	} else if (d_frame.num_bodycal >= 0) {
+		n = d_frame.num_body;
+		reserve_bodies(d_frame.body, n);
+		for (i=act_num_body; i<n; i++) {	// new bodies are not tracked
+			d_frame.body.stamp[i] = 0;
+		}
+		act_num_body = n;
+	}
+	if ((int )act_body.size() < act_num_body) {
+		act_body.resize(act_num_body);
+	}
+
+	if (d_frame.has_flystick) {
+		act_num_flystick = d_frame.num_flystick;
+	}
+
+	if (d_frame.has_meatool) {
+		act_num_meatool = d_frame.num_meatool;
+	}
+
+	// Fingertracking hands: like standard bodies
+	if (d_frame.has_hand) {
+		n = (d_frame.num_handcal >= 0) ? d_frame.num_hand : std::max(act_num_hand, d_frame.num_hand);
+		reserve_hands(d_frame.hand, n);
+		act_num_hand = n;
+	} else if (d_frame.num_handcal >= 0) {
+		n = d_frame.num_hand;
+		reserve_hands(d_frame.hand, n);
+		for (i=act_num_hand; i<n; i++) {	// new hands are not tracked
+			d_frame.hand.stamp[i] = 0;
+		}
+		act_num_hand = n;
+	}
+	if ((int )act_hand.size() < act_num_hand) {
+		act_hand.resize(act_num_hand);
+	}
+
+	if (d_frame.has_marker) {
+		act_num_marker = d_frame.num_marker;
 	}
 
 	lastDataError = ERR_NONE;
@@ -619,9 +998,22 @@ int DTrackSDK::getNumBody()
 // Get standard body data (id (i): standard body id 0..max-1)
 DTrack_Body_Type_d* DTrackSDK::getBody(int id)
 {
-	if ((id >= 0) && (id < act_num_body))
-		return &act_body.at(id);
-	return NULL;
+	if ((id < 0) || (id >= act_num_body))
+		return NULL;
+
+	const DTrack_Body_Table_Type& table = d_frame.body;
+	DTrack_Body_Type_d* body = &act_body.at(id);
+	if (table.stamp[id] != 0 && table.stamp[id] == table.generation) {
+		body->id = id;
+		body->quality = table.quality[id];
+		memcpy(body->loc, &table.loc[3 * id], sizeof(body->loc));
+		memcpy(body->rot, &table.rot[9 * id], sizeof(body->rot));
+	} else {
+		memset(body, 0, sizeof(DTrack_Body_Type_d));
+		body->id = id;
+		body->quality = -1;
+	}
+	return body;
 }
 
 // Get number of calibrated Flysticks
@@ -634,7 +1026,7 @@ int DTrackSDK::getNumFlyStick()
 DTrack_FlyStick_Type_d* DTrackSDK::getFlyStick(int id)
 {
 	if ((id >= 0) && (id < act_num_flystick))
-		return &act_flystick.at(id);
+		return &d_frame.flystick.at(id);
 	return NULL;
 }
 
@@ -648,7 +1040,7 @@ int DTrackSDK::getNumMeaTool()
 DTrack_MeaTool_Type_d* DTrackSDK::getMeaTool(int id)
 {
 	if ((id >= 0) && (id < act_num_meatool))
-		return &act_meatool.at(id);
+		return &d_frame.meatool.at(id);
 	return NULL;
 }
 
@@ -661,9 +1053,19 @@ int DTrackSDK::getNumHand()
 // Get Fingertracking hand data (id (i): hand id 0..max-1)
 DTrack_Hand_Type_d* DTrackSDK::getHand(int id)
 {
-	if ((id >= 0) && (id < act_num_hand))
-		return &act_hand.at(id);
-	return NULL;
+	if ((id < 0) || (id >= act_num_hand))
+		return NULL;
+
+	const DTrack_Hand_Table_Type& table = d_frame.hand;
+	DTrack_Hand_Type_d* hand = &act_hand.at(id);
+	if (table.stamp[id] != 0 && table.stamp[id] == table.generation) {
+		*hand = table.hand[id];
+	} else {
+		memset(hand, 0, sizeof(DTrack_Hand_Type_d));
+		hand->id = id;
+		hand->quality = -1;
+	}
+	return hand;
 }
 
 // Get number of tracked single markers
@@ -676,10 +1078,16 @@ int DTrackSDK::getNumMarker()
 DTrack_Marker_Type_d* DTrackSDK::getMarker(int index)
 {
 	if ((index >= 0) && (index < act_num_marker))
-		return &act_marker.at(index);
+		return &d_frame.marker.at(index);
 	return NULL;
 }
 
+// Get the parsed data of the last received frame
+const DTrack_Frame_Type& DTrackSDK::getFrame()
+{
+	return d_frame;
+}
+
 // Get frame counter
 unsigned int DTrackSDK::getFrameCounter()
 {
@@ -692,6 +1100,12 @@ double DTrackSDK::getTimeStamp()
 	return act_timestamp;
 }
 
+// Get arrival time of the last received frame (-1 if no frame was received yet)
+long long DTrackSDK::getReceiveTimeNs()
+{
+	return act_receivetime_ns;
+}
+
 // Send DTrack command (UDP)
 bool DTrackSDK::sendCommand(const std::string& command)
 {
@@ -70,13 +70,13 @@ namespace MTF
     }
 
 
-    double Display::GetScreenWidth()
+    Real Display::GetScreenWidth()
     {
         return _width;
     }
 
 
-    double Display::GetScreenHeight()
+    Real Display::GetScreenHeight()
     {
         return _height;
     }
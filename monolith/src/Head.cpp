@@ -10,6 +10,22 @@ namespace MTF
         _up    = Vector3::UNIT_Y;
         _right = _view.CrossProduct(_up);
         _tracked = false;
+        _receiveTimeNs = -1;
+        _frameNumber = 0;
+    }
+
+
+    Head::Head(const BodyState &state)
+    {
+        _tracked = state.tracked;
+        _receiveTimeNs = state.receiveTimeNs;
+        _frameNumber = state.frameNumber;
+        _position = Vector3(state.position[0], state.position[1], state.position[2]);
+        _view  = Vector3(state.view[0], state.view[1], state.view[2]);
+        _up    = Vector3(state.up[0], state.up[1], state.up[2]);
+        _right = Vector3(state.right[0], state.right[1], state.right[2]);
+        _velocity = Vector3(state.velocity[0], state.velocity[1], state.velocity[2]);
+        _angularVelocity = Vector3(state.angularVelocity[0], state.angularVelocity[1], state.angularVelocity[2]);
     }
 
 
@@ -18,7 +34,7 @@ namespace MTF
     }
 
  
-    void Head::Update(DTrack_Body_Type_d data)
+    void Head::Update(DTrack_Body_Type_d data, long long receiveTimeNs)
     {
         _tracked = data.quality != -1;
         if (data.quality > 0) 
@@ -28,16 +44,63 @@ namespace MTF
                         data.rot[2], data.rot[5], data.rot[8], 0.0,
                                 0.0,         0.0,         0.0, 1.0);
 
-            _position = Vector3(data.loc);
-            _position *= 3.2808399 / 1000; // mm to foot conversion
-
-            _view  = mat * Vector3::UNIT_Z;
-            _up    = mat * Vector3::UNIT_Y;
-            _right = mat * Vector3::UNIT_X;
+            Vector3 position = Vector3(data.loc);
+            position *= 3.2808399 / 1000; // mm to foot conversion
+
+            Vector3 view  = mat * Vector3::UNIT_Z;
+            Vector3 up    = mat * Vector3::UNIT_Y;
+            Vector3 right = mat * Vector3::UNIT_X;
+
+            if (!_filter.IsEmpty())
+            {
+                PoseSample sample;
+                sample.position = position;
+                sample.orientation = Quaternion(view, right, up);
+                sample.quality = data.quality;
+                sample.time = receiveTimeNs * 1e-9;
+
+                // A rejected sample leaves the Head where it was
+                if (!_filter.Apply(sample))
+                    return;
+
+                position = sample.position;
+                view  = sample.orientation.GetViewVector();
+                up    = sample.orientation.GetUpVector();
+                right = sample.orientation.GetRightVector();
+            }
+
+            _position = position;
+            _view  = view;
+            _up    = up;
+            _right = right;
+            _receiveTimeNs = receiveTimeNs;
+
+            _predictor.Update(_position, Quaternion(_view, _right, _up), receiveTimeNs * 1e-9);
+            _velocity = _predictor.GetVelocity();
+            _angularVelocity = _predictor.GetAngularVelocity();
+        }
+        else if (!_tracked)
+        {
+            _filter.Reset();
+            _predictor.Reset();
+            _velocity = _angularVelocity = Vector3::ZERO;
         }
     }
 
 
+    void Head::SetFilter(PoseFilterChain filter)
+    {
+        _filter = filter;
+    }
+
+
+    void Head::SetPredictionMode(PosePredictor::MODE mode)
+    {
+        _predictor.SetMode(mode);
+        _velocity = _angularVelocity = Vector3::ZERO;
+    }
+
+
     Vector3 Head::GetPosition()
     {
         return _position;
@@ -68,6 +131,72 @@ namespace MTF
     }
 
 
+    long long Head::GetReceiveTimeNs()
+    {
+        return _receiveTimeNs;
+    }
+
+
+    unsigned long Head::GetFrameNumber()
+    {
+        return _frameNumber;
+    }
+
+
+    Vector3 Head::GetVelocity()
+    {
+        return _velocity;
+    }
+
+
+    Vector3 Head::GetAngularVelocity()
+    {
+        return _angularVelocity;
+    }
+
+
+    Head Head::Predict(long long targetTimeNs)
+    {
+        Head h = GetCopy();
+        if (!_tracked || _receiveTimeNs < 0)
+            return h;
+
+        Real seconds = (targetTimeNs - _receiveTimeNs) * 1e-9;
+        Quaternion rotation = PosePredictor::GetRotation(_angularVelocity, seconds);
+
+        h._position = PosePredictor::Extrapolate(_position, _velocity, seconds);
+        h._view  = rotation * _view;
+        h._up    = rotation * _up;
+        h._right = rotation * _right;
+
+        return h;
+    }
+
+
+    Head Head::Interpolate(Head from, Head to, long long timeNs)
+    {
+        long long span = to._receiveTimeNs - from._receiveTimeNs;
+        if (span <= 0 || !from._tracked || !to._tracked)
+            return (timeNs - from._receiveTimeNs < to._receiveTimeNs - timeNs) ? from : to;
+
+        Real s = (Real)(timeNs - from._receiveTimeNs) / span;
+
+        Quaternion orientation = Quaternion::Slerp(Quaternion(from._view, from._right, from._up),
+                                                   Quaternion(to._view, to._right, to._up), s);
+
+        Head h = from.GetCopy();
+        h._receiveTimeNs = timeNs;
+        h._position = from._position + (to._position - from._position) * s;
+        h._view  = orientation.GetViewVector();
+        h._up    = orientation.GetUpVector();
+        h._right = orientation.GetRightVector();
+        h._velocity = from._velocity + (to._velocity - from._velocity) * s;
+        h._angularVelocity = from._angularVelocity + (to._angularVelocity - from._angularVelocity) * s;
+
+        return h;
+    }
+
+
     Matrix4 Head::GetTransformMatrix()
     {
         return Matrix4(_position, _view, _right, _up);
@@ -78,12 +207,31 @@ namespace MTF
     {
         Head h;
         h._tracked = _tracked;
+        h._receiveTimeNs = _receiveTimeNs;
+        h._frameNumber = _frameNumber;
         h._position = Vector3(_position.GetX(), _position.GetY(), _position.GetZ());
         h._view = Vector3(_view.GetX(), _view.GetY(), _view.GetZ());
         h._up = Vector3(_up.GetX(), _up.GetY(), _up.GetZ());
         h._right = Vector3(_right.GetX(), _right.GetY(), _right.GetZ());
+        h._velocity = _velocity;
+        h._angularVelocity = _angularVelocity;
 
         return h;
     }
 
+
+    void Head::GetState(BodyState &state)
+    {
+        state.tracked = _tracked;
+        state.receiveTimeNs = _receiveTimeNs;
+        state.frameNumber = _frameNumber;
+        state.position[0] = _position.GetX();  state.position[1] = _position.GetY();  state.position[2] = _position.GetZ();
+        state.view[0]     = _view.GetX();      state.view[1]     = _view.GetY();      state.view[2]     = _view.GetZ();
+        state.up[0]       = _up.GetX();        state.up[1]       = _up.GetY();        state.up[2]       = _up.GetZ();
+        state.right[0]    = _right.GetX();     state.right[1]    = _right.GetY();     state.right[2]    = _right.GetZ();
+
+        state.velocity[0]        = _velocity.GetX();         state.velocity[1]        = _velocity.GetY();         state.velocity[2]        = _velocity.GetZ();
+        state.angularVelocity[0] = _angularVelocity.GetX();  state.angularVelocity[1] = _angularVelocity.GetY();  state.angularVelocity[2] = _angularVelocity.GetZ();
+    }
+
 }
\ No newline at end of file
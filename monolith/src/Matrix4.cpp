@@ -9,7 +9,7 @@ namespace MTF
     }
 
 
-    Matrix4::Matrix4(double mat[4][4])
+    Matrix4::Matrix4(Real mat[4][4])
     {
 	    for (int i = 0; i < 4; i++)
 		    for (int j = 0; j < 4; j++)
@@ -17,10 +17,10 @@ namespace MTF
     }
 
 
-    Matrix4::Matrix4(double m00, double m01, double m02, double m03,
-		             double m10, double m11, double m12, double m13,
-		             double m20, double m21, double m22, double m23,
-		             double m30, double m31, double m32, double m33)
+    Matrix4::Matrix4(Real m00, Real m01, Real m02, Real m03,
+		             Real m10, Real m11, Real m12, Real m13,
+		             Real m20, Real m21, Real m22, Real m23,
+		             Real m30, Real m31, Real m32, Real m33)
     {
 	    _mat[0][0] = m00;  _mat[0][1] = m01;  _mat[0][2] = m02;  _mat[0][3] = m03;
 	    _mat[1][0] = m10;  _mat[1][1] = m11;  _mat[1][2] = m12;  _mat[1][3] = m13;
@@ -92,7 +92,7 @@ namespace MTF
     }
 
 
-    Matrix4 Matrix4::operator * (double param)
+    Matrix4 Matrix4::operator * (Real param)
     {
 	    Matrix4 mult;// = new Matrix4();
 	
@@ -110,7 +110,7 @@ namespace MTF
 
     Vector3 Matrix4::operator * (Vector3 param)
     {
-	    double vec[4];
+	    Real vec[4];
 
 	    for (int i = 0; i < 4; i++)
 	    {
@@ -181,7 +181,7 @@ namespace MTF
     }
 
 
-    Matrix4& Matrix4::operator *= (const double param)
+    Matrix4& Matrix4::operator *= (const Real param)
     {
 	    for (int i = 0; i < 4; i++)
 	    {
@@ -277,7 +277,7 @@ namespace MTF
     }
 
 
-    void Matrix4::MakeYawRotationMatrix(double yaw)
+    void Matrix4::MakeYawRotationMatrix(Real yaw)
     {
         LoadIdentity();
 
@@ -288,7 +288,7 @@ namespace MTF
     }
 
 
-    void Matrix4::MakePitchRotationMatrix(double pitch)
+    void Matrix4::MakePitchRotationMatrix(Real pitch)
     {
         LoadIdentity();
 
@@ -299,7 +299,7 @@ namespace MTF
     }
 
 
-    void Matrix4::MakeRollRotationMatrix(double roll)
+    void Matrix4::MakeRollRotationMatrix(Real roll)
     {
         LoadIdentity();
 
@@ -332,20 +332,20 @@ namespace MTF
 
     void Matrix4::Invert()
     {
-        double a0 = _mat[0][0]*_mat[1][1] - _mat[0][1]*_mat[1][0];
-        double a1 = _mat[0][0]*_mat[1][2] - _mat[0][2]*_mat[1][0];
-        double a2 = _mat[0][0]*_mat[1][3] - _mat[0][3]*_mat[1][0];
-        double a3 = _mat[0][1]*_mat[1][2] - _mat[0][2]*_mat[1][1];
-        double a4 = _mat[0][1]*_mat[1][3] - _mat[0][3]*_mat[1][1];
-        double a5 = _mat[0][2]*_mat[1][3] - _mat[0][3]*_mat[1][2];
-        double b0 = _mat[2][0]*_mat[3][1] - _mat[2][1]*_mat[3][0];
-        double b1 = _mat[2][0]*_mat[3][2] - _mat[2][2]*_mat[3][0];
-        double b2 = _mat[2][0]*_mat[3][3] - _mat[2][3]*_mat[3][0];
-        double b3 = _mat[2][1]*_mat[3][2] - _mat[2][2]*_mat[3][1];
-        double b4 = _mat[2][1]*_mat[3][3] - _mat[2][3]*_mat[3][1];
-        double b5 = _mat[2][2]*_mat[3][3] - _mat[2][3]*_mat[3][2];
-
-        double det = a0*b5 - a1*b4 + a2*b3 + a3*b2 - a4*b1 + a5*b0;
+        Real a0 = _mat[0][0]*_mat[1][1] - _mat[0][1]*_mat[1][0];
+        Real a1 = _mat[0][0]*_mat[1][2] - _mat[0][2]*_mat[1][0];
+        Real a2 = _mat[0][0]*_mat[1][3] - _mat[0][3]*_mat[1][0];
+        Real a3 = _mat[0][1]*_mat[1][2] - _mat[0][2]*_mat[1][1];
+        Real a4 = _mat[0][1]*_mat[1][3] - _mat[0][3]*_mat[1][1];
+        Real a5 = _mat[0][2]*_mat[1][3] - _mat[0][3]*_mat[1][2];
+        Real b0 = _mat[2][0]*_mat[3][1] - _mat[2][1]*_mat[3][0];
+        Real b1 = _mat[2][0]*_mat[3][2] - _mat[2][2]*_mat[3][0];
+        Real b2 = _mat[2][0]*_mat[3][3] - _mat[2][3]*_mat[3][0];
+        Real b3 = _mat[2][1]*_mat[3][2] - _mat[2][2]*_mat[3][1];
+        Real b4 = _mat[2][1]*_mat[3][3] - _mat[2][3]*_mat[3][1];
+        Real b5 = _mat[2][2]*_mat[3][3] - _mat[2][3]*_mat[3][2];
+
+        Real det = a0*b5 - a1*b4 + a2*b3 + a3*b2 - a4*b1 + a5*b0;
         if (fabs(det) < 0.00001)
         {
             LoadIdentity();
@@ -370,7 +370,7 @@ namespace MTF
             inverse._mat[2][3] = - _mat[2][0]*a4 + _mat[2][1]*a2 - _mat[2][3]*a0;
             inverse._mat[3][3] = + _mat[2][0]*a3 - _mat[2][1]*a1 + _mat[2][2]*a0;
 
-            double invDet = 1/det;
+            Real invDet = 1/det;
 
             for (int i = 0; i < 4; ++i)
                 for (int j = 0; j < 4; ++j)
@@ -428,6 +428,20 @@ namespace MTF
     }
 
 
+    // Sets the passed in array to this _matrix's values (column-major ordering)
+    void Matrix4::GetMatrixArray(float (&matArray)[16])
+    {
+        int index = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            for (int j = 0; j < 4; j++)
+            {
+                matArray[index++] = (float)_mat[j][i];
+            }
+        }
+    }
+
+
     std::string Matrix4::ToString()
     {
         std::stringstream str("");
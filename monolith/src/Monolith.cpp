@@ -34,6 +34,83 @@ namespace MTF
     }
 
 
+    Monolith::Monolith(Camera *camera, int port, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(port, 0, headFilter, wandFilter);
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::vector<TrackingSource> sources)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(sources, 0, PoseFilterChain(), PoseFilterChain());
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(sources, 0, headFilter, wandFilter);
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(sources, 0, headFilter, wandFilter, sharedMemoryName);
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::string sharedMemoryName)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(sharedMemoryName);
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::string captureFile, PacketReplay::TIMING timing)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(captureFile, timing, std::vector<TrackingSource>(), 0, PoseFilterChain(), PoseFilterChain());
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
+    Monolith::Monolith(Camera *camera, std::string captureFile, PacketReplay::TIMING timing, std::vector<TrackingSource> sources, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        _camera = camera;
+
+        _tracker = new TrackerUpdate(captureFile, timing, sources, 0, headFilter, wandFilter);
+        _tracker->Run();
+
+        _running = true;
+    }
+
+
     Monolith::~Monolith(void)
     {
         delete _tracker;
@@ -52,6 +129,174 @@ namespace MTF
     }
 
 
+    void Monolith::SetUser(int user, int headBodyId, int wandFlyStickId)
+    {
+        _tracker->SetUser(user, headBodyId, wandFlyStickId);
+    }
+
+
+    int Monolith::GetNumUsers()
+    {
+        return _tracker->GetNumUsers();
+    }
+
+
+    Head Monolith::GetUserHead(int user)
+    {
+        return _tracker->GetUserHead(user);
+    }
+
+
+    Wand Monolith::GetUserWand(int user)
+    {
+        return _tracker->GetUserWand(user);
+    }
+
+
+    int Monolith::GetNumBodies()
+    {
+        return _tracker->GetNumBodies();
+    }
+
+
+    Head Monolith::GetBody(int id)
+    {
+        return _tracker->GetBody(id);
+    }
+
+
+    int Monolith::GetNumFlySticks()
+    {
+        return _tracker->GetNumFlySticks();
+    }
+
+
+    Wand Monolith::GetFlyStick(int id)
+    {
+        return _tracker->GetFlyStick(id);
+    }
+
+
+    void Monolith::GetFrame(TrackingFrame &frame)
+    {
+        _tracker->GetFrame(frame);
+    }
+
+
+    Head Monolith::GetHead(long long targetTimeNs)
+    {
+        return _tracker->GetHead().Predict(targetTimeNs);
+    }
+
+
+    Wand Monolith::GetWand(long long targetTimeNs)
+    {
+        return _tracker->GetWand().Predict(targetTimeNs);
+    }
+
+
+    Head Monolith::GetHeadAt(long long timeNs)
+    {
+        return _tracker->GetHeadAt(timeNs);
+    }
+
+
+    Wand Monolith::GetWandAt(long long timeNs)
+    {
+        return _tracker->GetWandAt(timeNs);
+    }
+
+
+    unsigned long Monolith::GetFrameNumber()
+    {
+        return _tracker->GetFrameNumber();
+    }
+
+
+    bool Monolith::WaitForNextFrame(int timeoutMs)
+    {
+        return _tracker->WaitForFrame(_tracker->GetFrameNumber(), timeoutMs);
+    }
+
+
+    bool Monolith::WaitForNextFrame(unsigned long lastFrameNumber, int timeoutMs)
+    {
+        return _tracker->WaitForFrame(lastFrameNumber, timeoutMs);
+    }
+
+
+    int Monolith::Subscribe(FrameCallback callback, Subscription::THREAD thread)
+    {
+        return _tracker->Subscribe(callback, thread);
+    }
+
+
+    void Monolith::Unsubscribe(int id)
+    {
+        _tracker->Unsubscribe(id);
+    }
+
+
+    bool Monolith::PollWandEvent(WandEvent &event)
+    {
+        return _tracker->PollWandEvent(event);
+    }
+
+
+    unsigned long Monolith::GetDroppedWandEventCount()
+    {
+        return _tracker->GetDroppedWandEventCount();
+    }
+
+
+    bool Monolith::StartCapture(std::string filename)
+    {
+        return _tracker->StartCapture(filename);
+    }
+
+
+    void Monolith::StopCapture()
+    {
+        _tracker->StopCapture();
+    }
+
+
+    void Monolith::SetPredictionMode(PosePredictor::MODE mode)
+    {
+        _tracker->SetPredictionMode(mode);
+    }
+
+
+    void Monolith::SetProcessAllFrames(bool all)
+    {
+        _tracker->SetProcessAllFrames(all);
+    }
+
+
+    unsigned long Monolith::GetCoalescedFrameCount()
+    {
+        return _tracker->GetCoalescedFrameCount();
+    }
+
+
+    void Monolith::GetTelemetry(Telemetry &telemetry)
+    {
+        _tracker->GetTelemetry(telemetry);
+    }
+
+
+    bool Monolith::StartTelemetryDump(std::string filename, int intervalMs)
+    {
+        return _tracker->StartTelemetryDump(filename, intervalMs);
+    }
+
+
+    void Monolith::StopTelemetryDump()
+    {
+        _tracker->StopTelemetryDump();
+    }
+
+
     Camera* Monolith::GetCamera()
     {
         return _camera;
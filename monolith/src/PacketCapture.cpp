@@ -0,0 +1,91 @@
+#include "PacketCapture.h"
+
+#include <cstring>
+
+namespace MTF
+{
+
+    PacketCapture::PacketCapture(std::string filename)
+    {
+        _offset = 0;
+        _valid = false;
+
+        _file = fopen(filename.c_str(), "wb");
+        if (_file == NULL)
+            return;
+
+        boost::uint32_t header[2] = { VERSION, sizeof(MAGIC) + sizeof(header) };
+
+        _valid = fwrite(MAGIC, sizeof(MAGIC), 1, _file) == 1 &&
+                 fwrite(header, sizeof(header), 1, _file) == 1;
+        _offset = sizeof(MAGIC) + sizeof(header);
+    }
+
+
+    PacketCapture::~PacketCapture()
+    {
+        if (_file == NULL)
+            return;
+
+        // After a failed write the offsets may be off, so leave the index out and let the replay search the records
+        if (!_valid)
+        {
+            fclose(_file);
+            return;
+        }
+
+        CaptureTrailer trailer;
+        trailer.indexOffset = _offset;
+        trailer.count = _index.size();
+        memcpy(trailer.magic, INDEX_MAGIC, sizeof(trailer.magic));
+
+        if (!_index.empty())
+            fwrite(&_index[0], sizeof(boost::uint64_t), _index.size(), _file);
+        fwrite(&trailer, sizeof(trailer), 1, _file);
+
+        fclose(_file);
+    }
+
+
+    bool PacketCapture::IsValid()
+    {
+        return _valid;
+    }
+
+
+    void PacketCapture::Write(int source, const char *data, int length, long long receiveTimeNs)
+    {
+        if (!_valid || length < 0)
+            return;
+
+        CaptureRecord record;
+        record.receiveTimeNs = receiveTimeNs;
+        record.source = source;
+        record.length = length;
+
+        // Padding keeps every record 8 byte aligned, so a replay can read them in place
+        static const char padding[8] = { 0 };
+        int padded = (length + 7) & ~7;
+
+        _valid = fwrite(&record, sizeof(record), 1, _file) == 1 &&
+                 (length == 0 || fwrite(data, length, 1, _file) == 1) &&
+                 (padded == length || fwrite(padding, padded - length, 1, _file) == 1);
+
+        if (_valid)
+        {
+            _index.push_back(_offset);
+            _offset += sizeof(record) + padded;
+        }
+    }
+
+
+    int PacketCapture::GetNumPackets()
+    {
+        return _index.size();
+    }
+
+
+    const char PacketCapture::MAGIC[8] = { 'M', 'T', 'F', 'P', 'C', 'A', 'P', '1' };
+    const char PacketCapture::INDEX_MAGIC[8] = { 'M', 'T', 'F', 'P', 'I', 'D', 'X', '1' };
+
+}
@@ -0,0 +1,143 @@
+#include "PacketReplay.h"
+
+#include <cstring>
+
+namespace MTF
+{
+
+    PacketReplay::PacketReplay(std::string filename)
+    {
+        using namespace boost::interprocess;
+
+        _data = NULL;
+        _size = 0;
+        _index = NULL;
+        _count = 0;
+        _numSources = 0;
+
+        try
+        {
+            file_mapping file(filename.c_str(), read_only);
+            mapped_region region(file, read_only);
+
+            _file.swap(file);
+            _region.swap(region);
+        }
+        catch (interprocess_exception &)
+        {
+            return;
+        }
+
+        const char *data = static_cast<const char*>(_region.get_address());
+        boost::uint64_t size = _region.get_size();
+
+        boost::uint32_t header[2];
+        if (size < sizeof(PacketCapture::MAGIC) + sizeof(header) ||
+            memcmp(data, PacketCapture::MAGIC, sizeof(PacketCapture::MAGIC)) != 0)
+            return;
+
+        memcpy(header, data + sizeof(PacketCapture::MAGIC), sizeof(header));
+        if (header[0] != PacketCapture::VERSION || header[1] > size)
+            return;
+
+        _data = data;
+        _size = size;
+
+        // A capture that was not closed has no index, so look for the records one by one
+        if (!ReadIndex())
+            SearchRecords();
+
+        for (boost::uint64_t i = 0; i < _count; ++i)
+        {
+            const CaptureRecord *record = reinterpret_cast<const CaptureRecord*>(_data + _index[i]);
+            if ((int)record->source >= _numSources)
+                _numSources = record->source + 1;
+        }
+    }
+
+
+    PacketReplay::~PacketReplay()
+    {
+    }
+
+
+    bool PacketReplay::ReadIndex()
+    {
+        if (_size < sizeof(CaptureTrailer))
+            return false;
+
+        CaptureTrailer trailer;
+        memcpy(&trailer, _data + _size - sizeof(trailer), sizeof(trailer));
+
+        if (memcmp(trailer.magic, PacketCapture::INDEX_MAGIC, sizeof(trailer.magic)) != 0 ||
+            trailer.indexOffset + trailer.count * sizeof(boost::uint64_t) + sizeof(trailer) != _size)
+            return false;
+
+        const boost::uint64_t *index = reinterpret_cast<const boost::uint64_t*>(_data + trailer.indexOffset);
+        for (boost::uint64_t i = 0; i < trailer.count; ++i)
+        {
+            if (index[i] + sizeof(CaptureRecord) > trailer.indexOffset)
+                return false;
+        }
+
+        _index = index;
+        _count = trailer.count;
+        return true;
+    }
+
+
+    void PacketReplay::SearchRecords()
+    {
+        boost::uint32_t header[2];
+        memcpy(header, _data + sizeof(PacketCapture::MAGIC), sizeof(header));
+
+        // Stops at the first record that does not fit, the one being written when the capture ended
+        boost::uint64_t offset = header[1];
+        while (offset + sizeof(CaptureRecord) <= _size)
+        {
+            const CaptureRecord *record = reinterpret_cast<const CaptureRecord*>(_data + offset);
+            boost::uint64_t padded = (record->length + 7) & ~7;
+            if (offset + sizeof(CaptureRecord) + padded > _size)
+                break;
+
+            _searchedIndex.push_back(offset);
+            offset += sizeof(CaptureRecord) + padded;
+        }
+
+        _index = _searchedIndex.empty() ? NULL : &_searchedIndex[0];
+        _count = _searchedIndex.size();
+    }
+
+
+    bool PacketReplay::IsValid()
+    {
+        return _data != NULL;
+    }
+
+
+    int PacketReplay::GetNumPackets()
+    {
+        return (int)_count;
+    }
+
+
+    int PacketReplay::GetNumSources()
+    {
+        return _numSources;
+    }
+
+
+    bool PacketReplay::GetPacket(int index, int &source, const char *&data, int &length, long long &receiveTimeNs)
+    {
+        if (index < 0 || (boost::uint64_t)index >= _count)
+            return false;
+
+        const CaptureRecord *record = reinterpret_cast<const CaptureRecord*>(_data + _index[index]);
+        source = record->source;
+        data = _data + _index[index] + sizeof(CaptureRecord);
+        length = record->length;
+        receiveTimeNs = record->receiveTimeNs;
+        return true;
+    }
+
+}
@@ -0,0 +1,267 @@
+#include "PoseFilter.h"
+
+namespace MTF
+{
+
+    PoseFilter::~PoseFilter()
+    {
+    }
+
+
+    Real PoseFilter::GetTimeStep(double previous, double current)
+    {
+        // Samples without a usable time are assumed to be one 60 Hz frame apart
+        if (current > previous)
+            return current - previous;
+
+        return 1.0 / 60;
+    }
+
+
+    OutlierRejectionFilter::OutlierRejectionFilter(Real maxSpeed, Real maxAngularSpeed, Real minQuality, int maxRejected)
+    {
+        _maxSpeed = maxSpeed;
+        _maxAngularSpeed = maxAngularSpeed;
+        _minQuality = minQuality;
+        _maxRejected = maxRejected;
+
+        Reset();
+    }
+
+
+    bool OutlierRejectionFilter::Apply(PoseSample &sample)
+    {
+        if (sample.quality < _minQuality)
+            return false;
+
+        if (_initialized)
+        {
+            Real dt = GetTimeStep(_last.time, sample.time);
+            Real speed = (sample.position - _last.position).GetLength() / dt;
+            Real angularSpeed = (_last.orientation.GetConjugate() * sample.orientation).GetAngle() / dt;
+
+            bool jumped = (_maxSpeed > 0 && speed > _maxSpeed) ||
+                          (_maxAngularSpeed > 0 && angularSpeed > _maxAngularSpeed);
+
+            if (jumped && _rejected < _maxRejected)
+            {
+                ++_rejected;
+                return false;
+            }
+        }
+
+        _initialized = true;
+        _rejected = 0;
+        _last = sample;
+        return true;
+    }
+
+
+    void OutlierRejectionFilter::Reset()
+    {
+        _initialized = false;
+        _rejected = 0;
+    }
+
+
+    PoseFilter* OutlierRejectionFilter::Clone()
+    {
+        return new OutlierRejectionFilter(_maxSpeed, _maxAngularSpeed, _minQuality, _maxRejected);
+    }
+
+
+    ExponentialFilter::ExponentialFilter(Real positionAlpha, Real orientationAlpha)
+    {
+        _positionAlpha = positionAlpha;
+        _orientationAlpha = orientationAlpha;
+
+        Reset();
+    }
+
+
+    bool ExponentialFilter::Apply(PoseSample &sample)
+    {
+        if (!_initialized)
+        {
+            _initialized = true;
+            _last = sample;
+            return true;
+        }
+
+        Real weight = sample.quality;
+        if (weight > 1.0)
+            weight = 1.0;
+        if (weight < 0.0)
+            weight = 0.0;
+
+        sample.position = _last.position + (sample.position - _last.position) * (_positionAlpha * weight);
+        sample.orientation = Quaternion::Slerp(_last.orientation, sample.orientation, _orientationAlpha * weight);
+
+        _last = sample;
+        return true;
+    }
+
+
+    void ExponentialFilter::Reset()
+    {
+        _initialized = false;
+    }
+
+
+    PoseFilter* ExponentialFilter::Clone()
+    {
+        return new ExponentialFilter(_positionAlpha, _orientationAlpha);
+    }
+
+
+    OneEuroFilter::OneEuroFilter(Real minCutoff, Real beta, Real derivativeCutoff)
+    {
+        _minCutoff = _orientationMinCutoff = minCutoff;
+        _beta = _orientationBeta = beta;
+        _derivativeCutoff = derivativeCutoff;
+
+        Reset();
+    }
+
+
+    OneEuroFilter::OneEuroFilter(Real minCutoff, Real beta, Real orientationMinCutoff, Real orientationBeta, Real derivativeCutoff)
+    {
+        _minCutoff = minCutoff;
+        _beta = beta;
+        _orientationMinCutoff = orientationMinCutoff;
+        _orientationBeta = orientationBeta;
+        _derivativeCutoff = derivativeCutoff;
+
+        Reset();
+    }
+
+
+    // Smoothing factor of a first order low-pass filter with the given cutoff frequency
+    Real OneEuroFilter::GetAlpha(Real cutoff, Real timeStep)
+    {
+        Real tau = 1.0 / (2 * 3.14159265358979323846 * cutoff);
+        return 1.0 / (1.0 + tau / timeStep);
+    }
+
+
+    bool OneEuroFilter::Apply(PoseSample &sample)
+    {
+        if (!_initialized)
+        {
+            _initialized = true;
+            _speed = 0;
+            _angularSpeed = 0;
+            _last = sample;
+            return true;
+        }
+
+        Real dt = GetTimeStep(_last.time, sample.time);
+        Real derivativeAlpha = GetAlpha(_derivativeCutoff, dt);
+
+        // Position: the cutoff follows the smoothed speed
+        Real speed = (sample.position - _last.position).GetLength() / dt;
+        _speed += derivativeAlpha * (speed - _speed);
+
+        Real alpha = GetAlpha(_minCutoff + _beta * _speed, dt);
+        sample.position = _last.position + (sample.position - _last.position) * alpha;
+
+        // Orientation: the same on the sphere, with the angular speed and slerp
+        Real angularSpeed = (_last.orientation.GetConjugate() * sample.orientation).GetAngle() / dt;
+        _angularSpeed += derivativeAlpha * (angularSpeed - _angularSpeed);
+
+        alpha = GetAlpha(_orientationMinCutoff + _orientationBeta * _angularSpeed, dt);
+        sample.orientation = Quaternion::Slerp(_last.orientation, sample.orientation, alpha);
+
+        _last = sample;
+        return true;
+    }
+
+
+    void OneEuroFilter::Reset()
+    {
+        _initialized = false;
+        _speed = 0;
+        _angularSpeed = 0;
+    }
+
+
+    PoseFilter* OneEuroFilter::Clone()
+    {
+        return new OneEuroFilter(_minCutoff, _beta, _orientationMinCutoff, _orientationBeta, _derivativeCutoff);
+    }
+
+
+    PoseFilterChain::PoseFilterChain()
+    {
+    }
+
+
+    PoseFilterChain::PoseFilterChain(const PoseFilterChain &chain)
+    {
+        for (unsigned int i = 0; i < chain._filters.size(); ++i)
+            _filters.push_back(chain._filters[i]->Clone());
+    }
+
+
+    PoseFilterChain& PoseFilterChain::operator = (const PoseFilterChain &chain)
+    {
+        if (this != &chain)
+        {
+            Clear();
+            for (unsigned int i = 0; i < chain._filters.size(); ++i)
+                _filters.push_back(chain._filters[i]->Clone());
+        }
+
+        return *this;
+    }
+
+
+    PoseFilterChain::~PoseFilterChain()
+    {
+        Clear();
+    }
+
+
+    PoseFilterChain& PoseFilterChain::Add(PoseFilter *filter)
+    {
+        if (filter != NULL)
+            _filters.push_back(filter);
+
+        return *this;
+    }
+
+
+    bool PoseFilterChain::Apply(PoseSample &sample)
+    {
+        for (unsigned int i = 0; i < _filters.size(); ++i)
+        {
+            if (!_filters[i]->Apply(sample))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    void PoseFilterChain::Reset()
+    {
+        for (unsigned int i = 0; i < _filters.size(); ++i)
+            _filters[i]->Reset();
+    }
+
+
+    bool PoseFilterChain::IsEmpty()
+    {
+        return _filters.empty();
+    }
+
+
+    void PoseFilterChain::Clear()
+    {
+        for (unsigned int i = 0; i < _filters.size(); ++i)
+            delete _filters[i];
+
+        _filters.clear();
+    }
+
+}
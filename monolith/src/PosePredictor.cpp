@@ -0,0 +1,223 @@
+#include "PosePredictor.h"
+
+namespace MTF
+{
+
+    PosePredictor::PosePredictor()
+    {
+        Initialize(CONSTANT_VELOCITY, DEFAULT_ACCELERATION, DEFAULT_POSITION_NOISE, DEFAULT_ANGULAR_ACCELERATION, DEFAULT_ORIENTATION_NOISE);
+    }
+
+
+    PosePredictor::PosePredictor(MODE mode)
+    {
+        Initialize(mode, DEFAULT_ACCELERATION, DEFAULT_POSITION_NOISE, DEFAULT_ANGULAR_ACCELERATION, DEFAULT_ORIENTATION_NOISE);
+    }
+
+
+    PosePredictor::PosePredictor(MODE mode, Real acceleration, Real positionNoise, Real angularAcceleration, Real orientationNoise)
+    {
+        Initialize(mode, acceleration, positionNoise, angularAcceleration, orientationNoise);
+    }
+
+
+    void PosePredictor::Initialize(MODE mode, Real acceleration, Real positionNoise, Real angularAcceleration, Real orientationNoise)
+    {
+        _mode = mode;
+
+        _accelerationVariance = acceleration * acceleration;
+        _positionVariance = positionNoise * positionNoise;
+        _angularAccelerationVariance = angularAcceleration * angularAcceleration;
+        _orientationVariance = orientationNoise * orientationNoise;
+
+        Reset();
+    }
+
+
+    PosePredictor::~PosePredictor()
+    {
+    }
+
+
+    void PosePredictor::Update(Vector3 position, Quaternion orientation, double time)
+    {
+        if (_mode == NONE)
+            return;
+
+        if (!_initialized)
+        {
+            _initialized = true;
+            _time = time;
+            _position = position;
+            _orientation = orientation;
+
+            KalmanInit(_positionAxes[0], position.GetX(), _positionVariance);
+            KalmanInit(_positionAxes[1], position.GetY(), _positionVariance);
+            KalmanInit(_positionAxes[2], position.GetZ(), _positionVariance);
+
+            for (int i = 0; i < 3; ++i)
+                KalmanInit(_orientationAxes[i], 0.0, _orientationVariance);
+            return;
+        }
+
+        // Samples without a usable time are assumed to be one 60 Hz frame apart
+        Real dt = (time > _time) ? time - _time : 1.0 / 60;
+        _time = time;
+
+        // Rotation from the last orientation to the new one, in tracker coordinates
+        Vector3 rotation = (orientation * _orientation.GetConjugate()).GetRotationVector();
+
+        if (_mode == CONSTANT_VELOCITY)
+        {
+            _velocity = (position - _position) / dt;
+            _angularVelocity = rotation / dt;
+
+            _position = position;
+            _orientation = orientation;
+            return;
+        }
+
+        Real measuredPosition[3] = { position.GetX(), position.GetY(), position.GetZ() };
+        Real measuredRotation[3] = { rotation.GetX(), rotation.GetY(), rotation.GetZ() };
+
+        // The orientation axes hold the rotation since the last estimate, so they start each frame at zero
+        for (int i = 0; i < 3; ++i)
+        {
+            KalmanPredict(_positionAxes[i], dt, _accelerationVariance);
+            KalmanCorrect(_positionAxes[i], measuredPosition[i], _positionVariance);
+
+            KalmanPredict(_orientationAxes[i], dt, _angularAccelerationVariance);
+            KalmanCorrect(_orientationAxes[i], measuredRotation[i], _orientationVariance);
+        }
+
+        _position = Vector3(_positionAxes[0].value, _positionAxes[1].value, _positionAxes[2].value);
+        _velocity = Vector3(_positionAxes[0].rate, _positionAxes[1].rate, _positionAxes[2].rate);
+
+        Vector3 correction(_orientationAxes[0].value, _orientationAxes[1].value, _orientationAxes[2].value);
+        _orientation = (Quaternion::FromRotationVector(correction) * _orientation).GetNormalized();
+        _angularVelocity = Vector3(_orientationAxes[0].rate, _orientationAxes[1].rate, _orientationAxes[2].rate);
+
+        for (int i = 0; i < 3; ++i)
+            _orientationAxes[i].value = 0.0;
+    }
+
+
+    void PosePredictor::Reset()
+    {
+        _initialized = false;
+        _time = 0;
+        _velocity = Vector3::ZERO;
+        _angularVelocity = Vector3::ZERO;
+    }
+
+
+    PosePredictor::MODE PosePredictor::GetMode()
+    {
+        return _mode;
+    }
+
+
+    void PosePredictor::SetMode(MODE mode)
+    {
+        _mode = mode;
+        Reset();
+    }
+
+
+    Vector3 PosePredictor::GetVelocity()
+    {
+        return _velocity;
+    }
+
+
+    Vector3 PosePredictor::GetAngularVelocity()
+    {
+        return _angularVelocity;
+    }
+
+
+    Vector3 PosePredictor::Extrapolate(Vector3 position, Vector3 velocity, Real seconds)
+    {
+        if (seconds > MAX_PREDICTION)
+            seconds = MAX_PREDICTION;
+        if (seconds < -MAX_PREDICTION)
+            seconds = -MAX_PREDICTION;
+
+        return position + velocity * seconds;
+    }
+
+
+    Quaternion PosePredictor::GetRotation(Vector3 angularVelocity, Real seconds)
+    {
+        if (seconds > MAX_PREDICTION)
+            seconds = MAX_PREDICTION;
+        if (seconds < -MAX_PREDICTION)
+            seconds = -MAX_PREDICTION;
+
+        return Quaternion::FromRotationVector(angularVelocity * seconds);
+    }
+
+
+    void PosePredictor::KalmanInit(KalmanAxis &axis, Real value, Real measurementVariance)
+    {
+        axis.value = value;
+        axis.rate = 0.0;
+
+        // The rate is unknown at first, so start with a large variance for it
+        axis.p00 = measurementVariance;
+        axis.p01 = axis.p10 = 0.0;
+        axis.p11 = 100.0;
+    }
+
+
+    void PosePredictor::KalmanPredict(KalmanAxis &axis, Real dt, Real processVariance)
+    {
+        Real dt2 = dt * dt;
+
+        axis.value += axis.rate * dt;
+
+        // P = F P F' + Q, with F = [1 dt; 0 1] and Q from a random acceleration
+        Real p00 = axis.p00 + dt * (axis.p01 + axis.p10) + dt2 * axis.p11 + processVariance * dt2 * dt2 / 4;
+        Real p01 = axis.p01 + dt * axis.p11 + processVariance * dt2 * dt / 2;
+        Real p10 = axis.p10 + dt * axis.p11 + processVariance * dt2 * dt / 2;
+        Real p11 = axis.p11 + processVariance * dt2;
+
+        axis.p00 = p00;
+        axis.p01 = p01;
+        axis.p10 = p10;
+        axis.p11 = p11;
+    }
+
+
+    void PosePredictor::KalmanCorrect(KalmanAxis &axis, Real measured, Real measurementVariance)
+    {
+        Real s = axis.p00 + measurementVariance;
+        Real k0 = axis.p00 / s;
+        Real k1 = axis.p10 / s;
+        Real innovation = measured - axis.value;
+
+        axis.value += k0 * innovation;
+        axis.rate += k1 * innovation;
+
+        // P = (I - K H) P
+        Real p00 = (1 - k0) * axis.p00;
+        Real p01 = (1 - k0) * axis.p01;
+        Real p10 = axis.p10 - k1 * axis.p00;
+        Real p11 = axis.p11 - k1 * axis.p01;
+
+        axis.p00 = p00;
+        axis.p01 = p01;
+        axis.p10 = p10;
+        axis.p11 = p11;
+    }
+
+
+    const Real PosePredictor::MAX_PREDICTION = 0.1;
+
+    // About 20 ft/s^2 and 30 rad/s^2 for quick head and hand motion, 0.6 mm and 0.1 degree of tracking noise
+    const Real PosePredictor::DEFAULT_ACCELERATION = 20.0;
+    const Real PosePredictor::DEFAULT_POSITION_NOISE = 0.002;
+    const Real PosePredictor::DEFAULT_ANGULAR_ACCELERATION = 30.0;
+    const Real PosePredictor::DEFAULT_ORIENTATION_NOISE = 0.002;
+
+}
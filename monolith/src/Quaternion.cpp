@@ -0,0 +1,234 @@
+#include "Quaternion.h"
+
+namespace MTF
+{
+
+    Quaternion::Quaternion()
+    {
+        _w = 1.0;
+        _x = _y = _z = 0.0;
+    }
+
+
+    Quaternion::Quaternion(Real w, Real x, Real y, Real z)
+    {
+        _w = w;
+        _x = x;
+        _y = y;
+        _z = z;
+    }
+
+
+    // Builds the quaternion from the rotation matrix whose columns are the right, up, and view vectors
+    Quaternion::Quaternion(Vector3 view, Vector3 right, Vector3 up)
+    {
+        Real m00 = right.GetX(), m01 = up.GetX(), m02 = view.GetX();
+        Real m10 = right.GetY(), m11 = up.GetY(), m12 = view.GetY();
+        Real m20 = right.GetZ(), m21 = up.GetZ(), m22 = view.GetZ();
+
+        Real trace = m00 + m11 + m22;
+
+        // Use the largest of w, x, y, and z to divide by, so the result stays accurate
+        if (trace > 0)
+        {
+            Real s = sqrt(trace + 1.0) * 2;
+            _w = 0.25 * s;
+            _x = (m21 - m12) / s;
+            _y = (m02 - m20) / s;
+            _z = (m10 - m01) / s;
+        }
+        else if (m00 > m11 && m00 > m22)
+        {
+            Real s = sqrt(1.0 + m00 - m11 - m22) * 2;
+            _w = (m21 - m12) / s;
+            _x = 0.25 * s;
+            _y = (m01 + m10) / s;
+            _z = (m02 + m20) / s;
+        }
+        else if (m11 > m22)
+        {
+            Real s = sqrt(1.0 + m11 - m00 - m22) * 2;
+            _w = (m02 - m20) / s;
+            _x = (m01 + m10) / s;
+            _y = 0.25 * s;
+            _z = (m12 + m21) / s;
+        }
+        else
+        {
+            Real s = sqrt(1.0 + m22 - m00 - m11) * 2;
+            _w = (m10 - m01) / s;
+            _x = (m02 + m20) / s;
+            _y = (m12 + m21) / s;
+            _z = 0.25 * s;
+        }
+
+        Normalize();
+    }
+
+
+    Quaternion::Quaternion(Vector3 axis, Real angle)
+    {
+        Real s = sin(angle / 2);
+        _w = cos(angle / 2);
+        _x = axis.GetX() * s;
+        _y = axis.GetY() * s;
+        _z = axis.GetZ() * s;
+    }
+
+
+    Quaternion::~Quaternion()
+    {
+    }
+
+
+    // * Overload: handles "Quaternion * Quaternion"
+    Quaternion Quaternion::operator * (Quaternion param)
+    {
+        return Quaternion(_w * param._w - _x * param._x - _y * param._y - _z * param._z,
+                          _w * param._x + _x * param._w + _y * param._z - _z * param._y,
+                          _w * param._y - _x * param._z + _y * param._w + _z * param._x,
+                          _w * param._z + _x * param._y - _y * param._x + _z * param._w);
+    }
+
+
+    // * Overload: handles "Quaternion * Vector3", rotating the vector
+    Vector3 Quaternion::operator * (Vector3 param)
+    {
+        // v' = v + 2w(q x v) + 2(q x (q x v)), with q the vector part
+        Vector3 q(_x, _y, _z);
+        Vector3 t = q.CrossProduct(param) * 2.0;
+        return param + t * _w + q.CrossProduct(t);
+    }
+
+
+    Real Quaternion::DotProduct(Quaternion param)
+    {
+        return _w * param._w + _x * param._x + _y * param._y + _z * param._z;
+    }
+
+
+    Quaternion Quaternion::GetConjugate()
+    {
+        return Quaternion(_w, -_x, -_y, -_z);
+    }
+
+
+    void Quaternion::Normalize()
+    {
+        Real magnitude = sqrt(_w * _w + _x * _x + _y * _y + _z * _z);
+        if (magnitude > 0)
+        {
+            _w /= magnitude;
+            _x /= magnitude;
+            _y /= magnitude;
+            _z /= magnitude;
+        }
+        else
+        {
+            _w = 1.0;
+            _x = _y = _z = 0.0;
+        }
+    }
+
+
+    Quaternion Quaternion::GetNormalized()
+    {
+        Quaternion norm(_w, _x, _y, _z);
+        norm.Normalize();
+        return norm;
+    }
+
+
+    Real Quaternion::GetAngle()
+    {
+        return GetRotationVector().GetLength();
+    }
+
+
+    Vector3 Quaternion::GetRotationVector()
+    {
+        // q and -q are the same orientation, use the one with the smaller angle
+        Real sign = (_w < 0) ? -1.0 : 1.0;
+        Vector3 axis(_x * sign, _y * sign, _z * sign);
+
+        Real s = axis.GetLength();
+        if (s < 1e-12)
+            return axis * 2.0;  // small angle: sin(a/2) ~ a/2
+
+        return axis * (2.0 * atan2(s, _w * sign) / s);
+    }
+
+
+    Vector3 Quaternion::GetViewVector()
+    {
+        return *this * Vector3::UNIT_Z;
+    }
+
+
+    Vector3 Quaternion::GetRightVector()
+    {
+        return *this * Vector3::UNIT_X;
+    }
+
+
+    Vector3 Quaternion::GetUpVector()
+    {
+        return *this * Vector3::UNIT_Y;
+    }
+
+
+    std::string Quaternion::ToString()
+    {
+        std::stringstream str("");
+
+        str << "(" << std::setw(5) << _w << ", " << std::setw(5) << _x << ", " << std::setw(5) << _y << ", " << std::setw(5) << _z << ")" << std::endl;
+
+        return str.str();
+    }
+
+
+    Real Quaternion::GetW()
+    {
+        return _w;
+    }
+
+
+    Real Quaternion::GetX()
+    {
+        return _x;
+    }
+
+
+    Real Quaternion::GetY()
+    {
+        return _y;
+    }
+
+
+    Real Quaternion::GetZ()
+    {
+        return _z;
+    }
+
+
+    Quaternion Quaternion::FromRotationVector(Vector3 rotation)
+    {
+        Real angle = rotation.GetLength();
+        if (angle < 1e-12)
+            return Quaternion(1.0, rotation.GetX() / 2, rotation.GetY() / 2, rotation.GetZ() / 2).GetNormalized();
+
+        return Quaternion(rotation / angle, angle);
+    }
+
+
+    Quaternion Quaternion::Slerp(Quaternion from, Quaternion to, Real t)
+    {
+        // Rotation from 'from' to 'to', scaled by t and applied to 'from'
+        Quaternion delta = from.GetConjugate() * to;
+        return (from * FromRotationVector(delta.GetRotationVector() * t)).GetNormalized();
+    }
+
+
+    Quaternion const Quaternion::IDENTITY = Quaternion(1.0, 0.0, 0.0, 0.0);
+
+}
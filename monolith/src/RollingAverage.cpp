@@ -0,0 +1,84 @@
+#include "RollingAverage.h"
+
+namespace MTF
+{
+
+    RollingAverage::RollingAverage()
+    {
+        _capacity = 0;
+        Clear();
+    }
+
+
+    RollingAverage::RollingAverage(int samples)
+    {
+        if (samples < 0)
+            samples = 0;
+        if (samples > MAX_SAMPLES)
+            samples = MAX_SAMPLES;
+
+        _capacity = samples;
+        Clear();
+    }
+
+
+    RollingAverage::~RollingAverage()
+    {
+    }
+
+
+    void RollingAverage::Add(const Vector3 &sample)
+    {
+        if (_capacity == 0)
+            return;
+
+        if (_count == _capacity)
+            _sum -= _samples[_next];
+        else
+            ++_count;
+
+        _samples[_next] = sample;
+        _sum += sample;
+
+        if (++_next == _capacity)
+        {
+            _next = 0;
+
+            // Once per pass through the ring, rebuild the sum so that rounding
+            // errors from the repeated add/subtract cannot build up
+            _sum = Vector3::ZERO;
+            for (int i = 0; i < _count; ++i)
+                _sum += _samples[i];
+        }
+    }
+
+
+    void RollingAverage::Clear()
+    {
+        _count = 0;
+        _next = 0;
+        _sum = Vector3::ZERO;
+    }
+
+
+    int RollingAverage::GetCount()
+    {
+        return _count;
+    }
+
+
+    int RollingAverage::GetCapacity()
+    {
+        return _capacity;
+    }
+
+
+    Vector3 RollingAverage::GetAverage()
+    {
+        if (_count == 0)
+            return Vector3::ZERO;
+
+        return _sum * (1.0 / _count);
+    }
+
+}
@@ -0,0 +1,96 @@
+#include "SharedFrameStore.h"
+
+#include <new>
+
+#include <boost/static_assert.hpp>
+
+namespace MTF
+{
+
+    // Atomics that need a lock would keep it in one process only
+    BOOST_STATIC_ASSERT(BOOST_ATOMIC_INT_LOCK_FREE == 2 && BOOST_ATOMIC_LONG_LOCK_FREE == 2);
+
+
+    SharedFrameStore::SharedFrameStore(std::string name, bool create)
+    {
+        using namespace boost::interprocess;
+
+        _name = name;
+        _created = false;
+        _layout = NULL;
+
+        try
+        {
+            if (create)
+            {
+                shared_memory_object::remove(name.c_str());
+
+                shared_memory_object memory(create_only, name.c_str(), read_write);
+                memory.truncate(sizeof(Layout));
+                mapped_region region(memory, read_write);
+
+                _memory.swap(memory);
+                _region.swap(region);
+                _created = true;
+
+                // Readers wait for ready, so the rest of the header can be filled in first
+                Layout *layout = new (_region.get_address()) Layout();
+                layout->header.ready.store(0, boost::memory_order_relaxed);
+                layout->header.magic = MAGIC;
+                layout->header.version = VERSION;
+                layout->header.storeSize = sizeof(FrameStore);
+                layout->header.ready.store(1, boost::memory_order_release);
+
+                _layout = layout;
+            }
+            else
+            {
+                shared_memory_object memory(open_only, name.c_str(), read_only);
+                mapped_region region(memory, read_only);
+
+                _memory.swap(memory);
+                _region.swap(region);
+
+                Layout *layout = static_cast<Layout*>(_region.get_address());
+                if (_region.get_size() >= sizeof(Layout) &&
+                    layout->header.ready.load(boost::memory_order_acquire) == 1 &&
+                    layout->header.magic == MAGIC &&
+                    layout->header.version == VERSION &&
+                    layout->header.storeSize == sizeof(FrameStore))
+                {
+                    _layout = layout;
+                }
+            }
+        }
+        catch (interprocess_exception &)
+        {
+            _layout = NULL;
+
+            if (create)
+            {
+                shared_memory_object::remove(name.c_str());
+                _created = false;
+            }
+        }
+    }
+
+
+    SharedFrameStore::~SharedFrameStore()
+    {
+        if (_created)
+            boost::interprocess::shared_memory_object::remove(_name.c_str());
+    }
+
+
+    bool SharedFrameStore::IsValid()
+    {
+        return _layout != NULL;
+    }
+
+
+    FrameStore* SharedFrameStore::GetStore()
+    {
+        return _layout != NULL ? &_layout->store : NULL;
+    }
+
+}
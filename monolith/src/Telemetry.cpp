@@ -0,0 +1,227 @@
+#include "Telemetry.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace MTF
+{
+
+    namespace
+    {
+        // Only the thread that records writes the counters, so a plain load and store is
+        // enough.  That avoids the locked add of fetch_add on every frame.
+        template <class T>
+        void AddTo(boost::atomic<T> &counter, T value)
+        {
+            counter.store(counter.load(boost::memory_order_relaxed) + value, boost::memory_order_relaxed);
+        }
+
+        template <class T>
+        void Set(boost::atomic<T> &counter, T value)
+        {
+            counter.store(value, boost::memory_order_relaxed);
+        }
+
+        template <class T>
+        T Get(const boost::atomic<T> &counter)
+        {
+            return counter.load(boost::memory_order_relaxed);
+        }
+
+        const char *LINE_TYPE_NAMES[Telemetry::NUM_LINE_TYPES] =
+        {
+            "fr", "ts", "6dcal", "6d", "6df", "6df2", "6dmt", "glcal", "gl", "3d"
+        };
+
+        void WriteHistogram(std::ostringstream &str, const char *name, const TelemetryHistogram &histogram)
+        {
+            str << ",\"" << name << "\":{\"count\":" << histogram.count
+                << ",\"totalNs\":" << histogram.totalNs
+                << ",\"maxNs\":" << histogram.maxNs
+                << ",\"buckets\":[";
+            for (int i = 0; i < TelemetryHistogram::NUM_BUCKETS; ++i)
+                str << (i > 0 ? "," : "") << histogram.counts[i];
+            str << "]}";
+        }
+    }
+
+    int TelemetryHistogram::GetBucket(long long durationNs)
+    {
+        long long us = durationNs / 1000;
+
+        int bucket = 0;
+        while (us > 0 && bucket < NUM_BUCKETS - 1)
+        {
+            us >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+
+    long long TelemetryHistogram::GetBucketStartUs(int bucket)
+    {
+        return bucket <= 0 ? 0 : 1LL << (bucket - 1);
+    }
+
+
+    std::string Telemetry::ToJson() const
+    {
+        std::ostringstream str;
+
+        str << "{\"timeNs\":" << timeNs
+            << ",\"packetsReceived\":" << packetsReceived
+            << ",\"framesPublished\":" << framesPublished
+            << ",\"frameGaps\":" << frameGaps
+            << ",\"coalescedFrames\":" << coalescedFrames
+            << ",\"parseErrors\":{";
+        for (int i = 0; i < NUM_LINE_TYPES; ++i)
+            str << (i > 0 ? "," : "") << "\"" << LINE_TYPE_NAMES[i] << "\":" << parseErrors[i];
+        str << "},\"timeouts\":" << timeouts
+            << ",\"networkErrors\":" << networkErrors
+            << ",\"droppedWandEvents\":" << droppedWandEvents
+            << ",\"jitterNs\":" << jitterNs;
+
+        WriteHistogram(str, "interArrival", interArrival);
+        WriteHistogram(str, "parse", parse);
+        WriteHistogram(str, "publish", publish);
+        str << "}";
+
+        return str.str();
+    }
+
+
+    const char* Telemetry::GetLineTypeName(int lineType)
+    {
+        if (lineType < 0 || lineType >= NUM_LINE_TYPES)
+            return "";
+        return LINE_TYPE_NAMES[lineType];
+    }
+
+
+    TelemetryRecorder::TelemetryRecorder()
+    {
+        Set(_packets, 0UL);
+        Set(_frameGaps, 0UL);
+        for (int i = 0; i < Telemetry::NUM_LINE_TYPES; ++i)
+            Set(_parseErrors[i], 0UL);
+        Set(_sourceTimeouts, 0UL);
+        Set(_sourceNetworkErrors, 0UL);
+        Set(_timeouts, 0UL);
+        Set(_networkErrors, 0UL);
+        Set(_jitterNs, 0LL);
+
+        _interArrival.Reset();
+        _parse.Reset();
+        _publish.Reset();
+
+        _lastReceiveTimeNs = -1;
+        _lastIntervalNs = -1;
+        _jitter = 0.0;
+    }
+
+
+    void TelemetryRecorder::SetSourceStatistics(const DTrack_Statistics_Type &statistics)
+    {
+        Set(_packets, statistics.packets);
+        Set(_frameGaps, statistics.frame_gaps);
+        for (int i = 0; i < Telemetry::NUM_LINE_TYPES; ++i)
+            Set(_parseErrors[i], statistics.parse_errors[i]);
+        Set(_sourceTimeouts, statistics.timeouts);
+        Set(_sourceNetworkErrors, statistics.net_errors);
+    }
+
+
+    void TelemetryRecorder::RecordTimeout()
+    {
+        AddTo(_timeouts, 1UL);
+    }
+
+
+    void TelemetryRecorder::RecordNetworkError()
+    {
+        AddTo(_networkErrors, 1UL);
+    }
+
+
+    void TelemetryRecorder::RecordParse(long long durationNs)
+    {
+        _parse.Add(durationNs);
+    }
+
+
+    void TelemetryRecorder::RecordFrame(long long receiveTimeNs, long long publishNs)
+    {
+        _publish.Add(publishNs);
+
+        if (receiveTimeNs < 0)
+            return;
+
+        if (_lastReceiveTimeNs >= 0 && receiveTimeNs >= _lastReceiveTimeNs)
+        {
+            long long intervalNs = receiveTimeNs - _lastReceiveTimeNs;
+            _interArrival.Add(intervalNs);
+
+            // The tracker sends at a fixed rate, so any change of the interval is jitter.
+            // Smoothed with a gain of 1/16, like the interarrival jitter of RFC 3550.
+            if (_lastIntervalNs >= 0)
+            {
+                double change = (double)(intervalNs - _lastIntervalNs);
+                _jitter += (std::fabs(change) - _jitter) / 16.0;
+                Set(_jitterNs, (long long)_jitter);
+            }
+            _lastIntervalNs = intervalNs;
+        }
+        _lastReceiveTimeNs = receiveTimeNs;
+    }
+
+
+    void TelemetryRecorder::GetSnapshot(Telemetry &telemetry) const
+    {
+        telemetry.packetsReceived = Get(_packets);
+        telemetry.frameGaps = Get(_frameGaps);
+        for (int i = 0; i < Telemetry::NUM_LINE_TYPES; ++i)
+            telemetry.parseErrors[i] = Get(_parseErrors[i]);
+        telemetry.timeouts = Get(_timeouts) + Get(_sourceTimeouts);
+        telemetry.networkErrors = Get(_networkErrors) + Get(_sourceNetworkErrors);
+        telemetry.jitterNs = Get(_jitterNs);
+
+        _interArrival.Read(telemetry.interArrival);
+        _parse.Read(telemetry.parse);
+        _publish.Read(telemetry.publish);
+    }
+
+
+    void TelemetryRecorder::Histogram::Reset()
+    {
+        for (int i = 0; i < TelemetryHistogram::NUM_BUCKETS; ++i)
+            Set(counts[i], 0UL);
+        Set(count, 0UL);
+        Set(totalNs, 0LL);
+        Set(maxNs, 0LL);
+    }
+
+
+    void TelemetryRecorder::Histogram::Add(long long durationNs)
+    {
+        if (durationNs < 0)
+            durationNs = 0;
+
+        AddTo(counts[TelemetryHistogram::GetBucket(durationNs)], 1UL);
+        AddTo(count, 1UL);
+        AddTo(totalNs, durationNs);
+        if (durationNs > Get(maxNs))
+            Set(maxNs, durationNs);
+    }
+
+
+    void TelemetryRecorder::Histogram::Read(TelemetryHistogram &histogram) const
+    {
+        for (int i = 0; i < TelemetryHistogram::NUM_BUCKETS; ++i)
+            histogram.counts[i] = Get(counts[i]);
+        histogram.count = Get(count);
+        histogram.totalNs = Get(totalNs);
+        histogram.maxNs = Get(maxNs);
+    }
+
+}
@@ -1,39 +1,316 @@
 #include "TrackerUpdate.h"
 
+#include <algorithm>
+
 namespace MTF
 {
 
-    TrackerUpdate::TrackerUpdate(int port)
+    namespace
     {
-        _port = port;
-        _stopRequested = false;
+        // Copies one entry of a table in the published frame, so reading one body
+        // doesn't copy the whole frame.  Called again if the frame changed meanwhile.
+        template <class State, int N>
+        struct EntryReader
+        {
+            EntryReader(State (TrackingFrame::*table)[N], int TrackingFrame::*count, int index)
+                : table(table), count(count), index(index), found(false)
+            {
+            }
+
+            void operator()(const TrackingFrame &frame)
+            {
+                found = index >= 0 && index < N && index < frame.*count;
+                if (found)
+                    state = (frame.*table)[index];
+            }
+
+            State (TrackingFrame::*table)[N];
+            int TrackingFrame::*count;
+            int index;
+
+            bool found;
+            State state;
+        };
+
+        // Copies one count out of the published frame
+        struct CountReader
+        {
+            CountReader(int TrackingFrame::*member) : member(member), count(0)
+            {
+            }
+
+            void operator()(const TrackingFrame &frame)
+            {
+                count = frame.*member;
+            }
+
+            int TrackingFrame::*member;
+            int count;
+        };
+
+        // Copies the arrival time out of a frame of the history
+        struct TimeReader
+        {
+            TimeReader() : receiveTimeNs(-1)
+            {
+            }
+
+            void operator()(const TrackingFrame &frame)
+            {
+                receiveTimeNs = frame.receiveTimeNs;
+            }
+
+            long long receiveTimeNs;
+        };
+
+        // Moves a location in mm and a column-wise rotation from the coordinates of a
+        // source into the shared ones.  calibration is column-wise as well, with the
+        // translation in feet.
+        void Calibrate(const double (&calibration)[16], double loc[3], double rot[9])
+        {
+            double newLoc[3];
+            double newRot[9];
 
-        _head = new Head();
-        _wand = new Wand();
+            for (int row = 0; row < 3; ++row)
+            {
+                newLoc[row] = calibration[12 + row] * 1000 / 3.2808399; // foot to mm conversion
+                for (int k = 0; k < 3; ++k)
+                    newLoc[row] += calibration[4 * k + row] * loc[k];
+
+                for (int column = 0; column < 3; ++column)
+                {
+                    newRot[3 * column + row] = 0.0;
+                    for (int k = 0; k < 3; ++k)
+                        newRot[3 * column + row] += calibration[4 * k + row] * rot[3 * column + k];
+                }
+            }
+
+            memcpy(loc, newLoc, sizeof(newLoc));
+            memcpy(rot, newRot, sizeof(newRot));
+        }
+
+        // Makes an SDK parse only what the tracker uses.  Hands, measurement tools and single
+        // markers are skipped; all standard bodies are kept, as users can follow any id.
+        void ParseOnlyUsedData(DTrackSDK &dt)
+        {
+            DTrack_Subscription_Type subscription;
+            subscription.types = DTRACK_DATA_BODY | DTRACK_DATA_FLYSTICK;
+            dt.setSubscription(subscription);
+        }
+
+        // Merges the table of one source into the merged table.  Of the sources that have a
+        // body, the one with the best quality wins, and of those the one received last.
+        template <class Data>
+        void MergeTable(std::vector<Data> &merged, std::vector<long long> &times, const std::vector<Data> &table, long long receiveTimeNs)
+        {
+            for (unsigned int i = 0; i < table.size(); ++i)
+            {
+                if (i >= merged.size())
+                {
+                    merged.push_back(table[i]);
+                    times.push_back(receiveTimeNs);
+                }
+                else if (table[i].quality > merged[i].quality ||
+                         (table[i].quality == merged[i].quality && receiveTimeNs > times[i]))
+                {
+                    merged[i] = table[i];
+                    times[i] = receiveTimeNs;
+                }
+            }
+        }
+
+        // Adds up the statistics the SDKs of all sources keep
+        DTrack_Statistics_Type SumStatistics(std::vector<DTrackSDK*> &sdks)
+        {
+            DTrack_Statistics_Type total;
+            memset(&total, 0, sizeof(total));
+
+            for (unsigned int i = 0; i < sdks.size(); ++i)
+            {
+                DTrack_Statistics_Type statistics = sdks[i]->getStatistics();
+                total.packets += statistics.packets;
+                total.frame_gaps += statistics.frame_gaps;
+                for (int line = 0; line < DTRACK_LINE_NUM; ++line)
+                    total.parse_errors[line] += statistics.parse_errors[line];
+                total.timeouts += statistics.timeouts;
+                total.net_errors += statistics.net_errors;
+            }
+            return total;
+        }
+    }
+
+    TrackerUpdate::TrackerUpdate(int port)
+    {
+        Initialize(std::vector<TrackingSource>(1, TrackingSource(port)), 0, PoseFilterChain(), PoseFilterChain(), "", false);
     }
 
 
     TrackerUpdate::TrackerUpdate(int port, int smoothing)
     {
-        _port = port;
-        _stopRequested = false;
+        Initialize(std::vector<TrackingSource>(1, TrackingSource(port)), smoothing, PoseFilterChain(), PoseFilterChain(), "", false);
+    }
+
 
-        _head = new Head();
-        _wand = new Wand(smoothing);
+    TrackerUpdate::TrackerUpdate(int port, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        Initialize(std::vector<TrackingSource>(1, TrackingSource(port)), smoothing, headFilter, wandFilter, "", false);
+    }
+
+
+    TrackerUpdate::TrackerUpdate(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        Initialize(sources, smoothing, headFilter, wandFilter, "", false);
+    }
+
+
+    TrackerUpdate::TrackerUpdate(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName)
+    {
+        Initialize(sources, smoothing, headFilter, wandFilter, sharedMemoryName, false);
+    }
+
+
+    TrackerUpdate::TrackerUpdate(std::string sharedMemoryName)
+    {
+        Initialize(std::vector<TrackingSource>(), 0, PoseFilterChain(), PoseFilterChain(), sharedMemoryName, true);
+    }
+
+
+    TrackerUpdate::TrackerUpdate(std::string captureFile, PacketReplay::TIMING timing, std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter)
+    {
+        _replay.reset(new PacketReplay(captureFile));
+        if (!_replay->IsValid())
+        {
+            fprintf(stderr, "\nUnable to replay \"%s\".  You may want to check if:\n\tThe file exists and can be read\n\tThe file was written by Monolith::StartCapture\n", captureFile.c_str());
+            exit(-1);
+        }
+        _replayTiming = timing;
+
+        // Sources that were not given replay without calibration
+        while (sources.size() < (unsigned int)_replay->GetNumSources())
+            sources.push_back(TrackingSource(0));
+
+        Initialize(sources, smoothing, headFilter, wandFilter, "", false);
     }
 
 
     TrackerUpdate::~TrackerUpdate(void)
     {
-        delete _head;
-        delete _wand;
+        StopTelemetryDump();
+
+        for (int i = 0; i < TrackingFrame::MAX_USERS; ++i)
+        {
+            delete _heads[i];
+            delete _wands[i];
+        }
+
+        for (int i = 0; i < TrackingFrame::MAX_BODIES; ++i)
+            delete _bodies[i];
+
+        for (int i = 0; i < TrackingFrame::MAX_FLYSTICKS; ++i)
+            delete _flySticks[i];
+    }
+
+
+    void TrackerUpdate::Initialize(std::vector<TrackingSource> sources, int smoothing, PoseFilterChain headFilter, PoseFilterChain wandFilter, std::string sharedMemoryName, bool reader)
+    {
+        assert(reader || !sources.empty());
+        _sources = sources;
+        _reader = reader;
+        _stopRequested = false;
+        _predictionMode = PosePredictor::CONSTANT_VELOCITY;
+        _appliedPredictionMode = PosePredictor::CONSTANT_VELOCITY;
+        _processAllFrames = false;
+        _appliedProcessAllFrames = false;
+        _coalescedFrames = 0;
+        _frameNumber = 0;
+        _waiters = 0;
+        _nextSubscriptionId = 1;
+        _droppedWandEvents = 0;
+        _receiveTimeNs = -1;
+        _telemetryDumpStopRequested = false;
+        _telemetryFile = NULL;
+        _telemetryIntervalMs = 0;
+
+        _headFilter = headFilter;
+        _wandFilter = wandFilter;
+
+        _sourceFrames.resize(_sources.size());
+        for (unsigned int i = 0; i < _sourceFrames.size(); ++i)
+            _sourceFrames[i].receiveTimeNs = -1;
+        _merged.receiveTimeNs = -1;
+
+        // One user, with the first body and FlyStick, until SetUser is called
+        _numUsers = 1;
+        _activeUsers = 1;
+
+        for (int i = 0; i < TrackingFrame::MAX_USERS; ++i)
+        {
+            _headBodyIds[i] = _boundHeadIds[i] = i == 0 ? 0 : -1;
+            _wandFlyStickIds[i] = _boundWandIds[i] = i == 0 ? 0 : -1;
+
+            _heads[i] = new Head();
+            _wands[i] = new Wand(smoothing);
+
+            _heads[i]->SetFilter(headFilter);
+            _wands[i]->SetFilter(wandFilter);
+
+            _wands[i]->GetState(_lastWands[i]);
+        }
+
+        // The tables are passed on as received, without filters or smoothing
+        _numBodies = 0;
+        for (int i = 0; i < TrackingFrame::MAX_BODIES; ++i)
+            _bodies[i] = new Head();
+
+        _numFlySticks = 0;
+        for (int i = 0; i < TrackingFrame::MAX_FLYSTICKS; ++i)
+            _flySticks[i] = new Wand();
+
+        if (sharedMemoryName.empty())
+        {
+            _localStore.reset(new FrameStore());
+            _store = _localStore.get();
+        }
+        else
+        {
+            _sharedStore.reset(new SharedFrameStore(sharedMemoryName, !reader));
+            if (!_sharedStore->IsValid())
+            {
+                if (reader)
+                    fprintf(stderr, "\nUnable to read tracking data shared as \"%s\".  You may want to check if:\n\tThe application receiving from the ART Tracker is running and sharing its data\n\tThe same name is used in both applications\n\tBoth applications use the same version of the framework\n", sharedMemoryName.c_str());
+                else
+                    fprintf(stderr, "\nUnable to share tracking data as \"%s\".  You may want to check if:\n\tThe name is valid for shared memory on this system\n\tYou have permission to create shared memory\n", sharedMemoryName.c_str());
+                exit(-1);
+            }
+            _store = _sharedStore->GetStore();
+        }
+
+        if (reader)
+        {
+            // Carry on from the frame the publisher is at
+            TrackingFrame frame;
+            _store->frame.Read(frame);
+            _frameNumber = _store->history.GetCount();
+            for (int i = 0; i < TrackingFrame::MAX_USERS; ++i)
+                _lastWands[i] = frame.wands[i];
+        }
+        else
+        {
+            Publish(0);
+        }
     }
 
 
     void TrackerUpdate::Run() 
     {
         assert(!_thread);
-        _thread = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&TrackerUpdate::Update, this)));
+        void (TrackerUpdate::*run)() = &TrackerUpdate::Update;
+        if (_reader)
+            run = &TrackerUpdate::Follow;
+        else if (_replay)
+            run = &TrackerUpdate::Replay;
+
+        _thread = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(run, this)));
     }
 
 
@@ -42,46 +319,874 @@ namespace MTF
         assert(_thread);
         _stopRequested = true;
         _thread->join();
+
+        // Nothing more will be received, so don't keep anyone waiting
+        {
+            boost::mutex::scoped_lock lock(_waitMutex);
+            _waitCondition.notify_all();
+        }
+
+        if (_dispatcher)
+            _dispatcher->join();
+
+        StopTelemetryDump();
     }
 
 
     void TrackerUpdate::Update()
     {
-        DTrackSDK dt("", 0, _port, DTrackSDK::SYS_DTRACK_UNKNOWN);
-        if (!dt.isUDPValid())
+        // All sources are received on this one thread, waiting on all their sockets at once
+        std::vector<DTrackSDK*> sdks;
+        for (unsigned int i = 0; i < _sources.size(); ++i)
         {
-            perror("\nUnable to recieve data from the ART Tracker.  You may want to check if:\n\tART Tracker is turned on and is tracking (2 red LEDs per camera)\n\tThe correct port number has been specified\n\tWindows Firewall is not blocking the traffic\n\tART Tracker is configured to send tracking updates to your IP address\n\tYou do not currently have another application running on this computer using the tracker\n");
-            exit(-1);
+            sdks.push_back(new DTrackSDK(_sources[i].GetMulticastGroup(), 0, _sources[i].GetPort(), DTrackSDK::SYS_DTRACK_UNKNOWN));
+            if (!sdks[i]->isUDPValid())
+            {
+                perror("\nUnable to recieve data from the ART Tracker.  You may want to check if:\n\tART Tracker is turned on and is tracking (2 red LEDs per camera)\n\tThe correct port number has been specified\n\tWindows Firewall is not blocking the traffic\n\tART Tracker is configured to send tracking updates to your IP address\n\tYou do not currently have another application running on this computer using the tracker\n");
+                exit(-1);
+            }
+            ParseOnlyUsedData(*sdks[i]);
         }
 
+        // Every packet goes past CapturePacket, which records it while a capture is running
+        _captureContexts.resize(sdks.size());
+        for (unsigned int i = 0; i < sdks.size(); ++i)
+        {
+            _captureContexts[i].tracker = this;
+            _captureContexts[i].source = i;
+            sdks[i]->setPacketHandler(&TrackerUpdate::CapturePacket, &_captureContexts[i]);
+        }
+
+        std::vector<bool> ready;
+
         while (!_stopRequested)
         {
-            bool ok = dt.receive();
+            ApplyPredictionMode();
+            ApplyReceiveMode(sdks);
 
-            if (ok) 
+            bool ok = false;
+
+            // With all frames processed, packets that queued up come back as ready right away,
+            // so each turn of the loop takes the oldest packet of every source
+            int numReady = DTrackSDK::waitForData(sdks, ready, 1000000);
+            if (numReady > 0)
             {
-                boost::mutex::scoped_lock l(_mutex);
-                _head->Update(*dt.getBody(0));
-                _wand->Update(*dt.getFlyStick(0));
+                long long parseStartNs = udp_get_time_ns();
+                unsigned long coalesced = 0;
+                for (unsigned int i = 0; i < sdks.size(); ++i)
+                {
+                    if (ready[i] && sdks[i]->receive())
+                    {
+                        StoreSourceFrame(i, *sdks[i]);
+                        ok = true;
+                    }
+                    coalesced += sdks[i]->getNumCoalescedPackets();
+                }
+                _coalescedFrames = coalesced;
+
+                _telemetry.RecordParse(udp_get_time_ns() - parseStartNs);
+                _telemetry.SetSourceStatistics(SumStatistics(sdks));
+            }
+            else if (numReady == 0)
+            {
+                _telemetry.RecordTimeout();
             }
             else
             {
+                _telemetry.RecordNetworkError();
+            }
+
+            if (ok) 
+            {
+                long long publishStartNs = udp_get_time_ns();
+
+                MergeSources();
+                UpdateBodies();
+
+                Publish(_frameNumber + 1);
+                NotifyWaiters();
+
+                _telemetry.RecordFrame(_receiveTimeNs, udp_get_time_ns() - publishStartNs);
+            }
+        }
+
+        for (unsigned int i = 0; i < sdks.size(); ++i)
+            delete sdks[i];
+    }
+
+
+    // Runs instead of Update when replaying a capture.  The packets go through the same
+    // steps as received ones, so a replay shows how long those steps take.
+    void TrackerUpdate::Replay()
+    {
+        // The SDKs only parse here, so they open no sockets
+        std::vector<DTrackSDK*> sdks;
+        for (unsigned int i = 0; i < _sources.size(); ++i)
+        {
+            sdks.push_back(new DTrackSDK());
+            ParseOnlyUsedData(*sdks[i]);
+        }
+
+        // The capture is moved to the time of the replay, keeping the time between packets
+        int source, length;
+        const char *data;
+        long long receiveTimeNs;
+        long long offsetNs = 0;
+        if (_replay->GetPacket(0, source, data, length, receiveTimeNs))
+            offsetNs = udp_get_time_ns() - receiveTimeNs;
+
+        for (int packet = 0; packet < _replay->GetNumPackets() && !_stopRequested; ++packet)
+        {
+            ApplyPredictionMode();
+
+            if (!_replay->GetPacket(packet, source, data, length, receiveTimeNs) || source >= (int)sdks.size())
+                continue;
+            receiveTimeNs += offsetNs;
+
+            if (_replayTiming == PacketReplay::ORIGINAL_TIMING)
+            {
+                // Sleep in short steps, so Stop does not wait for a long gap in the capture
+                long long waitNs;
+                while ((waitNs = receiveTimeNs - udp_get_time_ns()) > 0 && !_stopRequested)
+                    boost::this_thread::sleep(boost::posix_time::microseconds(std::min(waitNs / 1000, 100000LL)));
+            }
+
+            long long parseStartNs = udp_get_time_ns();
+            bool ok = sdks[source]->receivePacket(data, length, receiveTimeNs);
+            _telemetry.RecordParse(udp_get_time_ns() - parseStartNs);
+            _telemetry.SetSourceStatistics(SumStatistics(sdks));
+            if (!ok)
+                continue;
+
+            long long publishStartNs = udp_get_time_ns();
+
+            StoreSourceFrame(source, *sdks[source]);
+            MergeSources();
+            UpdateBodies();
+
+            Publish(_frameNumber + 1);
+            NotifyWaiters();
+
+            _telemetry.RecordFrame(_receiveTimeNs, udp_get_time_ns() - publishStartNs);
+        }
+
+        for (unsigned int i = 0; i < sdks.size(); ++i)
+            delete sdks[i];
+    }
+
+
+    // Called by the SDKs with every packet they receive, on the tracking thread
+    void TrackerUpdate::CapturePacket(void *context, const char *data, int length, long long receiveTimeNs)
+    {
+        CaptureContext *capture = static_cast<CaptureContext*>(context);
+
+        boost::shared_ptr<PacketCapture> file = boost::atomic_load(&capture->tracker->_capture);
+        if (file)
+            file->Write(capture->source, data, length, receiveTimeNs);
+    }
+
+
+    // Applies a prediction mode set by another thread
+    void TrackerUpdate::ApplyPredictionMode()
+    {
+        if (_predictionMode == _appliedPredictionMode)
+            return;
+
+        _appliedPredictionMode = _predictionMode;
+        PosePredictor::MODE mode = (PosePredictor::MODE)_appliedPredictionMode;
+
+        for (int i = 0; i < TrackingFrame::MAX_USERS; ++i)
+        {
+            _heads[i]->SetPredictionMode(mode);
+            _wands[i]->SetPredictionMode(mode);
+        }
+        for (int i = 0; i < TrackingFrame::MAX_BODIES; ++i)
+            _bodies[i]->SetPredictionMode(mode);
+        for (int i = 0; i < TrackingFrame::MAX_FLYSTICKS; ++i)
+            _flySticks[i]->SetPredictionMode(mode);
+    }
+
+
+    // Runs instead of Update when reading the frames another process publishes.  GetHead and
+    // the other getters read the shared frames directly; this thread only looks out for new
+    // frames, to wake up waiting threads, queue wand events and call subscribers.
+    void TrackerUpdate::Follow()
+    {
+        unsigned long followed = _frameNumber;
+
+        while (!_stopRequested)
+        {
+            unsigned long newest = _store->history.GetCount();
+            if (newest == followed)
+            {
+                // There is no way to be signalled by another process without locking, so poll
+                boost::this_thread::sleep(boost::posix_time::microseconds(FOLLOW_INTERVAL_US));
+                continue;
+            }
+
+            if (newest - followed > FrameStore::HISTORY_SIZE)
+                followed = newest - FrameStore::HISTORY_SIZE;
+
+            // Every frame is looked at, so no button change is missed
+            for (; followed < newest; ++followed)
+            {
+                TrackingFrame frame;
+                if (!_store->history.Read(followed, frame))
+                    continue;
+
+                for (int i = 0; i < frame.numUsers; ++i)
+                {
+                    QueueWandEvents(_lastWands[i], frame.wands[i], i);
+                    _lastWands[i] = frame.wands[i];
+                }
+
+                _frameNumber = frame.frameNumber;
+                Deliver(frame, Subscription::TRACKING_THREAD);
+            }
+
+            _frameNumber = newest;
+            NotifyWaiters();
+        }
+    }
+
+
+    // Switches the sources between processing only the newest packet and every packet
+    void TrackerUpdate::ApplyReceiveMode(std::vector<DTrackSDK*> &sdks)
+    {
+        if (_processAllFrames == _appliedProcessAllFrames)
+            return;
+
+        _appliedProcessAllFrames = _processAllFrames;
+        for (unsigned int i = 0; i < sdks.size(); ++i)
+            sdks[i]->setReceiveMode(_appliedProcessAllFrames ? DTrackSDK::RECEIVE_ALL : DTrackSDK::RECEIVE_NEWEST);
+    }
+
+
+    // Wakes up threads waiting for a new frame.  Taking the mutex makes sure a waiter
+    // is either still before its check of the frame number or already asleep.
+    void TrackerUpdate::NotifyWaiters()
+    {
+        if (_waiters > 0)
+        {
+            boost::mutex::scoped_lock lock(_waitMutex);
+            _waitCondition.notify_all();
+        }
+    }
+
+
+    // Keeps the frame a source received last, in the shared coordinates
+    void TrackerUpdate::StoreSourceFrame(int source, DTrackSDK &dt)
+    {
+        SourceFrame &frame = _sourceFrames[source];
+        frame.receiveTimeNs = dt.getReceiveTimeNs();
+
+        double calibration[16];
+        _sources[source].GetCalibration().GetMatrixArray(calibration);
+
+        frame.bodies.resize(dt.getNumBody());
+        for (unsigned int i = 0; i < frame.bodies.size(); ++i)
+        {
+            frame.bodies[i] = *dt.getBody(i);
+            Calibrate(calibration, frame.bodies[i].loc, frame.bodies[i].rot);
+        }
+
+        frame.flySticks.resize(dt.getNumFlyStick());
+        for (unsigned int i = 0; i < frame.flySticks.size(); ++i)
+        {
+            frame.flySticks[i] = *dt.getFlyStick(i);
+            Calibrate(calibration, frame.flySticks[i].loc, frame.flySticks[i].rot);
+        }
+    }
+
+
+    // Merges the last frames of all sources into one.  The sources are taken to share their
+    // body and FlyStick ids, as trackers covering parts of one floor do.  Frames that are
+    // too old compared to the newest one are left out, so a tracker that stopped sending or
+    // lost the body does not hold on to it.
+    void TrackerUpdate::MergeSources()
+    {
+        _merged.receiveTimeNs = -1;
+        for (unsigned int i = 0; i < _sourceFrames.size(); ++i)
+        {
+            if (_sourceFrames[i].receiveTimeNs > _merged.receiveTimeNs)
+                _merged.receiveTimeNs = _sourceFrames[i].receiveTimeNs;
+        }
+
+        _merged.bodies.clear();
+        _merged.flySticks.clear();
+        _mergedBodyTimes.clear();
+        _mergedFlyStickTimes.clear();
+
+        for (unsigned int i = 0; i < _sourceFrames.size(); ++i)
+        {
+            const SourceFrame &frame = _sourceFrames[i];
+            if (frame.receiveTimeNs < 0 || _merged.receiveTimeNs - frame.receiveTimeNs > MAX_SOURCE_AGE_NS)
+                continue;
+
+            MergeTable(_merged.bodies, _mergedBodyTimes, frame.bodies, frame.receiveTimeNs);
+            MergeTable(_merged.flySticks, _mergedFlyStickTimes, frame.flySticks, frame.receiveTimeNs);
+        }
+    }
+
+
+    // Updates the users and the body tables from the merged frame
+    void TrackerUpdate::UpdateBodies()
+    {
+        _receiveTimeNs = _merged.receiveTimeNs;
+
+        // Bodies and FlySticks the tracker did not send count as not tracked
+        DTrack_Body_Type_d missingBody;
+        memset(&missingBody, 0, sizeof(missingBody));
+        missingBody.quality = -1;
+
+        DTrack_FlyStick_Type_d missingFlyStick;
+        memset(&missingFlyStick, 0, sizeof(missingFlyStick));
+        missingFlyStick.quality = -1;
+
+        _activeUsers = _numUsers;
+        for (int user = 0; user < _activeUsers; ++user)
+        {
+            int headId = _headBodyIds[user];
+            int wandId = _wandFlyStickIds[user];
+
+            // A user bound to another body starts over, instead of being filtered towards the old one
+            if (headId != _boundHeadIds[user])
+            {
+                _boundHeadIds[user] = headId;
+                _heads[user]->SetFilter(_headFilter);
+                _heads[user]->SetPredictionMode((PosePredictor::MODE)_appliedPredictionMode);
+            }
+            if (wandId != _boundWandIds[user])
+            {
+                _boundWandIds[user] = wandId;
+                _wands[user]->SetFilter(_wandFilter);
+                _wands[user]->SetPredictionMode((PosePredictor::MODE)_appliedPredictionMode);
+            }
+
+            bool hasBody = headId >= 0 && headId < (int)_merged.bodies.size();
+            _heads[user]->Update(hasBody ? _merged.bodies[headId] : missingBody, _receiveTimeNs);
+
+            bool hasFlyStick = wandId >= 0 && wandId < (int)_merged.flySticks.size();
+            _wands[user]->Update(hasFlyStick ? _merged.flySticks[wandId] : missingFlyStick, _receiveTimeNs);
+        }
+
+        _numBodies = _merged.bodies.size();
+        if (_numBodies > TrackingFrame::MAX_BODIES)
+            _numBodies = TrackingFrame::MAX_BODIES;
+
+        for (int i = 0; i < _numBodies; ++i)
+            _bodies[i]->Update(_merged.bodies[i], _receiveTimeNs);
+
+        _numFlySticks = _merged.flySticks.size();
+        if (_numFlySticks > TrackingFrame::MAX_FLYSTICKS)
+            _numFlySticks = TrackingFrame::MAX_FLYSTICKS;
+
+        for (int i = 0; i < _numFlySticks; ++i)
+            _flySticks[i]->Update(_merged.flySticks[i], _receiveTimeNs);
+    }
+
+
+    // Copies the tracking thread's Heads and Wands into the shared frame.  The frame number
+    // is only raised once the frame and the history hold the frame, so a thread that sees
+    // the new number always finds the frame.
+    void TrackerUpdate::Publish(unsigned long frameNumber)
+    {
+        TrackingFrame frame;
+        frame.frameNumber = frameNumber;
+        frame.receiveTimeNs = _receiveTimeNs;
+
+        frame.numUsers = _activeUsers;
+        for (int i = 0; i < frame.numUsers; ++i)
+        {
+            _heads[i]->GetState(frame.heads[i]);
+            _wands[i]->GetState(frame.wands[i]);
+            frame.heads[i].frameNumber = frame.frameNumber;
+            frame.wands[i].pose.frameNumber = frame.frameNumber;
+        }
+
+        frame.numBodies = _numBodies;
+        for (int i = 0; i < frame.numBodies; ++i)
+        {
+            _bodies[i]->GetState(frame.bodies[i]);
+            frame.bodies[i].frameNumber = frame.frameNumber;
+        }
+
+        frame.numFlySticks = _numFlySticks;
+        for (int i = 0; i < frame.numFlySticks; ++i)
+        {
+            _flySticks[i]->GetState(frame.flySticks[i]);
+            frame.flySticks[i].pose.frameNumber = frame.frameNumber;
+        }
+
+        _store->frame.Write(frame);
+
+        // Only frames that came from the tracker go into the history and to subscribers
+        if (frame.frameNumber > 0)
+        {
+            _store->history.Write(frame);
+            _frameNumber = frame.frameNumber;
+
+            for (int i = 0; i < frame.numUsers; ++i)
+                QueueWandEvents(_lastWands[i], frame.wands[i], i);
+
+            Deliver(frame, Subscription::TRACKING_THREAD);
+        }
+
+        for (int i = 0; i < frame.numUsers; ++i)
+            _lastWands[i] = frame.wands[i];
+    }
+
+
+    // Queues an event for every button and joystick change between two frames
+    void TrackerUpdate::QueueWandEvents(const FlyStickState &previous, const FlyStickState &current, int user)
+    {
+        WandEvent event;
+        event.user = user;
+        event.joystickHorizontal = current.joystickHorizontal;
+        event.joystickVertical = current.joystickVertical;
+        event.frameNumber = current.pose.frameNumber;
+        event.receiveTimeNs = current.pose.receiveTimeNs;
+
+        for (int i = 0; i < current.numButtons && i < 16; ++i)
+        {
+            if (current.buttons[i] != previous.buttons[i])
+            {
+                event.type = current.buttons[i] ? WandEvent::BUTTON_PRESSED : WandEvent::BUTTON_RELEASED;
+                event.button = i;
+                QueueWandEvent(event);
             }
         }
+
+        if (current.joystickHorizontal != previous.joystickHorizontal || current.joystickVertical != previous.joystickVertical)
+        {
+            event.type = WandEvent::JOYSTICK_MOVED;
+            event.button = -1;
+            QueueWandEvent(event);
+        }
+    }
+
+
+    void TrackerUpdate::QueueWandEvent(WandEvent &event)
+    {
+        // The tracking thread never waits for the reader.  If the reader has not emptied
+        // the queue for a long time the event is dropped and counted instead.
+        if (!_wandEvents.push(event))
+            ++_droppedWandEvents;
+    }
+
+
+    // Calls the subscribers that run on the given thread
+    void TrackerUpdate::Deliver(const TrackingFrame &frame, Subscription::THREAD thread)
+    {
+        if (!boost::atomic_load(&_subscriptions))
+            return;
+
+        // Load the list again under the lock, so that once Unsubscribe has taken and released
+        // the lock, no delivery can still be using a list from before the Unsubscribe
+        boost::mutex::scoped_lock lock(thread == Subscription::TRACKING_THREAD ? _deliverMutex : _dispatchMutex);
+
+        boost::shared_ptr<const SubscriptionList> subscriptions = boost::atomic_load(&_subscriptions);
+        if (!subscriptions)
+            return;
+
+        for (unsigned int i = 0; i < subscriptions->size(); ++i)
+        {
+            if ((*subscriptions)[i].thread == thread)
+                (*subscriptions)[i].callback(frame);
+        }
+    }
+
+
+    // Runs on the dispatcher thread.  Frames are read back from the history, so the
+    // tracking thread does no extra work for these subscribers.
+    void TrackerUpdate::Dispatch(unsigned long delivered)
+    {
+        while (!_stopRequested)
+        {
+            if (!WaitForFrame(delivered, 100))
+                continue;
+
+            // Only go as far as the history has been written, so no frame is skipped
+            // before it is there.  A subscriber that is too slow misses the frames that
+            // have left the history.
+            unsigned long newest = _store->history.GetCount();
+            if (newest - delivered > FrameStore::HISTORY_SIZE)
+                delivered = newest - FrameStore::HISTORY_SIZE;
+
+            // Frame number n is stored at index n - 1 of the history.  Reading fails only
+            // for a frame that was replaced while it was copied, which is gone for good.
+            for (; delivered < newest; ++delivered)
+            {
+                TrackingFrame frame;
+                if (_store->history.Read(delivered, frame))
+                    Deliver(frame, Subscription::DISPATCHER_THREAD);
+            }
+        }
+    }
+
+
+    // Finds the history indices of the frames received just before and just after the given
+    // time.  Returns false if the time is past the newest frame, or no frame has been received.
+    // Only the arrival times are copied while searching.
+    bool TrackerUpdate::FindFrames(long long timeNs, unsigned long &before, unsigned long &after)
+    {
+        TimeReader reader;
+        unsigned long count = _store->history.GetCount();
+        if (count == 0 || !_store->history.ReadWith(count - 1, reader) || timeNs >= reader.receiveTimeNs)
+            return false;
+
+        // Render times are usually close to the newest frame, so search from the newest back
+        after = count - 1;
+        for (unsigned long index = count - 1; index > 0; --index)
+        {
+            if (!_store->history.ReadWith(index - 1, reader))
+                break;
+
+            if (reader.receiveTimeNs <= timeNs)
+            {
+                before = index - 1;
+                return true;
+            }
+
+            after = index - 1;
+        }
+
+        // Older than every frame kept, use the oldest one
+        before = after;
+        return true;
+    }
+
+
+    // Copies what the readers need out of the frames found by FindFrames.  A frame that was
+    // replaced after it was found is too old by now, so the search starts over.
+    template <class Reader>
+    bool TrackerUpdate::ReadFramesAt(long long timeNs, Reader &before, Reader &after)
+    {
+        unsigned long beforeIndex, afterIndex;
+        do
+        {
+            if (!FindFrames(timeNs, beforeIndex, afterIndex))
+                return false;
+        } while (!_store->history.ReadWith(afterIndex, after) || !_store->history.ReadWith(beforeIndex, before));
+
+        return true;
     }
 
 
     Head TrackerUpdate::GetHead()
     {
-        boost::mutex::scoped_lock l(_mutex);
-        return _head->GetCopy();
+        return GetUserHead(0);
     }
 
 
     Wand TrackerUpdate::GetWand()
     {
-        boost::mutex::scoped_lock l(_mutex);
-        return _wand->GetCopy();
+        return GetUserWand(0);
+    }
+
+
+    Head TrackerUpdate::GetUserHead(int user)
+    {
+        EntryReader<BodyState, TrackingFrame::MAX_USERS> reader(&TrackingFrame::heads, &TrackingFrame::numUsers, user);
+        _store->frame.ReadWith(reader);
+        return reader.found ? Head(reader.state) : Head();
+    }
+
+
+    Wand TrackerUpdate::GetUserWand(int user)
+    {
+        EntryReader<FlyStickState, TrackingFrame::MAX_USERS> reader(&TrackingFrame::wands, &TrackingFrame::numUsers, user);
+        _store->frame.ReadWith(reader);
+        return reader.found ? Wand(reader.state) : Wand();
+    }
+
+
+    void TrackerUpdate::SetUser(int user, int headBodyId, int wandFlyStickId)
+    {
+        if (user < 0 || user >= TrackingFrame::MAX_USERS)
+            return;
+
+        _headBodyIds[user] = headBodyId;
+        _wandFlyStickIds[user] = wandFlyStickId;
+
+        if (user >= _numUsers)
+            _numUsers = user + 1;
+    }
+
+
+    int TrackerUpdate::GetNumUsers()
+    {
+        // The users are bound in the process that shares the frames
+        if (_reader)
+        {
+            CountReader reader(&TrackingFrame::numUsers);
+            _store->frame.ReadWith(reader);
+            return reader.count;
+        }
+
+        return _numUsers;
+    }
+
+
+    Head TrackerUpdate::GetBody(int id)
+    {
+        EntryReader<BodyState, TrackingFrame::MAX_BODIES> reader(&TrackingFrame::bodies, &TrackingFrame::numBodies, id);
+        _store->frame.ReadWith(reader);
+        return reader.found ? Head(reader.state) : Head();
+    }
+
+
+    Wand TrackerUpdate::GetFlyStick(int id)
+    {
+        EntryReader<FlyStickState, TrackingFrame::MAX_FLYSTICKS> reader(&TrackingFrame::flySticks, &TrackingFrame::numFlySticks, id);
+        _store->frame.ReadWith(reader);
+        return reader.found ? Wand(reader.state) : Wand();
+    }
+
+
+    int TrackerUpdate::GetNumBodies()
+    {
+        CountReader reader(&TrackingFrame::numBodies);
+        _store->frame.ReadWith(reader);
+        return reader.count;
+    }
+
+
+    int TrackerUpdate::GetNumFlySticks()
+    {
+        CountReader reader(&TrackingFrame::numFlySticks);
+        _store->frame.ReadWith(reader);
+        return reader.count;
+    }
+
+
+    void TrackerUpdate::GetFrame(TrackingFrame &frame)
+    {
+        _store->frame.Read(frame);
+    }
+
+
+    Head TrackerUpdate::GetHeadAt(long long timeNs)
+    {
+        EntryReader<BodyState, TrackingFrame::MAX_USERS> before(&TrackingFrame::heads, &TrackingFrame::numUsers, 0);
+        EntryReader<BodyState, TrackingFrame::MAX_USERS> after(&TrackingFrame::heads, &TrackingFrame::numUsers, 0);
+        if (!ReadFramesAt(timeNs, before, after))
+            return GetHead().Predict(timeNs);
+
+        return Head::Interpolate(before.found ? Head(before.state) : Head(),
+                                 after.found ? Head(after.state) : Head(), timeNs);
+    }
+
+
+    Wand TrackerUpdate::GetWandAt(long long timeNs)
+    {
+        EntryReader<FlyStickState, TrackingFrame::MAX_USERS> before(&TrackingFrame::wands, &TrackingFrame::numUsers, 0);
+        EntryReader<FlyStickState, TrackingFrame::MAX_USERS> after(&TrackingFrame::wands, &TrackingFrame::numUsers, 0);
+        if (!ReadFramesAt(timeNs, before, after))
+            return GetWand().Predict(timeNs);
+
+        return Wand::Interpolate(before.found ? Wand(before.state) : Wand(),
+                                 after.found ? Wand(after.state) : Wand(), timeNs);
+    }
+
+
+    void TrackerUpdate::SetPredictionMode(PosePredictor::MODE mode)
+    {
+        _predictionMode = mode;
+    }
+
+
+    void TrackerUpdate::SetProcessAllFrames(bool all)
+    {
+        _processAllFrames = all;
+    }
+
+
+    unsigned long TrackerUpdate::GetCoalescedFrameCount()
+    {
+        return _coalescedFrames;
+    }
+
+
+    unsigned long TrackerUpdate::GetFrameNumber()
+    {
+        return _frameNumber;
+    }
+
+
+    bool TrackerUpdate::WaitForFrame(unsigned long lastFrameNumber, int timeoutMs)
+    {
+        boost::system_time timeout = boost::get_system_time() + boost::posix_time::milliseconds(timeoutMs);
+
+        ++_waiters;
+        {
+            boost::mutex::scoped_lock lock(_waitMutex);
+            while (_frameNumber <= lastFrameNumber && !_stopRequested)
+            {
+                if (!_waitCondition.timed_wait(lock, timeout))
+                    break;
+            }
+        }
+        --_waiters;
+
+        return _frameNumber > lastFrameNumber;
+    }
+
+
+    int TrackerUpdate::Subscribe(FrameCallback callback, Subscription::THREAD thread)
+    {
+        boost::mutex::scoped_lock lock(_subscribeMutex);
+
+        SubscriptionEntry entry;
+        entry.id = _nextSubscriptionId++;
+        entry.callback = callback;
+        entry.thread = thread;
+
+        boost::shared_ptr<SubscriptionList> subscriptions(new SubscriptionList());
+        if (_subscriptions)
+            *subscriptions = *_subscriptions;
+        subscriptions->push_back(entry);
+
+        boost::shared_ptr<const SubscriptionList> shared = subscriptions;
+        boost::atomic_store(&_subscriptions, shared);
+
+        // Start from the current frame, rather than whatever the frame is once the thread runs
+        if (thread == Subscription::DISPATCHER_THREAD && !_dispatcher)
+            _dispatcher = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&TrackerUpdate::Dispatch, this, _frameNumber.load())));
+
+        return entry.id;
+    }
+
+
+    void TrackerUpdate::Unsubscribe(int id)
+    {
+        {
+            boost::mutex::scoped_lock lock(_subscribeMutex);
+            if (!_subscriptions)
+                return;
+
+            boost::shared_ptr<SubscriptionList> subscriptions(new SubscriptionList());
+            for (unsigned int i = 0; i < _subscriptions->size(); ++i)
+            {
+                if ((*_subscriptions)[i].id != id)
+                    subscriptions->push_back((*_subscriptions)[i]);
+            }
+
+            boost::shared_ptr<const SubscriptionList> shared;
+            if (!subscriptions->empty())
+                shared = subscriptions;
+            boost::atomic_store(&_subscriptions, shared);
+        }
+
+        // A frame being delivered may still be using the old list.  Wait for it to finish,
+        // unless this is called by a subscriber, on the thread doing the delivering.
+        boost::thread::id self = boost::this_thread::get_id();
+        if (!_thread || _thread->get_id() != self)
+        {
+            boost::mutex::scoped_lock lock(_deliverMutex);
+        }
+        if (!_dispatcher || _dispatcher->get_id() != self)
+        {
+            boost::mutex::scoped_lock lock(_dispatchMutex);
+        }
+    }
+
+
+    bool TrackerUpdate::PollWandEvent(WandEvent &event)
+    {
+        return _wandEvents.pop(event);
+    }
+
+
+    unsigned long TrackerUpdate::GetDroppedWandEventCount()
+    {
+        return _droppedWandEvents;
+    }
+
+
+    bool TrackerUpdate::StartCapture(std::string filename)
+    {
+        boost::shared_ptr<PacketCapture> capture(new PacketCapture(filename));
+        if (!capture->IsValid())
+            return false;
+
+        boost::atomic_store(&_capture, capture);
+        return true;
+    }
+
+
+    void TrackerUpdate::StopCapture()
+    {
+        // The tracking thread may still be writing a packet; the file is closed after it
+        boost::atomic_store(&_capture, boost::shared_ptr<PacketCapture>());
+    }
+
+
+    void TrackerUpdate::GetTelemetry(Telemetry &telemetry)
+    {
+        telemetry.timeNs = udp_get_time_ns();
+        _telemetry.GetSnapshot(telemetry);
+        telemetry.framesPublished = _frameNumber;
+        telemetry.coalescedFrames = _coalescedFrames;
+        telemetry.droppedWandEvents = _droppedWandEvents;
+    }
+
+
+    bool TrackerUpdate::StartTelemetryDump(std::string filename, int intervalMs)
+    {
+        StopTelemetryDump();
+
+        boost::mutex::scoped_lock lock(_telemetryDumpMutex);
+
+        _telemetryFile = fopen(filename.c_str(), "w");
+        if (_telemetryFile == NULL)
+            return false;
+
+        _telemetryIntervalMs = std::max(intervalMs, 1);
+        _telemetryDumpStopRequested = false;
+        _telemetryDumper = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&TrackerUpdate::DumpTelemetry, this)));
+        return true;
+    }
+
+
+    void TrackerUpdate::StopTelemetryDump()
+    {
+        boost::mutex::scoped_lock lock(_telemetryDumpMutex);
+        if (!_telemetryDumper)
+            return;
+
+        _telemetryDumpStopRequested = true;
+        _telemetryDumper->join();
+        _telemetryDumper.reset();
+
+        fclose(_telemetryFile);
+        _telemetryFile = NULL;
+    }
+
+
+    // Runs on its own thread while a telemetry dump is running.  Writes one line of JSON every
+    // interval, and a last one when stopped, so the file always ends with the final counts.
+    void TrackerUpdate::DumpTelemetry()
+    {
+        long long nextNs = udp_get_time_ns() + _telemetryIntervalMs * 1000000LL;
+
+        for (;;)
+        {
+            // Sleep in short steps, so StopTelemetryDump does not wait for a long interval
+            long long waitNs;
+            while ((waitNs = nextNs - udp_get_time_ns()) > 0 && !_telemetryDumpStopRequested)
+                boost::this_thread::sleep(boost::posix_time::microseconds(std::min(waitNs / 1000, 100000LL)));
+            // Skip the intervals missed while the computer was busy, rather than catching up
+            nextNs = std::max(nextNs, udp_get_time_ns()) + _telemetryIntervalMs * 1000000LL;
+
+            Telemetry telemetry;
+            GetTelemetry(telemetry);
+            fprintf(_telemetryFile, "%s\n", telemetry.ToJson().c_str());
+            fflush(_telemetryFile);
+
+            if (_telemetryDumpStopRequested)
+                break;
+        }
     }
 
 
@@ -89,4 +1194,11 @@ namespace MTF
     {
         return !_stopRequested;
     }
+
+
+    // About three frames at 60 Hz, so a source that is only a little behind still counts
+    const long long TrackerUpdate::MAX_SOURCE_AGE_NS = 50000000;
+
+    // A fifth of a millisecond, quick enough for any frame rate without using up a core
+    const int TrackerUpdate::FOLLOW_INTERVAL_US = 200;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "TrackingSource.h"
+
+namespace MTF
+{
+
+    TrackingSource::TrackingSource(int port)
+    {
+        _port = port;
+    }
+
+
+    TrackingSource::TrackingSource(int port, Matrix4 calibration)
+    {
+        _port = port;
+        _calibration = calibration;
+    }
+
+
+    TrackingSource::TrackingSource(std::string multicastGroup, int port, Matrix4 calibration)
+    {
+        _port = port;
+        _multicastGroup = multicastGroup;
+        _calibration = calibration;
+    }
+
+
+    TrackingSource::~TrackingSource()
+    {
+    }
+
+
+    int TrackingSource::GetPort()
+    {
+        return _port;
+    }
+
+
+    std::string TrackingSource::GetMulticastGroup()
+    {
+        return _multicastGroup;
+    }
+
+
+    Matrix4 TrackingSource::GetCalibration()
+    {
+        return _calibration;
+    }
+
+}
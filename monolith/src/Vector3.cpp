@@ -9,7 +9,7 @@ namespace MTF
     }
 
 
-    Vector3::Vector3(double x, double y, double z)
+    Vector3::Vector3(Real x, Real y, Real z)
     {
 	    _x = x;
 	    _y = y;
@@ -23,6 +23,13 @@ namespace MTF
         _z = xyz[2];
     }
 
+    Vector3::Vector3(float xyz[])
+    {
+        _x = xyz[0];
+        _y = xyz[1];
+        _z = xyz[2];
+    }
+
 
     Vector3::~Vector3(void)
     {
@@ -40,8 +47,8 @@ namespace MTF
     }
 
 
-    // + Overload: handles "Vector3 + double"
-    Vector3 Vector3::operator+ (double param)
+    // + Overload: handles "Vector3 + Real"
+    Vector3 Vector3::operator+ (Real param)
     {
 	    Vector3 temp;// = new Vector3();
 	    temp._x = _x + param;
@@ -62,8 +69,8 @@ namespace MTF
     }
 
 
-    // - Overload: handles "Vector3 - double"
-    Vector3 Vector3::operator- (double param)
+    // - Overload: handles "Vector3 - Real"
+    Vector3 Vector3::operator- (Real param)
     {
 	    Vector3 temp;// = new Vector3();
 	    temp._x = _x - param;
@@ -84,8 +91,8 @@ namespace MTF
     }
 
 
-    // * Overload: handles "Vector3 * double"
-    Vector3 Vector3::operator * (double param)
+    // * Overload: handles "Vector3 * Real"
+    Vector3 Vector3::operator * (Real param)
     {
 	    Vector3 temp;// = new Vector3();
 	    temp._x = _x * param;
@@ -95,8 +102,8 @@ namespace MTF
     }
 
 
-    // / Overload: handles "Vector3 / double"
-    Vector3 Vector3::operator / (double param)
+    // / Overload: handles "Vector3 / Real"
+    Vector3 Vector3::operator / (Real param)
     {
 	    Vector3 temp;// = new Vector3();
 	    temp._x = _x / param;
@@ -115,8 +122,8 @@ namespace MTF
     }
 
 
-    // += Overload: handles "Vector3 += double"
-    Vector3& Vector3::operator += (const double param)
+    // += Overload: handles "Vector3 += Real"
+    Vector3& Vector3::operator += (const Real param)
     {
 	    _x += param;
 	    _y += param;
@@ -135,8 +142,8 @@ namespace MTF
     }
 
 
-    // -= Overload: handles "Vector3 -= double"
-    Vector3& Vector3::operator -= (const double param)
+    // -= Overload: handles "Vector3 -= Real"
+    Vector3& Vector3::operator -= (const Real param)
     {
 	    _x -= param;
 	    _y -= param;
@@ -155,8 +162,8 @@ namespace MTF
     }
 
 
-    // *= Overload: handles "Vector3 *= double"
-    Vector3& Vector3::operator *= (const double param)
+    // *= Overload: handles "Vector3 *= Real"
+    Vector3& Vector3::operator *= (const Real param)
     {
 	    _x *= param;
 	    _y *= param;
@@ -165,8 +172,8 @@ namespace MTF
     }
 
 
-    // /= Overload: handles "Vector3 /= double"
-    Vector3& Vector3::operator /= (const double param)
+    // /= Overload: handles "Vector3 /= Real"
+    Vector3& Vector3::operator /= (const Real param)
     {
 	    _x /= param;
 	    _y /= param;
@@ -190,7 +197,7 @@ namespace MTF
 
 
     // Sets the value for this vector
-    void Vector3::Set(double x, double y, double z)
+    void Vector3::Set(Real x, Real y, Real z)
     {
 	    _x = x;
 	    _y = y;
@@ -201,7 +208,7 @@ namespace MTF
     // Normalizes the vector so that its magnitude is 1
     void Vector3::Normalize()
     {
-	    double magnitude = GetLength();
+	    Real magnitude = GetLength();
 	    _x = _x / magnitude;
 	    _y = _y / magnitude;
 	    _z = _z / magnitude;
@@ -218,14 +225,14 @@ namespace MTF
 
 
     // Returns the length of the vector
-    double Vector3::GetLength()
+    Real Vector3::GetLength()
     {
 	    return sqrt(_x * _x + _y * _y + _z * _z);
     }
 
 
     // Returns the distance (absolute value) between two vectors
-    double Vector3::GetDistance(Vector3 param)
+    Real Vector3::GetDistance(Vector3 param)
     {
 	    Vector3 difference;
 	    difference._x = param.GetX() - _x;
@@ -236,14 +243,14 @@ namespace MTF
 
 
     // Returns the dot product of this vector with a given vector
-    double Vector3::DotProduct(Vector3 param)
+    Real Vector3::DotProduct(Vector3 param)
     {
 	    return _x * param.GetX() + _y * param.GetY() + _z * param.GetZ();
     }
 
 
     // Returns the absolute dot product of this vector with a given vector
-    double Vector3::AbsDotProduct(Vector3 param)
+    Real Vector3::AbsDotProduct(Vector3 param)
     {
         return abs(_x * param.GetX() + _y * param.GetY() + _z * param.GetZ());
     }
@@ -279,19 +286,19 @@ namespace MTF
     }
 
 
-    double Vector3::GetX()
+    Real Vector3::GetX()
     {
 	    return _x;
     }
 
 
-    double Vector3::GetY()
+    Real Vector3::GetY()
     {
 	    return _y;
     }
 
 
-    double Vector3::GetZ()
+    Real Vector3::GetZ()
     {
 	    return _z;
     }
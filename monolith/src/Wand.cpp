@@ -17,6 +17,8 @@ namespace MTF
         _rollingAverage = 0;
 
         _tracked = false;
+        _receiveTimeNs = -1;
+        _frameNumber = 0;
 
         for (int i = 0; i < 16; ++i)
             _buttons[i] = false;
@@ -35,20 +37,47 @@ namespace MTF
         _joystickHorizontal = _joystickVertical = 0;
 
         _rollingAverage = rollingAverage;
+        _previousPositions = RollingAverage(rollingAverage);
+        _previousViews = RollingAverage(rollingAverage);
 
         _tracked = false;
+        _receiveTimeNs = -1;
+        _frameNumber = 0;
 
         for (int i = 0; i < 16; ++i)
             _buttons[i] = false;
     }
 
 
+    Wand::Wand(const FlyStickState &state)
+    {
+        _tracked = state.pose.tracked;
+        _receiveTimeNs = state.pose.receiveTimeNs;
+        _frameNumber = state.pose.frameNumber;
+        _position = Vector3(state.pose.position[0], state.pose.position[1], state.pose.position[2]);
+        _view  = Vector3(state.pose.view[0], state.pose.view[1], state.pose.view[2]);
+        _up    = Vector3(state.pose.up[0], state.pose.up[1], state.pose.up[2]);
+        _right = Vector3(state.pose.right[0], state.pose.right[1], state.pose.right[2]);
+        _velocity = Vector3(state.pose.velocity[0], state.pose.velocity[1], state.pose.velocity[2]);
+        _angularVelocity = Vector3(state.pose.angularVelocity[0], state.pose.angularVelocity[1], state.pose.angularVelocity[2]);
+
+        _numButtons = state.numButtons;
+        _joystickHorizontal = state.joystickHorizontal;
+        _joystickVertical = state.joystickVertical;
+
+        _rollingAverage = 0;
+
+        for (int i = 0; i < 16; ++i)
+            _buttons[i] = state.buttons[i];
+    }
+
+
     Wand::~Wand()
     {
     }
 
 
-    void Wand::Update(DTrack_FlyStick_Type_d data)
+    void Wand::Update(DTrack_FlyStick_Type_d data, long long receiveTimeNs)
     {
         _tracked = data.quality != -1;
 
@@ -59,21 +88,58 @@ namespace MTF
                 data.rot[2], data.rot[5], data.rot[8], 0.0,
                 0.0,         0.0,         0.0, 1.0);
 
-            _position = Vector3(data.loc);
+            Vector3 position = Vector3(data.loc);
             // mm to foot conversion  ~3.28 ft to 1 m, 1 m to 1000 mm
-            _position *= 3.2808399 / 1000; 
+            position *= 3.2808399 / 1000; 
             // We want to give position in eye coordinates, so the wand position should be 
             // measued as distance into the scene as opposed to distance from the screen
-            _position *= Vector3(1.0, 1.0, -1.0);
+            position *= Vector3(1.0, 1.0, -1.0);
 
             // Similarly, the view vector should point by default into the negative z axis
-            _view  = mat * Vector3::UNIT_Z;
-            _up    = mat * Vector3::UNIT_Y;
-            _right = mat * Vector3::UNIT_X;
+            Vector3 view  = mat * Vector3::UNIT_Z;
+            Vector3 up    = mat * Vector3::UNIT_Y;
+            Vector3 right = mat * Vector3::UNIT_X;
+
+            view  *= Vector3(-1.0, -1.0, 1.0);
+            up    *= Vector3(-1.0, -1.0, 1.0);
+            right *= Vector3(-1.0, -1.0, 1.0);
+
+            bool accepted = true;
+            if (!_filter.IsEmpty())
+            {
+                PoseSample sample;
+                sample.position = position;
+                sample.orientation = Quaternion(view, right, up);
+                sample.quality = data.quality;
+                sample.time = receiveTimeNs * 1e-9;
+
+                // A rejected sample leaves the Wand where it was, but still updates the buttons
+                accepted = _filter.Apply(sample);
+
+                position = sample.position;
+                view  = sample.orientation.GetViewVector();
+                up    = sample.orientation.GetUpVector();
+                right = sample.orientation.GetRightVector();
+            }
 
-            _view  *= Vector3(-1.0, -1.0, 1.0);
-            _up    *= Vector3(-1.0, -1.0, 1.0);
-            _right *= Vector3(-1.0, -1.0, 1.0);
+            if (accepted)
+            {
+                _position = position;
+                _view  = view;
+                _up    = up;
+                _right = right;
+                _receiveTimeNs = receiveTimeNs;
+
+                _predictor.Update(_position, Quaternion(_view, _right, _up), receiveTimeNs * 1e-9);
+                _velocity = _predictor.GetVelocity();
+                _angularVelocity = _predictor.GetAngularVelocity();
+            }
+        }
+        else if (!_tracked)
+        {
+            _filter.Reset();
+            _predictor.Reset();
+            _velocity = _angularVelocity = Vector3::ZERO;
         }
 
         _numButtons = data.num_button;
@@ -86,36 +152,29 @@ namespace MTF
 
         if (_rollingAverage > 0)
         {
-            _previousPositions.push_back(_position);
-            if (_previousPositions.size() > _rollingAverage)
-            {
-                _previousPositions.pop_front();
-            }
-
-            _previousViews.push_back(_view);
-            if (_previousViews.size() > _rollingAverage)
-            {
-                _previousViews.pop_front();
-            }
+            _previousPositions.Add(_position);
+            _previousViews.Add(_view);
         }
     }
 
 
-    Vector3 Wand::GetPosition()
+    void Wand::SetFilter(PoseFilterChain filter)
     {
-        if (_rollingAverage > 0 && _previousPositions.size() > 1)
-        {
-            Vector3 p = Vector3::ZERO;
+        _filter = filter;
+    }
 
-            int count = 0;
-            for(std::list<Vector3>::iterator list_iter = _previousPositions.begin(); list_iter != _previousPositions.end(); ++list_iter)
-            {
-                p += *list_iter;
-                ++count;
-            }
-            p = p * (1.0 / count);
-            return p;
-        }
+
+    void Wand::SetPredictionMode(PosePredictor::MODE mode)
+    {
+        _predictor.SetMode(mode);
+        _velocity = _angularVelocity = Vector3::ZERO;
+    }
+
+
+    Vector3 Wand::GetPosition()
+    {
+        if (_rollingAverage > 0 && _previousPositions.GetCount() > 1)
+            return _previousPositions.GetAverage();
 
         return _position;
     }
@@ -123,19 +182,8 @@ namespace MTF
 
     Vector3 Wand::GetViewVector()
     {
-        if (_rollingAverage > 0 && _previousViews.size() > 1)
-        {
-            Vector3 v = Vector3::ZERO;
-
-            int count = 0;
-            for(std::list<Vector3>::iterator list_iter = _previousViews.begin(); list_iter != _previousViews.end(); ++list_iter)
-            {
-                v += *list_iter;
-                ++count;
-            }
-            v = v * (1.0 / count);
-            return v;
-        }
+        if (_rollingAverage > 0 && _previousViews.GetCount() > 1)
+            return _previousViews.GetAverage();
 
         return _view;
     }
@@ -153,6 +201,66 @@ namespace MTF
     }
 
 
+    Vector3 Wand::GetVelocity()
+    {
+        return _velocity;
+    }
+
+
+    Vector3 Wand::GetAngularVelocity()
+    {
+        return _angularVelocity;
+    }
+
+
+    Wand Wand::Predict(long long targetTimeNs)
+    {
+        Wand w = GetCopy();
+        if (!_tracked || _receiveTimeNs < 0)
+            return w;
+
+        Real seconds = (targetTimeNs - _receiveTimeNs) * 1e-9;
+        Quaternion rotation = PosePredictor::GetRotation(_angularVelocity, seconds);
+
+        // Start from the smoothed values, the copy no longer needs the rolling average
+        w._position = PosePredictor::Extrapolate(GetPosition(), _velocity, seconds);
+        w._view  = rotation * GetViewVector();
+        w._up    = rotation * _up;
+        w._right = rotation * _right;
+        w._rollingAverage = 0;
+
+        return w;
+    }
+
+
+    Wand Wand::Interpolate(Wand from, Wand to, long long timeNs)
+    {
+        long long span = to._receiveTimeNs - from._receiveTimeNs;
+        if (span <= 0 || !from._tracked || !to._tracked)
+            return (timeNs - from._receiveTimeNs < to._receiveTimeNs - timeNs) ? from : to;
+
+        Real s = (Real)(timeNs - from._receiveTimeNs) / span;
+
+        // The view vector may be smoothed, so the orientation is taken from the right and up vectors
+        Quaternion fromOrientation(from._right.CrossProduct(from._up), from._right, from._up);
+        Quaternion toOrientation(to._right.CrossProduct(to._up), to._right, to._up);
+        Quaternion orientation = Quaternion::Slerp(fromOrientation, toOrientation, s);
+        Quaternion rotation = orientation * fromOrientation.GetConjugate();
+
+        Wand w = from.GetCopy();
+        w._receiveTimeNs = timeNs;
+        w._position = from.GetPosition() + (to.GetPosition() - from.GetPosition()) * s;
+        w._view  = rotation * from.GetViewVector();
+        w._up    = orientation.GetUpVector();
+        w._right = orientation.GetRightVector();
+        w._velocity = from._velocity + (to._velocity - from._velocity) * s;
+        w._angularVelocity = from._angularVelocity + (to._angularVelocity - from._angularVelocity) * s;
+        w._rollingAverage = 0;
+
+        return w;
+    }
+
+
     Matrix4 Wand::GetTransformMatrix()
     {
         return Matrix4(_position, _view, _right, _up);
@@ -186,6 +294,18 @@ namespace MTF
     }
 
 
+    long long Wand::GetReceiveTimeNs()
+    {
+        return _receiveTimeNs;
+    }
+
+
+    unsigned long Wand::GetFrameNumber()
+    {
+        return _frameNumber;
+    }
+
+
     int Wand::GetNumButtons(void)
     {
         return _numButtons;
@@ -201,13 +321,13 @@ namespace MTF
     }
 
 
-    double Wand::GetJoystickHorizontal()
+    Real Wand::GetJoystickHorizontal()
     {
         return _joystickHorizontal;
     }
 
 
-    double Wand::GetJoystickVertical()
+    Real Wand::GetJoystickVertical()
     {
         return _joystickVertical;
     }
@@ -241,10 +361,14 @@ namespace MTF
     {
         Wand w;
         w._tracked = _tracked;
+        w._receiveTimeNs = _receiveTimeNs;
+        w._frameNumber = _frameNumber;
         w._position = Vector3(_position.GetX(), _position.GetY(), _position.GetZ());
         w._view = Vector3(_view.GetX(), _view.GetY(), _view.GetZ());
         w._up = Vector3(_up.GetX(), _up.GetY(), _up.GetZ());
         w._right = Vector3(_right.GetX(), _right.GetY(), _right.GetZ());
+        w._velocity = _velocity;
+        w._angularVelocity = _angularVelocity;
 
         w._numButtons = _numButtons;
     
@@ -262,4 +386,29 @@ namespace MTF
         return w;
     }
 
+
+    void Wand::GetState(FlyStickState &state)
+    {
+        Vector3 position = GetPosition();
+        Vector3 view = GetViewVector();
+
+        state.pose.tracked = _tracked;
+        state.pose.receiveTimeNs = _receiveTimeNs;
+        state.pose.frameNumber = _frameNumber;
+        state.pose.position[0] = position.GetX();  state.pose.position[1] = position.GetY();  state.pose.position[2] = position.GetZ();
+        state.pose.view[0]     = view.GetX();      state.pose.view[1]     = view.GetY();      state.pose.view[2]     = view.GetZ();
+        state.pose.up[0]       = _up.GetX();       state.pose.up[1]       = _up.GetY();       state.pose.up[2]       = _up.GetZ();
+        state.pose.right[0]    = _right.GetX();    state.pose.right[1]    = _right.GetY();    state.pose.right[2]    = _right.GetZ();
+
+        state.pose.velocity[0]        = _velocity.GetX();         state.pose.velocity[1]        = _velocity.GetY();         state.pose.velocity[2]        = _velocity.GetZ();
+        state.pose.angularVelocity[0] = _angularVelocity.GetX();  state.pose.angularVelocity[1] = _angularVelocity.GetY();  state.pose.angularVelocity[2] = _angularVelocity.GetZ();
+
+        state.numButtons = _numButtons;
+        state.joystickHorizontal = _joystickHorizontal;
+        state.joystickVertical = _joystickVertical;
+
+        for (int i = 0; i < 16; ++i)
+            state.buttons[i] = _buttons[i];
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,555 @@
+// This tool pretends to be an ART Tracker.  It sends DTrack2 ASCII packets with
+// moving standard bodies, FlySticks, measurement tools, Fingertracking hands and
+// single markers to a UDP port, so the framework can be tested and load tested
+// without the tracker.
+//
+// Build it together with the framework sources with tools/Makefile, on Linux:
+//   make -C tools DTrackSimulator
+// It is written to tools/build/DTrackSimulator.
+//
+// Usage:
+//   DTrackSimulator [options]
+//     --host <ip>            Computer to send to (127.0.0.1)
+//     --port <port>          Port to send to (5000)
+//     --rate <hz>            Frames per second, up to several thousand (60)
+//     --duration <s>         Seconds to run, 0 to run until stopped (0)
+//     --bodies <n>           Standard bodies (2)
+//     --flysticks <n>        FlySticks (1)
+//     --meatools <n>         Measurement tools (0)
+//     --hands <n>            Fingertracking hands (0)
+//     --markers <n>          Single markers (0)
+//     --trajectory <name>    circle, figure8, random or static (circle)
+//     --script <file>        Keyframes to follow instead of a trajectory, see below
+//     --dropout <p>          Chance per frame and body of not being tracked (0)
+//     --seed <n>             Seed for random trajectories and dropouts (1)
+//     --quiet                Don't print the rate once per second
+//
+// A script holds one keyframe per line: the body number, the time in seconds and
+// the position in mm followed by yaw, pitch and roll in degrees.  Body numbers count
+// the standard bodies first, then the FlySticks, then the measurement tools.  Poses
+// between keyframes are interpolated, and the script starts over after its last
+// keyframe.  Bodies without keyframes stand still.  Lines starting with # are ignored.
+//   # body  time   x     y      z     yaw  pitch  roll
+//     0     0.0    0     1600   1000  0    0      0
+//     0     2.0    500   1600   1000  90   0      0
+//
+// The coordinates are in mm with y pointing up, as the framework expects.
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include "DTrackNet.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+
+using namespace MTF;
+
+// Largest packet the SDK accepts with its default buffer
+#define MAX_PACKET 20000
+
+static const double PI = 3.14159265358979323846;
+
+
+// Position and orientation of one simulated body
+struct Pose
+{
+    Vector3 position;                   // mm
+    Quaternion orientation;
+};
+
+
+// A pose the script wants a body in at a certain time
+struct Keyframe
+{
+    int body;
+    double time;
+    Pose pose;
+};
+
+
+// Settings from the command line
+struct Settings
+{
+    std::string host;
+    int port;
+    double rate;
+    double duration;
+    int bodies;
+    int flySticks;
+    int meaTools;
+    int hands;
+    int markers;
+    std::string trajectory;
+    std::string script;
+    double dropout;
+    unsigned int seed;
+    bool quiet;
+};
+
+
+// State of a body on a random walk
+struct Walker
+{
+    double position[3];                 // mm
+    double velocity[3];                 // mm/s
+    double angles[3];                   // yaw, pitch, roll in radians
+    double angularVelocity[3];
+};
+
+
+static double Random()
+{
+    return rand() / (double)RAND_MAX;
+}
+
+
+static Quaternion FromAngles(double yaw, double pitch, double roll)
+{
+    return Quaternion(Vector3::UNIT_Y, yaw) * Quaternion(Vector3::UNIT_X, pitch) * Quaternion(Vector3::UNIT_Z, roll);
+}
+
+
+// Pose of a body on one of the built in trajectories.  Every body gets its own phase,
+// so they don't all sit on top of each other.
+static Pose GetTrajectoryPose(const std::string &trajectory, int body, double time)
+{
+    Pose pose;
+    double phase = body * 2 * PI / 7;
+    Vector3 center(0.0, 1600.0 - 300.0 * (body % 3), 1000.0);
+
+    if (trajectory == "circle")
+    {
+        double angle = time * 2 * PI / 4 + phase;
+        pose.position = center + Vector3(600.0 * cos(angle), 100.0 * sin(3 * angle), 600.0 * sin(angle));
+        pose.orientation = FromAngles(-angle, 0.2 * sin(2 * angle), 0.1 * cos(angle));
+    }
+    else if (trajectory == "figure8")
+    {
+        double angle = time * 2 * PI / 6 + phase;
+        pose.position = center + Vector3(800.0 * sin(angle), 50.0 * sin(4 * angle), 400.0 * sin(2 * angle));
+        pose.orientation = FromAngles(0.8 * cos(angle), 0.3 * sin(2 * angle), 0.0);
+    }
+    else
+    {
+        pose.position = center;
+    }
+
+    return pose;
+}
+
+
+// Moves a body on a random walk that stays inside the room
+static Pose StepWalker(Walker &walker, double dt)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        // Random acceleration, damped, so the speed stays like a person walking (about 1 m/s)
+        walker.velocity[i] += (Random() - 0.5) * 8000.0 * dt - walker.velocity[i] * 2.0 * dt;
+        walker.angularVelocity[i] += (Random() - 0.5) * 20.0 * dt - walker.angularVelocity[i] * 2.0 * dt;
+
+        walker.position[i] += walker.velocity[i] * dt;
+        walker.angles[i] += walker.angularVelocity[i] * dt;
+    }
+
+    // Turn back at the walls of a 4 m by 2.5 m by 4 m room
+    double low[3] = { -2000.0, 200.0, -1000.0 };
+    double high[3] = { 2000.0, 2500.0, 3000.0 };
+    for (int i = 0; i < 3; ++i)
+    {
+        if ((walker.position[i] < low[i] && walker.velocity[i] < 0) || (walker.position[i] > high[i] && walker.velocity[i] > 0))
+            walker.velocity[i] = -walker.velocity[i];
+    }
+
+    Pose pose;
+    pose.position = Vector3(walker.position);
+    pose.orientation = FromAngles(walker.angles[0], walker.angles[1], walker.angles[2]);
+    return pose;
+}
+
+
+// Pose of a body following the script
+static bool GetScriptPose(const std::vector<Keyframe> &script, double length, int body, double time, Pose &pose)
+{
+    const Keyframe *before = NULL;
+    const Keyframe *after = NULL;
+
+    if (length > 0)
+        time = fmod(time, length);
+
+    for (unsigned int i = 0; i < script.size(); ++i)
+    {
+        if (script[i].body != body)
+            continue;
+
+        if (script[i].time <= time)
+            before = &script[i];
+        else if (after == NULL)
+            after = &script[i];
+    }
+
+    if (before == NULL)
+        before = after;
+    if (after == NULL)
+        after = before;
+    if (before == NULL)
+        return false;
+
+    double t = 0.0;
+    if (after->time > before->time)
+        t = (time - before->time) / (after->time - before->time);
+
+    Pose from = before->pose;
+    Pose to = after->pose;
+    pose.position = from.position + (to.position - from.position) * t;
+    pose.orientation = Quaternion::Slerp(from.orientation, to.orientation, t);
+    return true;
+}
+
+
+static bool LoadScript(const std::string &filename, std::vector<Keyframe> &script, double &length)
+{
+    FILE *file = fopen(filename.c_str(), "r");
+    if (file == NULL)
+        return false;
+
+    char line[256];
+    length = 0.0;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        Keyframe keyframe;
+        double x, y, z, yaw, pitch, roll;
+
+        if (line[0] == '#' || sscanf(line, "%d %lf %lf %lf %lf %lf %lf %lf", &keyframe.body, &keyframe.time, &x, &y, &z, &yaw, &pitch, &roll) != 8)
+            continue;
+
+        keyframe.pose.position = Vector3(x, y, z);
+        keyframe.pose.orientation = FromAngles(yaw * PI / 180, pitch * PI / 180, roll * PI / 180);
+        script.push_back(keyframe);
+
+        if (keyframe.time > length)
+            length = keyframe.time;
+    }
+
+    fclose(file);
+    return !script.empty();
+}
+
+
+// Appends text to the packet, keeping track of the space left
+static void Append(char *packet, int &length, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(packet + length, MAX_PACKET - length, format, args);
+    va_end(args);
+
+    if (written > 0)
+        length += written;
+    if (length > MAX_PACKET - 1)
+        length = MAX_PACKET - 1;
+}
+
+
+// Appends the position block and the column-wise rotation matrix block of a pose
+static void AppendPose(char *packet, int &length, Pose pose)
+{
+    Quaternion orientation = pose.orientation;
+    Vector3 right = orientation * Vector3::UNIT_X;
+    Vector3 up    = orientation * Vector3::UNIT_Y;
+    Vector3 view  = orientation * Vector3::UNIT_Z;
+
+    Append(packet, length, "[%.3f %.3f %.3f][%.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f]",
+           pose.position.GetX(), pose.position.GetY(), pose.position.GetZ(),
+           right.GetX(), right.GetY(), right.GetZ(),
+           up.GetX(), up.GetY(), up.GetZ(),
+           view.GetX(), view.GetY(), view.GetZ());
+}
+
+
+static void PrintUsage()
+{
+    printf("Usage: DTrackSimulator [--host ip] [--port n] [--rate hz] [--duration s] [--bodies n] [--flysticks n]\n"
+           "                       [--meatools n] [--hands n] [--markers n] [--trajectory circle|figure8|random|static]\n"
+           "                       [--script file] [--dropout p] [--seed n] [--quiet]\n");
+}
+
+
+static bool ParseArguments(int argc, char **argv, Settings &settings)
+{
+    settings.host = "127.0.0.1";
+    settings.port = 5000;
+    settings.rate = 60.0;
+    settings.duration = 0.0;
+    settings.bodies = 2;
+    settings.flySticks = 1;
+    settings.meaTools = 0;
+    settings.hands = 0;
+    settings.markers = 0;
+    settings.trajectory = "circle";
+    settings.dropout = 0.0;
+    settings.seed = 1;
+    settings.quiet = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+
+        if (option == "--quiet")
+        {
+            settings.quiet = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return false;
+        const char *value = argv[++i];
+
+        if (option == "--host")            settings.host = value;
+        else if (option == "--port")       settings.port = atoi(value);
+        else if (option == "--rate")       settings.rate = atof(value);
+        else if (option == "--duration")   settings.duration = atof(value);
+        else if (option == "--bodies")     settings.bodies = atoi(value);
+        else if (option == "--flysticks")  settings.flySticks = atoi(value);
+        else if (option == "--meatools")   settings.meaTools = atoi(value);
+        else if (option == "--hands")      settings.hands = atoi(value);
+        else if (option == "--markers")    settings.markers = atoi(value);
+        else if (option == "--trajectory") settings.trajectory = value;
+        else if (option == "--script")     settings.script = value;
+        else if (option == "--dropout")    settings.dropout = atof(value);
+        else if (option == "--seed")       settings.seed = (unsigned int)atoi(value);
+        else
+            return false;
+    }
+
+    return settings.rate > 0 && settings.port > 0 && settings.bodies >= 0 && settings.flySticks >= 0 &&
+           settings.meaTools >= 0 && settings.hands >= 0 && settings.markers >= 0;
+}
+
+
+// Entry point to our program
+int main(int argc, char **argv)
+{
+    Settings settings;
+    if (!ParseArguments(argc, argv, settings))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<Keyframe> script;
+    double scriptLength = 0.0;
+    if (!settings.script.empty() && !LoadScript(settings.script, script, scriptLength))
+    {
+        fprintf(stderr, "Unable to read keyframes from %s\n", settings.script.c_str());
+        return 1;
+    }
+
+    unsigned int ip = ip_name2ip(settings.host.c_str());
+    void *sock;
+    unsigned short port = 0;
+    if (ip == 0 || udp_init(&sock, &port) != 0)
+    {
+        fprintf(stderr, "Unable to send to %s\n", settings.host.c_str());
+        return 1;
+    }
+
+    srand(settings.seed);
+
+    // Bodies, FlySticks and measurement tools all move the same way, one after the other
+    int movers = settings.bodies + settings.flySticks + settings.meaTools;
+    std::vector<Walker> walkers(movers);
+    std::vector<Pose> poses(movers);
+    std::vector<bool> tracked(movers);
+    for (int i = 0; i < movers; ++i)
+    {
+        walkers[i].position[0] = (Random() - 0.5) * 2000.0;
+        walkers[i].position[1] = 1000.0 + Random() * 800.0;
+        walkers[i].position[2] = Random() * 2000.0;
+        walkers[i].angles[0] = Random() * 2 * PI;
+        walkers[i].angles[1] = 0.0;
+        walkers[i].angles[2] = 0.0;
+        for (int j = 0; j < 3; ++j)
+        {
+            walkers[i].velocity[j] = 0.0;
+            walkers[i].angularVelocity[j] = 0.0;
+        }
+    }
+
+    std::vector<unsigned int> buttons(settings.flySticks, 0);
+
+    printf("Sending %d bodies, %d FlySticks, %d measurement tools, %d hands and %d markers to %s:%d at %.0f Hz\n",
+           settings.bodies, settings.flySticks, settings.meaTools, settings.hands, settings.markers,
+           settings.host.c_str(), settings.port, settings.rate);
+
+    char packet[MAX_PACKET];
+    double period = 1.0 / settings.rate;
+    long long startNs = udp_get_time_ns();
+    boost::system_time start = boost::get_system_time();
+
+    unsigned int frame = 0;
+    unsigned int sentSinceReport = 0;
+    unsigned int lateSinceReport = 0;
+    double lastReport = 0.0;
+
+    for (;; ++frame)
+    {
+        double time = frame * period;
+        if (settings.duration > 0 && time >= settings.duration)
+            break;
+
+        // Sleep until this frame is due.  Frames that are already late are sent right away,
+        // without trying to catch up on the time by sending faster.
+        boost::system_time due = start + boost::posix_time::microseconds((long long)(time * 1e6));
+        if (boost::get_system_time() < due)
+            boost::this_thread::sleep(due);
+        else if (frame > 0)
+            ++lateSinceReport;
+
+        double dt = (frame == 0) ? 0.0 : period;
+        for (int i = 0; i < movers; ++i)
+        {
+            if (!script.empty())
+            {
+                if (!GetScriptPose(script, scriptLength, i, time, poses[i]))
+                    poses[i] = GetTrajectoryPose("static", i, time);
+            }
+            else if (settings.trajectory == "random")
+                poses[i] = StepWalker(walkers[i], dt);
+            else
+                poses[i] = GetTrajectoryPose(settings.trajectory, i, time);
+
+            tracked[i] = Random() >= settings.dropout;
+        }
+
+        // FlyStick buttons are pressed and released now and then, the joystick moves slowly
+        for (int i = 0; i < settings.flySticks; ++i)
+        {
+            if (Random() < period)
+                buttons[i] ^= 1u << (rand() % 4);
+        }
+
+        int length = 0;
+        long long nowNs = startNs + (long long)(time * 1e9);
+        double secondsToday = fmod(nowNs / 1e9, 86400.0);
+
+        Append(packet, length, "fr %u\r\n", frame);
+        Append(packet, length, "ts %.6f\r\n", secondsToday);
+        // Like DTrack2, 6dcal counts the measurement tools but not the FlySticks sent in 6df2 lines
+        Append(packet, length, "6dcal %d\r\n", settings.bodies + settings.meaTools);
+
+        // Standard bodies: only the tracked ones are listed
+        int listed = 0;
+        for (int i = 0; i < settings.bodies; ++i)
+            listed += tracked[i] ? 1 : 0;
+
+        Append(packet, length, "6d %d", listed);
+        for (int i = 0; i < settings.bodies; ++i)
+        {
+            if (!tracked[i])
+                continue;
+
+            Append(packet, length, " [%d 1.000]", i);
+            AppendPose(packet, length, poses[i]);
+        }
+        Append(packet, length, "\r\n");
+
+        // FlySticks: all are listed, those not tracked with a quality of -1
+        if (settings.flySticks > 0)
+        {
+            Append(packet, length, "6df2 %d %d", settings.flySticks, settings.flySticks);
+            for (int i = 0; i < settings.flySticks; ++i)
+            {
+                int index = settings.bodies + i;
+                Pose pose = poses[index];
+                if (!tracked[index])
+                {
+                    pose.position = Vector3::ZERO;
+                    pose.orientation = Quaternion::IDENTITY;
+                }
+
+                Append(packet, length, " [%d %s 6 2]", i, tracked[index] ? "1.000" : "-1.000");
+                AppendPose(packet, length, pose);
+                Append(packet, length, "[%u %.2f %.2f]", buttons[i], sin(time * 0.7 + i), cos(time * 0.5 + i));
+            }
+            Append(packet, length, "\r\n");
+        }
+
+        // Measurement tools: all are listed, those not tracked with a quality of -1
+        if (settings.meaTools > 0)
+        {
+            Append(packet, length, "6dmt %d", settings.meaTools);
+            for (int i = 0; i < settings.meaTools; ++i)
+            {
+                int index = settings.bodies + settings.flySticks + i;
+                Append(packet, length, " [%d %s %d]", i, tracked[index] ? "1.000" : "-1.000", (frame / (int)settings.rate) % 2);
+                AppendPose(packet, length, poses[index]);
+            }
+            Append(packet, length, "\r\n");
+        }
+
+        // Hands: a right hand with 5 fingers each, opening and closing
+        if (settings.hands > 0)
+        {
+            Append(packet, length, "glcal %d\r\n", settings.hands);
+            Append(packet, length, "gl %d", settings.hands);
+            for (int i = 0; i < settings.hands; ++i)
+            {
+                Pose hand = GetTrajectoryPose(settings.trajectory == "static" ? "static" : "figure8", i + movers, time);
+                Append(packet, length, " [%d 1.000 1 5]", i);
+                AppendPose(packet, length, hand);
+
+                double bend = 30.0 + 30.0 * sin(time * 2.0 + i);
+                for (int finger = 0; finger < 5; ++finger)
+                {
+                    Pose tip;
+                    tip.position = hand.position + hand.orientation * Vector3(-40.0 + 20.0 * finger, 0.0, 90.0);
+                    tip.orientation = hand.orientation * Quaternion(Vector3::UNIT_X, bend * PI / 180);
+                    AppendPose(packet, length, tip);
+                    Append(packet, length, "[8.5 35.0 %.1f 25.0 %.1f 20.0]", bend, bend);
+                }
+            }
+            Append(packet, length, "\r\n");
+        }
+
+        // Single markers, spread over a slowly turning ring
+        if (settings.markers > 0)
+        {
+            Append(packet, length, "3d %d", settings.markers);
+            for (int i = 0; i < settings.markers; ++i)
+            {
+                double angle = time * 0.5 + i * 2 * PI / settings.markers;
+                Append(packet, length, " [%d 1.000][%.3f %.3f %.3f]", i + 1, 1500.0 * cos(angle), 2000.0, 1000.0 + 1500.0 * sin(angle));
+            }
+            Append(packet, length, "\r\n");
+        }
+
+        if (length >= MAX_PACKET - 1)
+        {
+            fprintf(stderr, "Frame %u does not fit into %d bytes, use fewer bodies\n", frame, MAX_PACKET);
+            break;
+        }
+
+        if (udp_send(sock, packet, length, ip, (unsigned short)settings.port, 1000000) != 0)
+            fprintf(stderr, "Frame %u could not be sent\n", frame);
+        else
+            ++sentSinceReport;
+
+        if (!settings.quiet && time - lastReport >= 1.0)
+        {
+            printf("frame %u: %u frames sent in the last second, %u late\n", frame, sentSinceReport, lateSinceReport);
+            lastReport = time;
+            sentSinceReport = 0;
+            lateSinceReport = 0;
+        }
+    }
+
+    udp_exit(sock);
+    return 0;
+}
@@ -0,0 +1,222 @@
+// This tool checks that frames are handed out in order and only once they can be read.
+// It runs three checks and prints the problems each one found:
+//   seqlock      A writer thread publishes values through a SeqLock and a SeqLockRing while
+//                reader threads copy them out.  A reader must never see a torn value, a value
+//                older than one it saw before, or fail to read a value the ring still holds.
+//   replay       Replays a capture of numbered frames as fast as possible through Monolith.
+//                The main thread reads the frame number and then the head, which must be from
+//                that frame or a newer one, also right after WaitForNextFrame returns.
+//   subscribers  During the same replay, the TRACKING_THREAD subscriber must see every frame
+//                and the DISPATCHER_THREAD subscriber every frame it did not fall behind on.
+//
+// Build it together with the framework sources with tools/Makefile, on Linux:
+//   make -C tools FrameOrderCheck
+// It is written to tools/build/FrameOrderCheck.  make -C tools check also runs it.
+//
+// Usage:
+//   FrameOrderCheck [frames] [capture file]   Frames to replay (200000), file to write them to (FrameOrderCheck.cap)
+// Exits with 1 if any check found a problem.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Monolith.h"
+#include "PacketCapture.h"
+#include "SeqLock.h"
+#include "SeqLockRing.h"
+
+using namespace MTF;
+
+// Number of values the seqlock check writes
+#define SEQLOCK_VALUES 2000000
+
+// Number of threads reading in the seqlock check
+#define SEQLOCK_READERS 2
+
+
+// Written through the SeqLock, every word holds the same number
+struct Value
+{
+    unsigned long words[32];
+};
+
+
+static SeqLock<Value> seqLock;
+static SeqLockRing<Value, 64> ring;
+static boost::atomic<bool> writing(true);
+static boost::atomic<unsigned long> seqLockProblems(0);
+
+
+static void WriteValues()
+{
+    Value value;
+    for (unsigned long n = 1; n <= SEQLOCK_VALUES; ++n)
+    {
+        for (int i = 0; i < 32; ++i)
+            value.words[i] = n;
+        seqLock.Write(value);
+        ring.Write(value);
+    }
+    writing = false;
+}
+
+
+// Returns whether all words of a value hold the same number
+static bool IsWhole(const Value &value)
+{
+    for (int i = 1; i < 32; ++i)
+    {
+        if (value.words[i] != value.words[0])
+            return false;
+    }
+    return true;
+}
+
+
+static void ReadValues()
+{
+    unsigned long last = 0;
+    Value value;
+
+    while (writing)
+    {
+        seqLock.Read(value);
+        if (!IsWhole(value) || value.words[0] < last)
+            ++seqLockProblems;
+        last = value.words[0];
+
+        // The newest value of the ring must be readable, unless the writer has replaced it meanwhile
+        unsigned long count = ring.GetCount();
+        if (count == 0)
+            continue;
+        if (ring.Read(count - 1, value))
+        {
+            if (!IsWhole(value) || value.words[0] != count)
+                ++seqLockProblems;
+        }
+        else if (ring.GetCount() - (count - 1) < ring.GetCapacity())
+        {
+            ++seqLockProblems;
+        }
+    }
+}
+
+
+static unsigned long CheckSeqLock()
+{
+    boost::thread writer(&WriteValues);
+    boost::thread_group readers;
+    for (int i = 0; i < SEQLOCK_READERS; ++i)
+        readers.create_thread(&ReadValues);
+
+    writer.join();
+    readers.join_all();
+    return seqLockProblems;
+}
+
+
+// Writes a capture with the frame number as the x position of body 0
+static bool WriteCapture(std::string filename, int frames)
+{
+    PacketCapture capture(filename);
+    for (int frame = 1; frame <= frames && capture.IsValid(); ++frame)
+    {
+        char packet[512];
+        int length = snprintf(packet, sizeof(packet),
+                              "fr %d\r\n6d 1 [0 1.000][%d.000 1600.000 0.000][1 0 0 0 1 0 0 0 1]\r\n"
+                              "6df2 1 1 [0 1.000 6 2][0.000 1200.000 0.000][1 0 0 0 1 0 0 0 1][0 0.00 0.00]\r\n",
+                              frame, frame);
+        capture.Write(0, packet, length, frame * 1000000LL);
+    }
+    return capture.IsValid();
+}
+
+
+static Monolith *monolith;
+static boost::atomic<unsigned long> lastTracked(0);
+static boost::atomic<unsigned long> lastDispatched(0);
+static boost::atomic<unsigned long> dispatched(0);
+static boost::atomic<unsigned long> subscriberProblems(0);
+static boost::atomic<unsigned long> fellBehind(0);
+
+
+// Must see every frame, and only once the frame number says it is there
+static void OnTrackingThread(const TrackingFrame &frame)
+{
+    if (frame.frameNumber != lastTracked + 1 || monolith->GetFrameNumber() < frame.frameNumber)
+        ++subscriberProblems;
+    lastTracked = frame.frameNumber;
+}
+
+
+// May only miss frames that left the history before it got to them
+static void OnDispatcherThread(const TrackingFrame &frame)
+{
+    if (frame.frameNumber != lastDispatched + 1)
+    {
+        if (monolith->GetFrameNumber() + 2 >= frame.frameNumber + FrameStore::HISTORY_SIZE)
+            ++fellBehind;
+        else
+            ++subscriberProblems;
+    }
+    lastDispatched = frame.frameNumber;
+    ++dispatched;
+}
+
+
+// Entry point to our program
+int main(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 200000;
+    std::string filename = (argc > 2) ? argv[2] : "FrameOrderCheck.cap";
+    if (frames <= 0)
+    {
+        printf("Usage: FrameOrderCheck [frames] [capture file]\n");
+        return 1;
+    }
+
+    unsigned long seqLockFailures = CheckSeqLock();
+    printf("seqlock      %d values, %d readers: %lu problems\n", SEQLOCK_VALUES, SEQLOCK_READERS, seqLockFailures);
+
+    if (!WriteCapture(filename, frames))
+    {
+        fprintf(stderr, "Unable to write the capture \"%s\"\n", filename.c_str());
+        return 1;
+    }
+
+    monolith = new Monolith(NULL, filename, PacketReplay::AS_FAST_AS_POSSIBLE);
+    monolith->Subscribe(&OnTrackingThread, Subscription::TRACKING_THREAD);
+    monolith->Subscribe(&OnDispatcherThread, Subscription::DISPATCHER_THREAD);
+
+    // Whatever frame number is seen, the head read afterwards must be at least that new
+    unsigned long reads = 0, staleReads = 0;
+    unsigned long seen = 0;
+    while (seen < (unsigned long)frames)
+    {
+        unsigned long number = monolith->GetFrameNumber();
+        Head head = monolith->GetHead();
+        if (head.GetFrameNumber() < number)
+            ++staleReads;
+
+        if (!monolith->WaitForNextFrame(seen, 1000))
+            break;
+        head = monolith->GetHead();
+        if (head.GetFrameNumber() <= seen)
+            ++staleReads;
+        seen = head.GetFrameNumber();
+        reads += 2;
+    }
+    monolith->ShutdownTracking();
+    delete monolith;
+    remove(filename.c_str());
+
+    bool complete = seen == (unsigned long)frames && lastTracked == (unsigned long)frames;
+    printf("replay       %d frames, %lu reads: %lu stale%s\n", frames, reads, staleReads, complete ? "" : ", not all frames arrived");
+    printf("subscribers  %lu dispatched, %lu times fell behind: %lu problems\n", (unsigned long)dispatched, (unsigned long)fellBehind, (unsigned long)subscriberProblems);
+
+    return (seqLockFailures == 0 && staleReads == 0 && subscriberProblems == 0 && complete) ? 0 : 1;
+}
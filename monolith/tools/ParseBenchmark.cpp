@@ -0,0 +1,390 @@
+// This tool measures how long it takes to parse DTrack2 ASCII packets.  It builds
+// realistic frames, parses them over and over and prints the time per frame:
+//   numbers      Reading all '[...]' blocks with string_get_block, and with the same
+//                blocks read by strtol()/strtod(), as DTrackParse did before
+//   sdk          The complete DTrackSDK::receivePacket, parsing everything
+//   tracker      The same, parsing only the standard bodies and Flysticks like the tracking thread
+// Before that it checks that string_get_d and string_get_i give exactly the same results
+// as strtod() and strtol() for many random numbers written the ways DTrack writes them.
+//
+// Build it together with the framework sources with tools/Makefile, on Linux:
+//   make -C tools ParseBenchmark
+// It is written to tools/build/ParseBenchmark.
+//
+// Usage:
+//   ParseBenchmark [iterations]    Times each frame is parsed, in 5 rounds of which the best counts (20000)
+//   ParseBenchmark --check         Only run the checks, also comparing every block of the frames;
+//                                  exits with 1 on any difference (make -C tools check)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DTrackNet.h"
+#include "DTrackParse.hpp"
+#include "DTrackSDK.hpp"
+
+// Largest packet the SDK accepts with its default buffer
+#define MAX_PACKET 20000
+
+// Number of rounds the iterations are split into
+#define ROUNDS 5
+
+
+// A frame to parse and what it holds
+struct Frame
+{
+    std::string name;
+    std::string packet;
+};
+
+
+// Appends text to the packet
+static void Append(std::string &packet, const char *format, ...)
+{
+    char text[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    packet += text;
+}
+
+
+static double Random(double low, double high)
+{
+    return low + (high - low) * (rand() / (double)RAND_MAX);
+}
+
+
+// Appends a position block and a rotation matrix block with numbers like DTrack writes them
+static void AppendPose(std::string &packet)
+{
+    Append(packet, "[%.3f %.3f %.3f]", Random(-3000, 3000), Random(0, 2500), Random(-3000, 3000));
+    Append(packet, "[%.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f]",
+           Random(-1, 1), Random(-1, 1), Random(-1, 1), Random(-1, 1), Random(-1, 1),
+           Random(-1, 1), Random(-1, 1), Random(-1, 1), Random(-1, 1));
+}
+
+
+static Frame MakeFrame(std::string name, int bodies, int flySticks, int hands, int markers)
+{
+    Frame frame;
+    frame.name = name;
+    std::string &packet = frame.packet;
+
+    Append(packet, "fr 123456\r\nts 45296.123456\r\n6dcal %d\r\n", bodies);
+
+    Append(packet, "6d %d", bodies);
+    for (int i = 0; i < bodies; ++i)
+    {
+        Append(packet, " [%d 1.000]", i);
+        AppendPose(packet);
+    }
+    Append(packet, "\r\n");
+
+    if (flySticks > 0)
+    {
+        Append(packet, "6df2 %d %d", flySticks, flySticks);
+        for (int i = 0; i < flySticks; ++i)
+        {
+            Append(packet, " [%d 1.000 6 2]", i);
+            AppendPose(packet);
+            Append(packet, "[%d %.2f %.2f]", rand() % 64, Random(-1, 1), Random(-1, 1));
+        }
+        Append(packet, "\r\n");
+    }
+
+    if (hands > 0)
+    {
+        Append(packet, "glcal %d\r\ngl %d", hands, hands);
+        for (int i = 0; i < hands; ++i)
+        {
+            Append(packet, " [%d 1.000 %d 5]", i, i % 2);
+            AppendPose(packet);
+            for (int finger = 0; finger < 5; ++finger)
+            {
+                AppendPose(packet);
+                Append(packet, "[%.3f %.3f %.3f %.3f %.3f %.3f]", Random(5, 10), Random(20, 50), Random(0, 90), Random(20, 40), Random(0, 90), Random(15, 30));
+            }
+        }
+        Append(packet, "\r\n");
+    }
+
+    if (markers > 0)
+    {
+        Append(packet, "3d %d", markers);
+        for (int i = 0; i < markers; ++i)
+            Append(packet, " [%d 1.000][%.3f %.3f %.3f]", i + 1, Random(-3000, 3000), Random(0, 2500), Random(-3000, 3000));
+        Append(packet, "\r\n");
+    }
+
+    return frame;
+}
+
+
+// Reads a block like string_get_block, with strtol() and strtod() as DTrackParse did before
+static char* ReferenceGetBlock(char *str, const char *fmt, int *idat, double *ddat)
+{
+    char *strend;
+    if ((str = strchr(str, '[')) == NULL || (strend = strchr(str, ']')) == NULL)
+        return NULL;
+
+    str++;
+    *strend = '\0';
+    int index_i = 0, index_d = 0;
+    while (*fmt)
+    {
+        char *s;
+        if (*fmt++ == 'i')
+            idat[index_i++] = (int)strtol(str, &s, 0);
+        else
+            ddat[index_d++] = strtod(str, &s);
+
+        if (s == str)
+        {
+            *strend = ']';
+            return NULL;
+        }
+        str = s;
+    }
+    *strend = ']';
+    return strend + 1;
+}
+
+
+// Format of each block in a frame, so both readers get the same work
+static void GetBlockFormats(const std::string &packet, std::vector<std::string> &formats)
+{
+    for (std::string::size_type start = packet.find('['); start != std::string::npos; start = packet.find('[', start + 1))
+    {
+        std::string::size_type end = packet.find(']', start);
+        std::string block = packet.substr(start + 1, end - start - 1);
+
+        std::string format;
+        const char *s = block.c_str();
+        while (*s)
+        {
+            while (*s == ' ')
+                ++s;
+            if (!*s)
+                break;
+
+            const char *token = s;
+            while (*s && *s != ' ')
+                ++s;
+            format += (std::string(token, s).find('.') == std::string::npos) ? 'i' : 'd';
+        }
+        formats.push_back(format);
+    }
+}
+
+
+static void GetBlocks(char *packet, const std::vector<std::string> &formats, bool reference)
+{
+    int idat[32];
+    double ddat[32];
+    char *s = packet;
+
+    for (unsigned int i = 0; i < formats.size() && s != NULL; ++i)
+    {
+        if (reference)
+            s = ReferenceGetBlock(s, formats[i].c_str(), idat, ddat);
+        else
+            s = string_get_block(s, formats[i].c_str(), idat, NULL, ddat);
+    }
+
+    if (s == NULL)
+    {
+        fprintf(stderr, "A block could not be read\n");
+        exit(-1);
+    }
+}
+
+
+// Compares string_get_d and string_get_i with strtod() and strtol(), bit for bit
+static bool CheckNumbers(int count)
+{
+    static const char *formats[] = { "%.3f", "%.6f", "%.2f", "%.0f", "%.9f", "%.15g", "%.17g", "%g", "%e" };
+    static const int numFormats = sizeof(formats) / sizeof(formats[0]);
+    int failures = 0;
+
+    for (int n = 0; n < count; ++n)
+    {
+        char text[64];
+        double value = Random(-1, 1) * pow(10.0, Random(-8, 8));
+        snprintf(text, sizeof(text), formats[n % numFormats], value);
+        strcat(text, "]");
+
+        char *end, *expectedEnd;
+        double parsed = 0, expected = strtod(text, &expectedEnd);
+        end = string_get_d(text, &parsed);
+        if (end != expectedEnd || memcmp(&parsed, &expected, sizeof(double)) != 0)
+        {
+            if (++failures <= 10)
+                printf("  string_get_d(\"%s\") = %.17g, strtod() = %.17g\n", text, parsed, expected);
+        }
+
+        snprintf(text, sizeof(text), "%d ", (int)(Random(-1, 1) * pow(10.0, Random(0, 9.3))));
+        int parsedInt = 0, expectedInt = (int)strtol(text, &expectedEnd, 0);
+        end = string_get_i(text, &parsedInt);
+        if (end != expectedEnd || parsedInt != expectedInt)
+        {
+            if (++failures <= 10)
+                printf("  string_get_i(\"%s\") = %d, strtol() = %d\n", text, parsedInt, expectedInt);
+        }
+    }
+
+    // Cases DTrack does not send, left to the C library
+    static const char *special[] = { " 1e400", "-0.0", "0x1A", "010", "  .5", "5.", "-inf", "nan", "1e", "123456789012345678", "4.9e-324", "\t7" };
+    for (unsigned int i = 0; i < sizeof(special) / sizeof(special[0]); ++i)
+    {
+        char text[64];
+        strcpy(text, special[i]);
+
+        char *expectedEnd;
+        double parsed = 0, expected = strtod(text, &expectedEnd);
+        char *end = string_get_d(text, &parsed);
+        if ((end ? end : text) != expectedEnd || (end && memcmp(&parsed, &expected, sizeof(double)) != 0))
+        {
+            ++failures;
+            printf("  string_get_d(\"%s\") = %.17g, strtod() = %.17g\n", text, parsed, expected);
+        }
+
+        int parsedInt = 0, expectedInt = (int)strtol(text, &expectedEnd, 0);
+        end = string_get_i(text, &parsedInt);
+        if ((end ? end : text) != expectedEnd || (end && parsedInt != expectedInt))
+        {
+            ++failures;
+            printf("  string_get_i(\"%s\") = %d, strtol() = %d\n", text, parsedInt, expectedInt);
+        }
+    }
+
+    printf("Checked %d random numbers against strtod() and strtol(): %d differences\n\n", count, failures);
+    return failures == 0;
+}
+
+
+// Compares every block of the frames read by string_get_block with strtol() and strtod(), bit for bit
+static bool CheckBlocks(const std::vector<Frame> &frames)
+{
+    int failures = 0;
+
+    for (unsigned int f = 0; f < frames.size(); ++f)
+    {
+        std::vector<std::string> formats;
+        GetBlockFormats(frames[f].packet, formats);
+
+        std::vector<char> buffer(frames[f].packet.begin(), frames[f].packet.end());
+        buffer.push_back('\0');
+
+        char *s = &buffer[0];
+        char *expectedS = &buffer[0];
+        for (unsigned int i = 0; i < formats.size() && s != NULL && expectedS != NULL; ++i)
+        {
+            int idat[32], expectedIdat[32];
+            double ddat[32], expectedDdat[32];
+            memset(idat, 0, sizeof(idat));
+            memset(ddat, 0, sizeof(ddat));
+            memset(expectedIdat, 0, sizeof(expectedIdat));
+            memset(expectedDdat, 0, sizeof(expectedDdat));
+
+            s = string_get_block(s, formats[i].c_str(), idat, NULL, ddat);
+            expectedS = ReferenceGetBlock(expectedS, formats[i].c_str(), expectedIdat, expectedDdat);
+            if (s != expectedS || memcmp(idat, expectedIdat, sizeof(idat)) != 0 || memcmp(ddat, expectedDdat, sizeof(ddat)) != 0)
+            {
+                if (++failures <= 10)
+                    printf("  Block %u of the frame \"%s\" differs from strtod()\n", i, frames[f].name.c_str());
+            }
+        }
+    }
+
+    printf("Checked the blocks of %d frames against strtod() and strtol(): %d differences\n\n", (int)frames.size(), failures);
+    return failures == 0;
+}
+
+
+// Entry point to our program
+int main(int argc, char **argv)
+{
+    bool checkOnly = argc > 1 && strcmp(argv[1], "--check") == 0;
+    int iterations = (argc > 1 && !checkOnly) ? atoi(argv[1]) : 20000;
+    if (iterations <= 0)
+    {
+        printf("Usage: ParseBenchmark [iterations | --check]\n");
+        return 1;
+    }
+
+    srand(1);
+    bool same = CheckNumbers(1000000);
+
+    std::vector<Frame> frames;
+    frames.push_back(MakeFrame("head + wand", 1, 1, 0, 0));
+    frames.push_back(MakeFrame("8 bodies", 8, 2, 0, 0));
+    frames.push_back(MakeFrame("2 hands", 1, 1, 2, 0));
+    frames.push_back(MakeFrame("16 bodies + markers", 16, 4, 0, 32));
+    frames.push_back(MakeFrame("hands + 128 markers", 4, 1, 2, 128));
+
+    same = CheckBlocks(frames) && same;
+    if (checkOnly)
+        return same ? 0 : 1;
+
+    printf("%-22s %6s %8s | %12s %12s %8s | %10s %10s\n", "frame", "bytes", "numbers", "strtod us", "fast us", "speedup", "sdk us", "tracker us");
+
+    DTrackSDK sdk("", 0, 0, DTrackSDK::SYS_DTRACK_UNKNOWN);
+    DTrackSDK tracker("", 0, 0, DTrackSDK::SYS_DTRACK_UNKNOWN);
+    DTrack_Subscription_Type subscription;
+    subscription.types = DTRACK_DATA_BODY | DTRACK_DATA_FLYSTICK;
+    tracker.setSubscription(subscription);
+    for (unsigned int f = 0; f < frames.size(); ++f)
+    {
+        std::vector<std::string> formats;
+        GetBlockFormats(frames[f].packet, formats);
+
+        int numbers = 0;
+        for (unsigned int i = 0; i < formats.size(); ++i)
+            numbers += formats[i].size();
+
+        std::vector<char> buffer(frames[f].packet.begin(), frames[f].packet.end());
+        buffer.push_back('\0');
+
+        // Each time is the best of a few rounds, so other programs running in between count less
+        double times[4] = { 1e30, 1e30, 1e30, 1e30 };
+        int perRound = std::max(iterations / ROUNDS, 1);
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            for (int reference = 1; reference >= 0; --reference)
+            {
+                long long start = udp_get_time_ns();
+                for (int i = 0; i < perRound; ++i)
+                    GetBlocks(&buffer[0], formats, reference != 0);
+                times[reference] = std::min(times[reference], (udp_get_time_ns() - start) / 1e3 / perRound);
+            }
+
+            for (int subscribed = 0; subscribed <= 1; ++subscribed)
+            {
+                DTrackSDK &parser = subscribed ? tracker : sdk;
+                long long start = udp_get_time_ns();
+                for (int i = 0; i < perRound; ++i)
+                {
+                    if (!parser.receivePacket(frames[f].packet.c_str(), frames[f].packet.size(), start))
+                    {
+                        fprintf(stderr, "The SDK could not parse the frame \"%s\"\n", frames[f].name.c_str());
+                        return 1;
+                    }
+                }
+                times[2 + subscribed] = std::min(times[2 + subscribed], (udp_get_time_ns() - start) / 1e3 / perRound);
+            }
+        }
+
+        printf("%-22s %6d %8d | %12.2f %12.2f %7.1fx | %10.2f %10.2f\n", frames[f].name.c_str(), (int)frames[f].packet.size(), numbers,
+               times[1], times[0], times[1] / times[0], times[2], times[3]);
+    }
+
+    return same ? 0 : 1;
+}
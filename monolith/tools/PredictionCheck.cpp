@@ -0,0 +1,148 @@
+// This tool checks that a Head or Wand predicts from the time of the pose it holds.  It moves
+// a body at a constant speed for a few frames and then sends samples that give no new pose:
+//   rejected     Samples dropped by the filter for their low quality
+//   quality 0    Samples the tracker sends while it still sees the body, but can't give its pose
+// Neither may change the receive time, so Predict must extrapolate from the last pose by the
+// whole time since it arrived and land where the body would be by then.
+//
+// Build it together with the framework sources with tools/Makefile, on Linux:
+//   make -C tools PredictionCheck
+// It is written to tools/build/PredictionCheck.  make -C tools check also runs it.
+//
+// Usage:
+//   PredictionCheck
+// Exits with 1 if any check found a problem.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Head.h"
+#include "Wand.h"
+
+using namespace MTF;
+
+// Speed of the body along x, in feet per second
+#define SPEED 1.0
+
+// Time between frames in nanoseconds
+#define FRAME_NS 10000000LL
+
+// Frames with a pose before the samples without one
+#define GOOD_FRAMES 10
+
+// Samples without a pose, one per frame
+#define BAD_FRAMES 3
+
+// Largest difference from the expected position, in feet
+#define TOLERANCE 1e-3
+
+
+// Returns the x position of the body in millimeters at a time
+static double GetLocationX(long long timeNs)
+{
+    return SPEED * timeNs * 1e-9 / 3.2808399 * 1000;
+}
+
+
+static void SetPose(double *loc, double *rot, long long timeNs)
+{
+    loc[0] = GetLocationX(timeNs);
+    loc[1] = 1600.0;
+    loc[2] = 0.0;
+
+    memset(rot, 0, 9 * sizeof(double));
+    rot[0] = rot[4] = rot[8] = 1.0;
+}
+
+
+// Returns a filter that drops samples with a quality below 0.5
+static PoseFilterChain GetFilter()
+{
+    PoseFilterChain filter;
+    filter.Add(new OutlierRejectionFilter(0.0, 0.0, 0.5, 1000));
+    return filter;
+}
+
+
+static bool CheckHead(const char *name, double badQuality)
+{
+    Head head;
+    head.SetFilter(GetFilter());
+
+    DTrack_Body_Type_d data;
+    data.id = 0;
+
+    long long timeNs = FRAME_NS;
+    for (int i = 0; i < GOOD_FRAMES; ++i, timeNs += FRAME_NS)
+    {
+        data.quality = 1.0;
+        SetPose(data.loc, data.rot, timeNs);
+        head.Update(data, timeNs);
+    }
+    long long poseTimeNs = timeNs - FRAME_NS;
+
+    for (int i = 0; i < BAD_FRAMES; ++i, timeNs += FRAME_NS)
+    {
+        data.quality = badQuality;
+        SetPose(data.loc, data.rot, timeNs);
+        head.Update(data, timeNs);
+    }
+
+    Real expected = (Real)(SPEED * timeNs * 1e-9);
+    Real predicted = head.Predict(timeNs).GetPosition().GetX();
+    bool ok = head.GetReceiveTimeNs() == poseTimeNs && std::fabs(predicted - expected) < TOLERANCE;
+
+    printf("head %-10s receive time %lld ms (pose %lld ms), predicted x %.4f (expected %.4f): %s\n",
+           name, head.GetReceiveTimeNs() / 1000000, poseTimeNs / 1000000, (double)predicted, (double)expected,
+           ok ? "ok" : "PROBLEM");
+    return ok;
+}
+
+
+static bool CheckWand(const char *name, double badQuality)
+{
+    Wand wand;
+    wand.SetFilter(GetFilter());
+
+    DTrack_FlyStick_Type_d data;
+    memset(&data, 0, sizeof(data));
+
+    long long timeNs = FRAME_NS;
+    for (int i = 0; i < GOOD_FRAMES; ++i, timeNs += FRAME_NS)
+    {
+        data.quality = 1.0;
+        SetPose(data.loc, data.rot, timeNs);
+        wand.Update(data, timeNs);
+    }
+    long long poseTimeNs = timeNs - FRAME_NS;
+
+    for (int i = 0; i < BAD_FRAMES; ++i, timeNs += FRAME_NS)
+    {
+        data.quality = badQuality;
+        SetPose(data.loc, data.rot, timeNs);
+        wand.Update(data, timeNs);
+    }
+
+    Real expected = (Real)(SPEED * timeNs * 1e-9);
+    Real predicted = wand.Predict(timeNs).GetPosition().GetX();
+    bool ok = wand.GetReceiveTimeNs() == poseTimeNs && std::fabs(predicted - expected) < TOLERANCE;
+
+    printf("wand %-10s receive time %lld ms (pose %lld ms), predicted x %.4f (expected %.4f): %s\n",
+           name, wand.GetReceiveTimeNs() / 1000000, poseTimeNs / 1000000, (double)predicted, (double)expected,
+           ok ? "ok" : "PROBLEM");
+    return ok;
+}
+
+
+// Entry point to our program
+int main(int argc, char **argv)
+{
+    bool ok = true;
+    ok = CheckHead("rejected", 0.1) && ok;
+    ok = CheckHead("quality 0", 0.0) && ok;
+    ok = CheckWand("rejected", 0.1) && ok;
+    ok = CheckWand("quality 0", 0.0) && ok;
+
+    return ok ? 0 : 1;
+}
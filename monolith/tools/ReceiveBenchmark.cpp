@@ -0,0 +1,570 @@
+// This tool measures how fast tracking data gets from the network to the application.
+// It sends DTrack2 ASCII packets to itself over the loopback interface and receives
+// them with DTrackSDK::receive and with Monolith's tracking thread (TrackerUpdate),
+// for a range of frame rates and packet contents.  For every configuration it prints:
+//   fps          Frames received (SDK) or published (TrackerUpdate) per second
+//   parse        Time to parse a packet (SDK), or from the arrival of a packet until
+//                its frame can be read (TrackerUpdate), 50th/99th percentile and maximum
+//   dropped      Frames sent but never seen, found from gaps in the fr counter.  The
+//                TrackerUpdate numbers also count frames the tracker skipped on purpose
+//                because a newer one was already waiting.
+//   latency      From sending a packet until its frame can be read, 50th/99th percentile
+//                and maximum
+// All times are in microseconds.
+//
+// Build it together with the framework sources with tools/Makefile, on Linux:
+//   make -C tools ReceiveBenchmark
+// It is written to tools/build/ReceiveBenchmark.
+//
+// Usage:
+//   ReceiveBenchmark [options]
+//     --port <port>          Loopback port to use (5100)
+//     --duration <s>         Seconds per configuration (2)
+//     --target <name>        sdk, tracker or both (both)
+//     --rates <list>         Frame rates to sweep, comma separated (60,240,1000,4000)
+//     --bodies <list>        Standard body counts to sweep (1,8,16)
+//     --flysticks <list>     FlyStick counts to sweep (1,4)
+//     --hands <list>         Hand counts to sweep (0,2)
+//     --markers <list>       Single marker counts to sweep (0,32)
+//     --grid                 Measure every combination of the lists instead of one list at a time
+//
+// Without --grid, each list is swept on its own while the others stay at their first
+// value, which keeps a run short.  The first value is also the one the others are combined with.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "DTrackNet.h"
+#include "DTrackSDK.hpp"
+#include "Monolith.h"
+
+using namespace MTF;
+
+// Largest packet the SDK accepts with its default buffer
+#define MAX_PACKET 20000
+
+
+// One combination of the swept settings
+struct Configuration
+{
+    double rate;
+    int bodies;
+    int flySticks;
+    int hands;
+    int markers;
+};
+
+
+// What the receiving side saw of one frame
+struct Arrival
+{
+    unsigned int frame;                 // fr counter the frame was sent with
+    long long availableNs;              // When the frame could be read
+    long long parseNs;                  // Time to parse, or from arrival to available
+};
+
+
+// Results of one configuration and target
+struct Result
+{
+    int frames;
+    double fps;
+    int dropped;
+    long long parse[3];                 // 50th, 99th percentile and maximum in ns
+    long long latency[3];
+};
+
+
+// Settings from the command line
+struct Settings
+{
+    int port;
+    double duration;
+    bool sdk;
+    bool tracker;
+    bool grid;
+    std::vector<double> rates;
+    std::vector<int> bodies;
+    std::vector<int> flySticks;
+    std::vector<int> hands;
+    std::vector<int> markers;
+};
+
+
+// Appends text to the packet, keeping track of the space left
+static void Append(char *packet, int &length, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(packet + length, MAX_PACKET - length, format, args);
+    va_end(args);
+
+    if (written > 0)
+        length += written;
+    if (length > MAX_PACKET - 1)
+        length = MAX_PACKET - 1;
+}
+
+
+// Writes one frame.  Body 0 is placed at x = frame in mm, so the frame number can be
+// read back from a TrackingFrame, where the DTrack frame counter is not kept.
+static int WritePacket(char *packet, const Configuration &config, unsigned int frame, long long timeNs)
+{
+    static const char *rotation = "[1.000000 0.000000 0.000000 0.000000 1.000000 0.000000 0.000000 0.000000 1.000000]";
+    int length = 0;
+
+    Append(packet, length, "fr %u\r\n", frame);
+    Append(packet, length, "ts %.6f\r\n", fmod(timeNs / 1e9, 86400.0));
+    Append(packet, length, "6dcal %d\r\n", config.bodies);
+
+    Append(packet, length, "6d %d", config.bodies);
+    for (int i = 0; i < config.bodies; ++i)
+        Append(packet, length, " [%d 1.000][%u.000 %.3f %.3f]%s", i, i == 0 ? frame : 100 * i, 1600.0 + i, 1000.0 - i, rotation);
+    Append(packet, length, "\r\n");
+
+    if (config.flySticks > 0)
+    {
+        Append(packet, length, "6df2 %d %d", config.flySticks, config.flySticks);
+        for (int i = 0; i < config.flySticks; ++i)
+            Append(packet, length, " [%d 1.000 6 2][%.3f 1200.000 800.000]%s[%u 0.25 -0.50]", i, 200.0 * i, rotation, (frame / 100) % 2);
+        Append(packet, length, "\r\n");
+    }
+
+    if (config.hands > 0)
+    {
+        Append(packet, length, "glcal %d\r\n", config.hands);
+        Append(packet, length, "gl %d", config.hands);
+        for (int i = 0; i < config.hands; ++i)
+        {
+            Append(packet, length, " [%d 1.000 %d 5][%.3f 1100.000 600.000]%s", i, i % 2, 300.0 * i, rotation);
+            for (int finger = 0; finger < 5; ++finger)
+                Append(packet, length, "[%.3f 1100.000 690.000]%s[8.500 35.000 30.000 25.000 30.000 20.000]", 300.0 * i - 40.0 + 20.0 * finger, rotation);
+        }
+        Append(packet, length, "\r\n");
+    }
+
+    if (config.markers > 0)
+    {
+        Append(packet, length, "3d %d", config.markers);
+        for (int i = 0; i < config.markers; ++i)
+            Append(packet, length, " [%d 1.000][%.3f 2000.000 %.3f]", i + 1, 50.0 * i, 1000.0 - 25.0 * i);
+        Append(packet, length, "\r\n");
+    }
+
+    return length;
+}
+
+
+// Sends the frames at the configured rate and remembers when each one was sent.
+// Runs on its own thread while the receiving side runs on the main thread.
+class Sender
+{
+
+public:
+    Sender(int port, Configuration config, double duration)
+    {
+        _port = port;
+        _config = config;
+        _frames = (int)(config.rate * duration);
+        _sendTimes.resize(_frames + 1, -1);
+        _done = false;
+    }
+
+    void Run()
+    {
+        _thread = boost::thread(boost::bind(&Sender::Send, this));
+    }
+
+    void Join()
+    {
+        _thread.join();
+    }
+
+    bool IsDone()
+    {
+        return _done;
+    }
+
+    int GetNumFrames()
+    {
+        return _frames;
+    }
+
+    // Only valid after Join
+    long long GetSendTime(unsigned int frame)
+    {
+        return frame < _sendTimes.size() ? _sendTimes[frame] : -1;
+    }
+
+private:
+    void Send()
+    {
+        void *sock;
+        unsigned short port = 0;
+        if (udp_init(&sock, &port) != 0)
+        {
+            fprintf(stderr, "Unable to open a socket to send from\n");
+            exit(-1);
+        }
+
+        unsigned int ip = ip_name2ip("127.0.0.1");
+        char packet[MAX_PACKET];
+        boost::system_time start = boost::get_system_time();
+
+        for (int frame = 1; frame <= _frames; ++frame)
+        {
+            boost::system_time due = start + boost::posix_time::microseconds((long long)((frame - 1) * 1e6 / _config.rate));
+            if (boost::get_system_time() < due)
+                boost::this_thread::sleep(due);
+
+            long long now = udp_get_time_ns();
+            int length = WritePacket(packet, _config, frame, now);
+
+            _sendTimes[frame] = udp_get_time_ns();
+            udp_send(sock, packet, length, ip, (unsigned short)_port, 1000000);
+        }
+
+        udp_exit(sock);
+        _done = true;
+    }
+
+    int _port;
+    Configuration _config;
+    int _frames;
+    std::vector<long long> _sendTimes;
+    boost::atomic<bool> _done;
+    boost::thread _thread;
+};
+
+
+// Remembers when the SDK fetched the last batch of packets from the socket
+static void OnPacket(void *context, const char *, int, long long)
+{
+    *static_cast<long long*>(context) = udp_get_time_ns();
+}
+
+
+// Receives every packet with DTrackSDK::receive, one frame per call
+static void ReceiveWithSdk(int port, Sender &sender, std::vector<Arrival> &arrivals)
+{
+    DTrackSDK sdk("", 0, (unsigned short)port, DTrackSDK::SYS_DTRACK_UNKNOWN, 20000, 100000);
+    if (!sdk.isUDPValid())
+    {
+        fprintf(stderr, "Unable to receive on port %d\n", port);
+        exit(-1);
+    }
+
+    long long fetchedNs = 0;
+    sdk.setReceiveMode(DTrackSDK::RECEIVE_ALL);
+    sdk.setPacketHandler(&OnPacket, &fetchedNs);
+
+    sender.Run();
+
+    // Stop once the sender is done and nothing came for the receive timeout
+    while (true)
+    {
+        bool pending = sdk.getNumPendingPackets() > 0;
+        long long startNs = udp_get_time_ns();
+        bool ok = sdk.receive();
+        long long endNs = udp_get_time_ns();
+
+        if (!ok)
+        {
+            if (sender.IsDone())
+                break;
+            continue;
+        }
+
+        // A call that had to read the socket only starts parsing once the packets are in
+        Arrival arrival;
+        arrival.frame = sdk.getFrameCounter();
+        arrival.availableNs = endNs;
+        arrival.parseNs = endNs - (pending ? startNs : fetchedNs);
+        arrivals.push_back(arrival);
+    }
+
+    sender.Join();
+}
+
+
+// Lets Monolith's tracking thread receive the packets and reads every frame it publishes.
+// No camera is needed, only the tracking is used.
+static void ReceiveWithTracker(int port, Sender &sender, std::vector<Arrival> &arrivals)
+{
+    Monolith tracker(NULL, port, PoseFilterChain(), PoseFilterChain());
+
+    // Give the tracking thread time to open its socket
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    sender.Run();
+
+    unsigned long last = 0;
+    TrackingFrame frame;
+    while (true)
+    {
+        if (!tracker.WaitForNextFrame(last, 100))
+        {
+            if (sender.IsDone())
+                break;
+            continue;
+        }
+
+        long long now = udp_get_time_ns();
+        tracker.GetFrame(frame);
+        last = frame.frameNumber;
+
+        if (frame.numBodies < 1 || !frame.bodies[0].tracked)
+            continue;
+
+        Arrival arrival;
+        arrival.frame = (unsigned int)floor(frame.bodies[0].position[0] * 1000 / 3.2808399 + 0.5);
+        arrival.availableNs = now;
+        arrival.parseNs = now - frame.receiveTimeNs;
+        arrivals.push_back(arrival);
+    }
+
+    sender.Join();
+    tracker.ShutdownTracking();
+}
+
+
+static void GetPercentiles(std::vector<long long> values, long long (&result)[3])
+{
+    result[0] = result[1] = result[2] = 0;
+    if (values.empty())
+        return;
+
+    std::sort(values.begin(), values.end());
+    result[0] = values[values.size() / 2];
+    result[1] = values[std::min(values.size() - 1, (size_t)(values.size() * 0.99))];
+    result[2] = values.back();
+}
+
+
+static Result Measure(int port, const Configuration &config, double duration, bool useTracker)
+{
+    Sender sender(port, config, duration);
+    std::vector<Arrival> arrivals;
+    arrivals.reserve(sender.GetNumFrames() + 1);
+
+    if (useTracker)
+        ReceiveWithTracker(port, sender, arrivals);
+    else
+        ReceiveWithSdk(port, sender, arrivals);
+
+    Result result;
+    std::vector<long long> parse;
+    std::vector<long long> latency;
+    std::vector<bool> seen(sender.GetNumFrames() + 1, false);
+
+    for (unsigned int i = 0; i < arrivals.size(); ++i)
+    {
+        unsigned int frame = arrivals[i].frame;
+        long long sent = sender.GetSendTime(frame);
+        if (sent < 0 || seen[frame])
+            continue;
+
+        seen[frame] = true;
+        parse.push_back(arrivals[i].parseNs);
+        latency.push_back(arrivals[i].availableNs - sent);
+    }
+
+    result.frames = parse.size();
+    result.dropped = sender.GetNumFrames() - result.frames;
+    result.fps = result.frames / duration;
+    GetPercentiles(parse, result.parse);
+    GetPercentiles(latency, result.latency);
+    return result;
+}
+
+
+static void PrintHeader()
+{
+    printf("%-8s %6s %6s %5s %5s %6s | %9s | %8s %8s %8s | %7s | %8s %8s %8s\n",
+           "target", "rate", "bodies", "fly", "hands", "marks", "fps",
+           "parse50", "parse99", "parseMax", "dropped", "lat50", "lat99", "latMax");
+}
+
+
+static void PrintResult(const char *target, const Configuration &config, const Result &result)
+{
+    printf("%-8s %6.0f %6d %5d %5d %6d | %9.1f | %8.1f %8.1f %8.1f | %7d | %8.1f %8.1f %8.1f\n",
+           target, config.rate, config.bodies, config.flySticks, config.hands, config.markers, result.fps,
+           result.parse[0] / 1e3, result.parse[1] / 1e3, result.parse[2] / 1e3, result.dropped,
+           result.latency[0] / 1e3, result.latency[1] / 1e3, result.latency[2] / 1e3);
+    fflush(stdout);
+}
+
+
+template <typename T>
+static bool ParseList(const char *text, std::vector<T> &list)
+{
+    list.clear();
+    const char *s = text;
+    while (*s)
+    {
+        char *end;
+        double value = strtod(s, &end);
+        if (end == s || value < 0)
+            return false;
+
+        list.push_back((T)value);
+        s = (*end == ',') ? end + 1 : end;
+        if (*end && *end != ',')
+            return false;
+    }
+    return !list.empty();
+}
+
+
+static bool ParseArguments(int argc, char **argv, Settings &settings)
+{
+    settings.port = 5100;
+    settings.duration = 2.0;
+    settings.sdk = true;
+    settings.tracker = true;
+    settings.grid = false;
+    ParseList("60,240,1000,4000", settings.rates);
+    ParseList("1,8,16", settings.bodies);
+    ParseList("1,4", settings.flySticks);
+    ParseList("0,2", settings.hands);
+    ParseList("0,32", settings.markers);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+
+        if (option == "--grid")
+        {
+            settings.grid = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return false;
+        const char *value = argv[++i];
+        bool ok = true;
+
+        if (option == "--port")            settings.port = atoi(value);
+        else if (option == "--duration")   settings.duration = atof(value);
+        else if (option == "--rates")      ok = ParseList(value, settings.rates);
+        else if (option == "--bodies")     ok = ParseList(value, settings.bodies);
+        else if (option == "--flysticks")  ok = ParseList(value, settings.flySticks);
+        else if (option == "--hands")      ok = ParseList(value, settings.hands);
+        else if (option == "--markers")    ok = ParseList(value, settings.markers);
+        else if (option == "--target")
+        {
+            settings.sdk = std::string(value) != "tracker";
+            settings.tracker = std::string(value) != "sdk";
+            ok = settings.sdk || settings.tracker;
+        }
+        else
+            return false;
+
+        if (!ok)
+            return false;
+    }
+
+    return settings.port > 0 && settings.duration > 0;
+}
+
+
+// Builds the configurations to measure, see the usage above
+static std::vector<Configuration> GetConfigurations(const Settings &settings)
+{
+    std::vector<Configuration> configs;
+    Configuration base = { settings.rates[0], settings.bodies[0], settings.flySticks[0], settings.hands[0], settings.markers[0] };
+
+    if (settings.grid)
+    {
+        for (unsigned int r = 0; r < settings.rates.size(); ++r)
+            for (unsigned int b = 0; b < settings.bodies.size(); ++b)
+                for (unsigned int f = 0; f < settings.flySticks.size(); ++f)
+                    for (unsigned int h = 0; h < settings.hands.size(); ++h)
+                        for (unsigned int m = 0; m < settings.markers.size(); ++m)
+                        {
+                            Configuration config = { settings.rates[r], settings.bodies[b], settings.flySticks[f], settings.hands[h], settings.markers[m] };
+                            configs.push_back(config);
+                        }
+        return configs;
+    }
+
+    configs.push_back(base);
+    for (unsigned int i = 1; i < settings.rates.size(); ++i)
+    {
+        Configuration config = base;
+        config.rate = settings.rates[i];
+        configs.push_back(config);
+    }
+    for (unsigned int i = 1; i < settings.bodies.size(); ++i)
+    {
+        Configuration config = base;
+        config.bodies = settings.bodies[i];
+        configs.push_back(config);
+    }
+    for (unsigned int i = 1; i < settings.flySticks.size(); ++i)
+    {
+        Configuration config = base;
+        config.flySticks = settings.flySticks[i];
+        configs.push_back(config);
+    }
+    for (unsigned int i = 1; i < settings.hands.size(); ++i)
+    {
+        Configuration config = base;
+        config.hands = settings.hands[i];
+        configs.push_back(config);
+    }
+    for (unsigned int i = 1; i < settings.markers.size(); ++i)
+    {
+        Configuration config = base;
+        config.markers = settings.markers[i];
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+
+// Entry point to our program
+int main(int argc, char **argv)
+{
+    Settings settings;
+    if (!ParseArguments(argc, argv, settings))
+    {
+        printf("Usage: ReceiveBenchmark [--port n] [--duration s] [--target sdk|tracker|both] [--rates list]\n"
+               "                        [--bodies list] [--flysticks list] [--hands list] [--markers list] [--grid]\n");
+        return 1;
+    }
+
+    std::vector<Configuration> configs = GetConfigurations(settings);
+
+    // Body 0 carries the frame number, so there is always at least one
+    for (unsigned int i = 0; i < configs.size(); ++i)
+        configs[i].bodies = std::max(configs[i].bodies, 1);
+
+    PrintHeader();
+    for (unsigned int i = 0; i < configs.size(); ++i)
+    {
+        char packet[MAX_PACKET];
+        if (WritePacket(packet, configs[i], 1, 0) >= MAX_PACKET - 1)
+        {
+            fprintf(stderr, "Packets with %d bodies, %d FlySticks, %d hands and %d markers don't fit into %d bytes, skipped\n",
+                    configs[i].bodies, configs[i].flySticks, configs[i].hands, configs[i].markers, MAX_PACKET);
+            continue;
+        }
+
+        if (settings.sdk)
+            PrintResult("sdk", configs[i], Measure(settings.port, configs[i], settings.duration, false));
+        if (settings.tracker)
+            PrintResult("tracker", configs[i], Measure(settings.port, configs[i], settings.duration, true));
+    }
+
+    return 0;
+}